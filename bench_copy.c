@@ -0,0 +1,201 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	tru_copy() calibration and check.  Only compiled when COPY_BENCH is
+	defined, and only on the target because it needs the DMA controller.
+
+	Initialises the DMA controller and tru_copy(), then runs
+	tru_copy_calibrate() on a work buffer in on-chip RAM (OCRAM) and on one
+	in SDRAM and prints the thresholds each gives.  tru_copy_table[] has no
+	memory region dimension, so the SDRAM results are the ones left in place.
+
+	The copies are then checked against the memmove() result, including
+	overlapping ones in both directions, once with the calibrated table and
+	once with low thresholds so alt_mem_copy() and the DMA are used from
+	small sizes.  The bytes either side of the destination are checked too.
+
+	The work buffers are the same as in bench_mem.c: the upper 32 KB of
+	OCRAM, and a fixed address in SDRAM well above the program.
+*/
+
+#ifdef COPY_BENCH
+
+#include "bench_copy.h"
+#include "tru_copy.h"
+#include "alt_cache.h"
+#include "alt_dma.h"
+#include "alt_mem.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef BENCH_COPY_OCRAM_ADDR
+	#define BENCH_COPY_OCRAM_ADDR 0xffff8000UL
+#endif
+#define BENCH_COPY_OCRAM_SIZE 0x8000
+#ifndef BENCH_COPY_SDRAM_ADDR
+	#define BENCH_COPY_SDRAM_ADDR 0x02000000UL
+#endif
+#ifndef BENCH_COPY_SDRAM_SIZE
+	#define BENCH_COPY_SDRAM_SIZE 0x100000
+#endif
+
+#define BENCH_COPY_GUARD 64  // Bytes checked either side of the destination
+
+typedef struct{
+	const char *name;
+	uint8_t *base;
+	size_t size;
+}bench_copy_region_t;
+
+static const bench_copy_region_t bench_copy_region[] = {
+	{ "OCRAM", (uint8_t *)BENCH_COPY_OCRAM_ADDR, BENCH_COPY_OCRAM_SIZE },
+	{ "SDRAM", (uint8_t *)BENCH_COPY_SDRAM_ADDR, BENCH_COPY_SDRAM_SIZE }
+};
+
+#define BENCH_COPY_REGION_NUM (sizeof(bench_copy_region) / sizeof(bench_copy_region[0]))
+
+static const char *bench_copy_place_name[TRU_COPY_PLACE_NUM] = { "aligned", "misaligned" };
+
+typedef struct{
+	size_t dst_off;
+	size_t src_off;
+}bench_copy_case_t;
+
+// Offsets from the start of the checked area.  Equal offsets are aligned to each other, a distance under the size overlaps
+static const bench_copy_case_t bench_copy_case[] = {
+	{ 0, 300000 },  // Apart, aligned
+	{ 300003, 1 },  // Apart, misaligned
+	{ 8, 0 },       // Overlapping, small distance, memmove()
+	{ 0, 4096 },    // Overlapping, destination first
+	{ 4096, 0 },    // Overlapping, destination last
+	{ 5001, 0 },    // Overlapping, misaligned
+	{ 0, 65536 }
+};
+
+static const size_t bench_copy_size[] = { 1, 16, 17, 100, 1000, 4096, 20000, 70000, 262144 };
+
+#define BENCH_COPY_CASE_NUM (sizeof(bench_copy_case) / sizeof(bench_copy_case[0]))
+#define BENCH_COPY_SIZE_NUM (sizeof(bench_copy_size) / sizeof(bench_copy_size[0]))
+
+static uint8_t bench_copy_pattern(size_t i){
+	return (uint8_t)(i * 7 + (i >> 8) + 1);
+}
+
+static void bench_copy_print_size(size_t n){
+	if(n == SIZE_MAX){
+		printf(" %10s", "never");
+	}else{
+		printf(" %10lu", (unsigned long)n);
+	}
+}
+
+static void bench_copy_print_table(const char *name){
+	int p;
+
+	for(p = 0; p < TRU_COPY_PLACE_NUM; p++){
+		printf("%-6s %-10s", name, bench_copy_place_name[p]);
+		bench_copy_print_size(tru_copy_table[p].neon_min);
+		bench_copy_print_size(tru_copy_table[p].dma_min);
+		printf("\n");
+	}
+}
+
+/*
+	One tru_copy() in an area filled with the pattern, then compare with what
+	memmove() gives: the source pattern in the destination, and the pattern
+	unchanged everywhere else in the area.  Returns 1 on a difference.
+*/
+static uint32_t bench_copy_check_one(uint8_t *area, size_t dst_off, size_t src_off, size_t n){
+	size_t end = ((dst_off > src_off) ? dst_off : src_off) + n + BENCH_COPY_GUARD;
+	uint8_t *dst = area + BENCH_COPY_GUARD + dst_off;
+	size_t i;
+
+	for(i = 0; i < end; i++) area[i] = bench_copy_pattern(i);
+	tru_copy(dst, area + BENCH_COPY_GUARD + src_off, n);
+	for(i = 0; i < end; i++){
+		size_t j = i - BENCH_COPY_GUARD - dst_off;  // Index into the destination, wraps when before it
+		uint8_t expect = (j < n) ? bench_copy_pattern(BENCH_COPY_GUARD + src_off + j) : bench_copy_pattern(i);
+
+		if(area[i] != expect) return 1;
+	}
+	return 0;
+}
+
+// Every case and size that fits in the region, returns the count of failed copies
+static uint32_t bench_copy_check(const bench_copy_region_t *region){
+	uint32_t errors = 0;
+	uint32_t c;
+	uint32_t s;
+
+	for(c = 0; c < BENCH_COPY_CASE_NUM; c++){
+		for(s = 0; s < BENCH_COPY_SIZE_NUM; s++){
+			size_t dst_off = bench_copy_case[c].dst_off;
+			size_t src_off = bench_copy_case[c].src_off;
+			size_t n = bench_copy_size[s];
+
+			if(((dst_off > src_off) ? dst_off : src_off) + n + 2 * BENCH_COPY_GUARD > region->size) continue;
+			errors += bench_copy_check_one(region->base, dst_off, src_off, n);
+		}
+	}
+	return errors;
+}
+
+void bench_copy_run(void){
+	static const ALT_DMA_CFG_t dma_cfg;  // Reset defaults
+	tru_copy_thresh_t calibrated[TRU_COPY_PLACE_NUM];
+	uint32_t errors = 0;
+	uint32_t r;
+	int p;
+
+	printf("\ntru_copy calibration, from size in bytes\n");
+	if(alt_dma_init(&dma_cfg) != ALT_E_SUCCESS || tru_copy_init() != 0){
+		printf("No DMA channel, the CPU engines only\n");
+	}
+	printf("%-6s %-10s %10s %10s\n", "region", "placement", "alt_mem", "DMA");
+	for(r = 0; r < BENCH_COPY_REGION_NUM; r++){
+		tru_copy_calibrate(bench_copy_region[r].base, bench_copy_region[r].size);
+		bench_copy_print_table(bench_copy_region[r].name);
+	}
+	memcpy(calibrated, tru_copy_table, sizeof(calibrated));
+
+	for(r = 0; r < BENCH_COPY_REGION_NUM; r++){
+		errors += bench_copy_check(&bench_copy_region[r]);
+	}
+
+	// Again with every engine used from small sizes
+	for(p = 0; p < TRU_COPY_PLACE_NUM; p++){
+		tru_copy_table[p].neon_min = (p == TRU_COPY_PLACE_ALIGNED) ? ALT_MEM_NEON_MIN : SIZE_MAX;
+		tru_copy_table[p].dma_min = 4 * ALT_CACHE_LINE_SIZE;
+	}
+	for(r = 0; r < BENCH_COPY_REGION_NUM; r++){
+		errors += bench_copy_check(&bench_copy_region[r]);
+	}
+	memcpy(tru_copy_table, calibrated, sizeof(calibrated));
+
+	printf("errors: %lu\n", (unsigned long)errors);
+}
+
+#endif
@@ -0,0 +1,244 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Memory primitive benchmark.  Only compiled when MEM_BENCH is defined.
+
+	Times the newlib memcpy(), memset() and memcmp() against alt_mem_copy(),
+	alt_mem_set() and alt_mem_cmp() (hwlib/include/alt_mem.h) over several
+	sizes, for buffers in on-chip RAM (OCRAM) and in SDRAM, and with the
+	destination and source:
+	- both aligned
+	- both misaligned by the same amount, the alignment head is needed
+	- misaligned to each other, the alt_mem functions use newlib
+	The results are in MB/s, the fastest of BENCH_REPEAT runs, and each
+	result is checked against newlib.
+
+	The OCRAM buffers are in the upper 32 KB of OCRAM, which is free when the
+	program is linked for DDR and above the stack when it is linked for
+	OCRAM.  The SDRAM buffers are at a fixed address well above the program.
+	Whether the data cache is on makes a large difference, so compare like
+	with like.  In the host build (HOST_SIM) both regions are static buffers
+	and the host clock is used.
+*/
+
+#ifdef MEM_BENCH
+
+#include "bench_mem.h"
+#include "alt_mem.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef HOST_SIM
+	#include <time.h>
+#else
+	#include "alt_globaltmr.h"
+	#include "alt_timers.h"
+#endif
+
+#define BENCH_SIZE_MAX 8192  // Largest size, each region holds two buffers of this plus room for the misalignment
+#define BENCH_BUF_SIZE (BENCH_SIZE_MAX + 64)
+#define BENCH_BYTES    65536 // Bytes moved per measurement, the call count is this divided by the size
+#define BENCH_REPEAT   3
+
+#ifndef BENCH_MEM_OCRAM_ADDR
+	#define BENCH_MEM_OCRAM_ADDR 0xffff8000UL
+#endif
+#ifndef BENCH_MEM_SDRAM_ADDR
+	#define BENCH_MEM_SDRAM_ADDR 0x02000000UL
+#endif
+
+typedef enum{
+	BENCH_FUNC_COPY,
+	BENCH_FUNC_SET,
+	BENCH_FUNC_CMP,
+	BENCH_FUNC_NUM
+}bench_func_t;
+
+static const char *bench_func_name[BENCH_FUNC_NUM] = { "copy", "set", "cmp" };
+
+typedef struct{
+	const char *name;
+	uint8_t *base;  // Two buffers of BENCH_BUF_SIZE
+}bench_region_t;
+
+typedef struct{
+	const char *name;
+	uint32_t dst_off;
+	uint32_t src_off;
+}bench_align_t;
+
+static const bench_align_t bench_align[] = {
+	{ "0/0", 0, 0 },
+	{ "3/3", 3, 3 },
+	{ "0/5", 0, 5 }
+};
+
+static const uint32_t bench_size[] = { 64, 256, 1024, 8192 };
+
+#define BENCH_ALIGN_NUM (sizeof(bench_align) / sizeof(bench_align[0]))
+#define BENCH_SIZE_NUM  (sizeof(bench_size) / sizeof(bench_size[0]))
+
+#ifdef HOST_SIM
+	static uint8_t bench_ocram[2 * BENCH_BUF_SIZE] __attribute__((aligned(64)));
+	static uint8_t bench_sdram[2 * BENCH_BUF_SIZE] __attribute__((aligned(64)));
+
+	static bench_region_t bench_region[] = {
+		{ "OCRAM", bench_ocram },
+		{ "SDRAM", bench_sdram }
+	};
+
+	static uint64_t bench_ticks(void){
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+	static uint32_t bench_ticks_freq(void){
+		return 1000000000;
+	}
+#else
+	static bench_region_t bench_region[] = {
+		{ "OCRAM", (uint8_t *)BENCH_MEM_OCRAM_ADDR },
+		{ "SDRAM", (uint8_t *)BENCH_MEM_SDRAM_ADDR }
+	};
+
+	static uint64_t bench_ticks(void){
+		return alt_globaltmr_get64();
+	}
+
+	static uint32_t bench_ticks_freq(void){
+		return alt_gpt_freq_get(ALT_GPT_CPU_GLOBAL_TMR);
+	}
+#endif
+
+#define BENCH_REGION_NUM (sizeof(bench_region) / sizeof(bench_region[0]))
+
+static volatile int bench_sink;  // Keeps the memcmp() results from being optimised out
+
+static void bench_call(bench_func_t func, int use_alt, uint8_t *dst, const uint8_t *src, uint32_t size){
+	switch(func){
+		case BENCH_FUNC_COPY:
+			if(use_alt) alt_mem_copy(dst, src, size); else memcpy(dst, src, size);
+			break;
+		case BENCH_FUNC_SET:
+			if(use_alt) alt_mem_set(dst, 0x5a, size); else memset(dst, 0x5a, size);
+			break;
+		default:
+			bench_sink += use_alt ? alt_mem_cmp(dst, src, size) : memcmp(dst, src, size);
+			break;
+	}
+}
+
+// Best time in ticks for BENCH_BYTES bytes
+static uint64_t bench_run_one(bench_func_t func, int use_alt, uint8_t *dst, const uint8_t *src, uint32_t size){
+	uint64_t best = UINT64_MAX;
+	uint64_t ticks;
+	uint32_t calls = BENCH_BYTES / size;
+	uint32_t rep;
+	uint32_t i;
+
+	for(rep = 0; rep < BENCH_REPEAT; rep++){
+		ticks = bench_ticks();
+		for(i = 0; i < calls; i++){
+			bench_call(func, use_alt, dst, src, size);
+		}
+		ticks = bench_ticks() - ticks;
+		if(ticks < best) best = ticks;
+	}
+	return best;
+}
+
+// Same result as newlib, including the bytes either side of the destination
+static uint32_t bench_check(bench_func_t func, uint8_t *dst, uint8_t *src, uint32_t size){
+	static uint8_t ref[BENCH_BUF_SIZE];
+	uint32_t i;
+
+	for(i = 0; i < size; i++){
+		src[i] = (uint8_t)(i * 7 + 1);
+	}
+	if(func == BENCH_FUNC_CMP){
+		memcpy(dst, src, size);
+		if(size) dst[size - 1] ^= 1;  // Differ in the last byte, which is in the tail
+		return ((alt_mem_cmp(dst, src, size) < 0) != (memcmp(dst, src, size) < 0)) || alt_mem_cmp(src, src, size) != 0;
+	}
+
+	memset(dst - 1, 0xa5, size + 2);
+	bench_call(func, 0, dst, src, size);
+	memcpy(ref, dst - 1, size + 2);
+	memset(dst - 1, 0xa5, size + 2);
+	bench_call(func, 1, dst, src, size);
+	return memcmp(ref, dst - 1, size + 2) != 0;
+}
+
+void bench_mem_run(void){
+	uint32_t tmr_freq;
+	uint32_t errors = 0;
+	uint32_t r;
+	uint32_t f;
+	uint32_t a;
+	uint32_t s;
+
+	#ifndef HOST_SIM
+		alt_globaltmr_init();
+		alt_globaltmr_start();
+	#endif
+	tmr_freq = bench_ticks_freq();
+
+	printf("\nMemory primitive benchmark, %u bytes per run, MB/s\n", BENCH_BYTES);
+	printf("%-6s %-5s %-5s %6s %9s %9s\n", "region", "func", "align", "size", "newlib", "alt_mem");
+	for(r = 0; r < BENCH_REGION_NUM; r++){
+		// Room before the destination for the check of the byte before it, keeping the 8 byte alignment
+		uint8_t *dst = bench_region[r].base + 8;
+		uint8_t *src = bench_region[r].base + BENCH_BUF_SIZE;
+
+		for(f = 0; f < BENCH_FUNC_NUM; f++){
+			for(a = 0; a < BENCH_ALIGN_NUM; a++){
+				for(s = 0; s < BENCH_SIZE_NUM; s++){
+					uint8_t *d = dst + bench_align[a].dst_off;
+					uint8_t *p = src + bench_align[a].src_off;
+					uint64_t t_lib;
+					uint64_t t_alt;
+
+					errors += bench_check(f, d, p, bench_size[s]);
+					if(f == BENCH_FUNC_CMP) memcpy(d, p, bench_size[s]);  // Equal buffers, so the whole size is compared
+					t_lib = bench_run_one(f, 0, d, p, bench_size[s]);
+					t_alt = bench_run_one(f, 1, d, p, bench_size[s]);
+
+					printf("%-6s %-5s %-5s %6lu %9lu %9lu\n",
+						bench_region[r].name,
+						bench_func_name[f],
+						bench_align[a].name,
+						(unsigned long)bench_size[s],
+						(unsigned long)((uint64_t)BENCH_BYTES * tmr_freq / (t_lib ? t_lib : 1) / 1000000),
+						(unsigned long)((uint64_t)BENCH_BYTES * tmr_freq / (t_alt ? t_alt : 1) / 1000000));
+				}
+			}
+		}
+	}
+	printf("errors: %lu\n", (unsigned long)errors);
+}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Integer formatting benchmark.  Only compiled when PRINTF_BENCH is defined.
+
+	Converts the same pseudo random values with each of the alt_printf.c
+	conversion engines (alt_printf_num.h) the way the %d, %u, %llu and %x
+	conversions call them, and reports the average time per conversion.  The
+	values have a uniform spread of digit counts, so short and long numbers
+	are weighted alike.  The output of each engine is checked against the
+	fast one.
+
+	On the target the time is from the Cortex-A9 global timer and is also
+	shown in CPU cycles.  In the host build (HOST_SIM) the simulated global
+	timer only counts register accesses, so the host clock is used instead.
+	The host has a hardware divider, so only the target results show the cost
+	of the libgcc division calls.
+*/
+
+#ifdef PRINTF_BENCH
+
+#include "bench_printf.h"
+#include "alt_printf.h"
+#include "alt_printf_num.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+// alt_printf.h is included for the alt_snprintf() prototype only.  The results go out through newlib
+#undef printf
+#undef snprintf
+#undef sprintf
+#undef vprintf
+
+#ifdef HOST_SIM
+	#include <time.h>
+#else
+	#include "alt_clock_manager.h"
+	#include "alt_globaltmr.h"
+	#include "alt_timers.h"
+#endif
+
+#define BENCH_VAL_NUM 256  // Values per conversion
+#define BENCH_PASSES  16   // Passes over the values per measurement
+#define BENCH_REPEAT  5    // Measurements per result, the fastest is kept to filter out interruptions
+
+typedef int (*bench_utoa_t)(uint64_t val, char *stg);
+typedef int (*bench_xtoa_t)(uint64_t val, char *stg, int digits, int upper);
+
+typedef struct{
+	const char *name;
+	bench_utoa_t utoa;
+	bench_xtoa_t xtoa;
+}bench_engine_t;
+
+typedef enum{
+	BENCH_SPEC_D,
+	BENCH_SPEC_U,
+	BENCH_SPEC_LLU,
+	BENCH_SPEC_X,
+	BENCH_SPEC_NUM
+}bench_spec_t;
+
+static const char *bench_spec_name[BENCH_SPEC_NUM] = { "%d", "%u", "%llu", "%x" };
+
+static const bench_engine_t bench_engine[] = {
+	{ "divide",    alt_printf_utoa_div,  alt_printf_xtoa_loop },
+	{ "no divide", alt_printf_utoa_bcd,  alt_printf_xtoa_loop },
+	{ "fast",      alt_printf_utoa_fast, alt_printf_xtoa_fast }
+};
+
+#define BENCH_ENGINE_NUM (sizeof(bench_engine) / sizeof(bench_engine[0]))
+#define BENCH_ENGINE_REF (BENCH_ENGINE_NUM - 1)
+
+typedef struct{
+	uint64_t ticks;
+	uint32_t sum;       // Checksum of the output
+}bench_result_t;
+
+static uint64_t bench_val[BENCH_SPEC_NUM][BENCH_VAL_NUM];
+
+#ifdef HOST_SIM
+	static uint64_t bench_ticks(void){
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+	static uint32_t bench_ticks_freq(void){
+		return 1000000000;
+	}
+#else
+	static uint64_t bench_ticks(void){
+		return alt_globaltmr_get64();
+	}
+
+	static uint32_t bench_ticks_freq(void){
+		return alt_gpt_freq_get(ALT_GPT_CPU_GLOBAL_TMR);
+	}
+#endif
+
+// xorshift64, a fixed sequence so every run converts the same values
+static uint64_t bench_rand(void){
+	static uint64_t x = 88172645463325252ULL;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	return x;
+}
+
+// Random value with a random bit length up to bits, so the digit counts are spread out
+static uint64_t bench_rand_bits(uint32_t bits){
+	return bench_rand() >> (64 - 1 - (bench_rand() % bits));
+}
+
+static void bench_values_init(void){
+	uint32_t i;
+
+	for(i = 0; i < BENCH_VAL_NUM; i++){
+		bench_val[BENCH_SPEC_D][i] = (i & 1) ? (uint64_t)-(int64_t)bench_rand_bits(31) : bench_rand_bits(31);
+		bench_val[BENCH_SPEC_U][i] = bench_rand_bits(32);
+		bench_val[BENCH_SPEC_LLU][i] = bench_rand_bits(64);
+		bench_val[BENCH_SPEC_X][i] = bench_rand_bits(32);
+	}
+}
+
+// One conversion as alt_printf.c int_to_asc() and hex_to_asc() do it
+static int bench_convert(const bench_engine_t *engine, bench_spec_t spec, uint64_t val, char *stg){
+	switch(spec){
+		case BENCH_SPEC_D:
+			if((int32_t)val < 0){
+				*stg = '-';
+				return 1 + engine->utoa((uint64_t)-(int64_t)(int32_t)val, stg + 1);
+			}
+			return engine->utoa((uint32_t)val, stg);
+		case BENCH_SPEC_X:
+			return engine->xtoa(val, stg, 8, 0);
+		default:
+			return engine->utoa(val, stg);
+	}
+}
+
+static void bench_run_one(const bench_engine_t *engine, bench_spec_t spec, bench_result_t *result){
+	char stg[ALT_PRINTF_UTOA_MAX + 1];
+	uint64_t ticks;
+	uint32_t sum = 0;
+	uint32_t rep;
+	uint32_t pass;
+	uint32_t i;
+	int n;
+
+	result->ticks = UINT64_MAX;
+	for(rep = 0; rep < BENCH_REPEAT; rep++){
+		ticks = bench_ticks();
+		for(pass = 0; pass < BENCH_PASSES; pass++){
+			for(i = 0; i < BENCH_VAL_NUM; i++){
+				n = bench_convert(engine, spec, bench_val[spec][i], stg);
+				sum += n + stg[0] + stg[n - 1];  // Keeps the conversion from being optimised out
+			}
+		}
+		ticks = bench_ticks() - ticks;
+		if(ticks < result->ticks) result->ticks = ticks;
+	}
+	result->sum = sum;
+}
+
+// Compare every output with the reference engine, returns the count of differences
+static uint32_t bench_check(const bench_engine_t *engine, bench_spec_t spec){
+	char stg[ALT_PRINTF_UTOA_MAX + 1];
+	char ref[ALT_PRINTF_UTOA_MAX + 1];
+	uint32_t errors = 0;
+	uint32_t i;
+	int n;
+
+	for(i = 0; i < BENCH_VAL_NUM; i++){
+		n = bench_convert(engine, spec, bench_val[spec][i], stg);
+		if(n != bench_convert(&bench_engine[BENCH_ENGINE_REF], spec, bench_val[spec][i], ref) || memcmp(stg, ref, n) != 0) errors++;
+	}
+	return errors;
+}
+
+// Check the alt_snprintf() bounds: returns the full length and never writes past n, with n == 0 and to NULL allowed
+static uint32_t bench_snprintf_check(void){
+	char buf[8];
+	uint32_t errors = 0;
+
+	if(alt_snprintf(NULL, 0, "%d", 12345) != 5) errors++;
+	memset(buf, 'x', sizeof(buf));
+	if(alt_snprintf(buf, 0, "%d", 12345) != 5 || buf[0] != 'x') errors++;
+	if(alt_snprintf(buf, 4, "%d", 12345) != 5 || memcmp(buf, "123\0x", 5) != 0) errors++;
+	if(alt_snprintf(buf, 1, "%s", "abc") != 3 || buf[0] != '\0' || buf[1] != '2') errors++;
+	if(alt_snprintf(buf, sizeof(buf), "%d%s", 42, "ab") != 4 || strcmp(buf, "42ab") != 0) errors++;
+	return errors;
+}
+
+void bench_printf_run(void){
+	static bench_result_t result[BENCH_SPEC_NUM][BENCH_ENGINE_NUM];
+	uint32_t errors[BENCH_SPEC_NUM][BENCH_ENGINE_NUM];
+	uint32_t tmr_freq;
+	uint64_t conv = (uint64_t)BENCH_PASSES * BENCH_VAL_NUM;
+	uint32_t s;
+	uint32_t e;
+	#ifndef HOST_SIM
+		alt_freq_t cpu_freq = 0;
+
+		alt_globaltmr_init();
+		alt_globaltmr_start();
+		alt_clk_freq_get(ALT_CLK_MPU, &cpu_freq);
+	#endif
+
+	tmr_freq = bench_ticks_freq();
+	bench_values_init();
+
+	for(s = 0; s < BENCH_SPEC_NUM; s++){
+		for(e = 0; e < BENCH_ENGINE_NUM; e++){
+			errors[s][e] = bench_check(&bench_engine[e], s);
+			bench_run_one(&bench_engine[e], s, &result[s][e]);
+		}
+	}
+
+	printf("\nalt_snprintf checks: %lu errors\n", (unsigned long)bench_snprintf_check());
+	printf("\nInteger formatting benchmark, %u conversions per run\n", (unsigned)conv);
+	printf("%-5s %-10s %9s %9s %7s\n", "conv", "engine", "ns/conv", "cyc/conv", "errors");
+	for(s = 0; s < BENCH_SPEC_NUM; s++){
+		for(e = 0; e < BENCH_ENGINE_NUM; e++){
+			uint64_t ns_x10 = result[s][e].ticks * 10000000000ULL / tmr_freq / conv;
+
+			printf("%-5s %-10s %7lu.%lu ", bench_spec_name[s], bench_engine[e].name, (unsigned long)(ns_x10 / 10), (unsigned long)(ns_x10 % 10));
+			#ifdef HOST_SIM
+				printf("%9s", "-");
+			#else
+				printf("%9lu", (unsigned long)(result[s][e].ticks * (cpu_freq / tmr_freq) / conv));
+			#endif
+			printf(" %7lu\n", (unsigned long)errors[s][e]);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Semihosting output benchmark.  Only compiled when SEMIHOST_BENCH is
+	defined, together with SEMIHOSTING.
+
+	Prints the same lines through each semihosting output path and reports
+	the time per line and the count of SYS_WRITE traps:
+	- printf() on the newlib rdimon stdout, one trap per line
+	- printf() on stdout attached to the batched sink (tru_semihost.h)
+	- tru_semihost_write() straight into the sink
+
+	Time is from the host, SYS_ELAPSED and SYS_TICKFREQ, or SYS_CLOCK in
+	centiseconds when the debugger does not support those.  The source is
+	chosen once at the start, so the ticks and the rate always match.
+
+	The benchmark leaves stdout attached to the sink.
+*/
+
+#if defined(SEMIHOST_BENCH) && defined(SEMIHOSTING)
+
+#include "bench_semihost.h"
+#include "tru_semihost.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#define BENCH_SH_LINE_NUM 200  // Lines per path
+
+typedef enum{
+	BENCH_SH_RDIMON,
+	BENCH_SH_BATCHED,
+	BENCH_SH_SINK,
+	BENCH_SH_PATH_NUM
+}bench_sh_path_t;
+
+static const char *bench_sh_name[BENCH_SH_PATH_NUM] = { "printf, rdimon", "printf, batched", "tru_semihost_write" };
+
+typedef struct{
+	uint64_t ticks;
+	uint32_t traps;  // UINT32_MAX = not known
+}bench_sh_result_t;
+
+static int32_t bench_sh_freq;     // Host tick frequency
+static uint8_t bench_sh_elapsed;  // 1 = SYS_ELAPSED at bench_sh_freq, 0 = SYS_CLOCK at 100 Hz
+
+static uint64_t bench_sh_ticks(void){
+	uintptr_t elapsed[2];
+
+	if(bench_sh_elapsed){
+		if(tru_semihost_call(TRU_SEMIHOST_SYS_ELAPSED, elapsed) != 0) return 0;
+		return ((uint64_t)(uint32_t)elapsed[1] << 32) | (uint32_t)elapsed[0];
+	}
+	return (uint32_t)tru_semihost_call(TRU_SEMIHOST_SYS_CLOCK, NULL);
+}
+
+static void bench_sh_run_path(bench_sh_path_t path, bench_sh_result_t *result){
+	char line[80];
+	uint32_t traps = tru_semihost_trap_count();
+	uint64_t ticks = bench_sh_ticks();
+	uint32_t i;
+	int n;
+
+	for(i = 0; i < BENCH_SH_LINE_NUM; i++){
+		if(path == BENCH_SH_SINK){
+			n = snprintf(line, sizeof(line), "%-18s line %3u: the quick brown fox jumps over\n", bench_sh_name[path], (unsigned)i);
+			tru_semihost_write(line, n);
+		}else{
+			printf("%-18s line %3u: the quick brown fox jumps over\n", bench_sh_name[path], (unsigned)i);
+		}
+	}
+	fflush(stdout);
+	if(path != BENCH_SH_RDIMON) tru_semihost_flush();
+
+	result->ticks = bench_sh_ticks() - ticks;
+	result->traps = (path == BENCH_SH_RDIMON) ? UINT32_MAX : tru_semihost_trap_count() - traps;
+}
+
+void bench_semihost_run(void){
+	bench_sh_result_t result[BENCH_SH_PATH_NUM];
+	uintptr_t elapsed[2];
+	uint64_t us_x10;
+	uint32_t p;
+
+	// SYS_ELAPSED only with a usable rate, otherwise both fall back to SYS_CLOCK
+	bench_sh_freq = tru_semihost_call(TRU_SEMIHOST_SYS_TICKFREQ, NULL);
+	bench_sh_elapsed = (bench_sh_freq > 0 && tru_semihost_call(TRU_SEMIHOST_SYS_ELAPSED, elapsed) == 0);
+	if(!bench_sh_elapsed) bench_sh_freq = 100;
+
+	bench_sh_run_path(BENCH_SH_RDIMON, &result[BENCH_SH_RDIMON]);  // Before stdout is attached to the sink
+	if(tru_semihost_stdout_attach() == NULL){
+		printf("Semihosting benchmark: cannot attach stdout to the sink\n");
+		return;
+	}
+	bench_sh_run_path(BENCH_SH_BATCHED, &result[BENCH_SH_BATCHED]);
+	bench_sh_run_path(BENCH_SH_SINK, &result[BENCH_SH_SINK]);
+
+	printf("\nSemihosting output benchmark, %u lines per path, %s time\n", BENCH_SH_LINE_NUM, bench_sh_elapsed ? "SYS_ELAPSED" : "SYS_CLOCK");
+	printf("%-20s %10s %7s\n", "path", "us/line", "traps");
+	for(p = 0; p < BENCH_SH_PATH_NUM; p++){
+		us_x10 = result[p].ticks * 10000000 / (uint32_t)bench_sh_freq / BENCH_SH_LINE_NUM;
+		printf("%-20s %8lu.%lu ", bench_sh_name[p], (unsigned long)(us_x10 / 10), (unsigned long)(us_x10 % 10));
+		if(result[p].traps == UINT32_MAX){
+			printf("%7s\n", "~lines");
+		}else{
+			printf("%7lu\n", (unsigned long)result[p].traps);
+		}
+	}
+	tru_semihost_flush();
+}
+
+#endif
@@ -0,0 +1,251 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	UART transmit path benchmark.  Only compiled when UART_BENCH is defined.
+
+	Sends the same lines through each of the UART transmit paths at several
+	baud rates and reports for each:
+	- bytes per second, streaming lines back to back until the transmitter is
+	  empty.  This is normally limited by the baud rate
+	- CPU cycles per byte spent inside the write call when the FIFO has room
+	  for the whole line, i.e. the cost of the path itself
+	- worst case latency of a single write call while streaming
+
+	Timing is from the Cortex-A9 global timer, alt_globaltmr_get64().  The
+	results are printed after all runs so that printing does not disturb the
+	measurements, even when printf goes out through the same UART.
+*/
+
+#ifdef UART_BENCH
+
+#include "bench_uart.h"
+#include "alt_clock_manager.h"
+#include "alt_globaltmr.h"
+#include "alt_printf.h"
+#include "alt_timers.h"
+#include "c5_uart.h"
+#include "socal/alt_uart.h"
+#include "socal/hps.h"
+#include "socal/socal.h"
+#include <stdio.h>
+#include <string.h>
+
+// alt_printf.h is included for the stream type of the alt_p2uart.c terminal only.  The results go out through newlib
+#undef printf
+#undef snprintf
+#undef sprintf
+#undef vprintf
+
+#define BENCH_LINE_LEN 64     // Length of one write call, including the line ending.  Must fit in the FIFO
+#define BENCH_LINE_NUM 64     // Number of write calls per run
+
+typedef size_t (*bench_write_t)(ALT_16550_HANDLE_t *handle, const char *line, size_t len);
+
+typedef struct{
+	const char *name;
+	bench_write_t write;
+}bench_path_t;
+
+typedef struct{
+	uint64_t bytes;
+	uint64_t total_ticks;  // Streaming, first call until the transmitter is empty
+	uint64_t max_ticks;    // Streaming, worst case single write call
+	uint64_t burst_bytes;
+	uint64_t burst_ticks;  // Sum of time inside the write calls when starting with an empty FIFO
+}bench_result_t;
+
+static const uint32_t bench_baud[] = {
+	115200,
+	230400,
+	460800,
+	921600
+};
+
+#define BENCH_BAUD_NUM (sizeof(bench_baud) / sizeof(bench_baud[0]))
+
+static size_t bench_write_c5_uart(ALT_16550_HANDLE_t *handle, const char *line, size_t len){
+	c5_uart_write_str(ALT_UART0_OFST, line, len);
+	return len;
+}
+
+static size_t bench_write_fifo_safe(ALT_16550_HANDLE_t *handle, const char *line, size_t len){
+	alt_16550_fifo_write_safe(handle, line, len, true);
+	return len;
+}
+
+// alt_16550_fifo_write() does not check for space, so wait for enough room as a caller would have to
+static size_t bench_write_fifo(ALT_16550_HANDLE_t *handle, const char *line, size_t len){
+	uint32_t size;
+	uint32_t level;
+
+	alt_16550_fifo_size_get_tx(handle, &size);
+	do{
+		alt_16550_fifo_level_get_tx(handle, &level);
+	}while(size - level < len);
+	alt_16550_fifo_write(handle, line, len);
+	return len;
+}
+
+// The alt_p2uart.c printf route: format, then one putc call per character which adds '\r' before '\n'
+static size_t bench_write_p2uart(ALT_16550_HANDLE_t *handle, const char *line, size_t len){
+	char buf[BENCH_LINE_LEN + 1];
+	ALT_PRINTF_STREAM_t *term = (ALT_PRINTF_STREAM_t *)term0;
+	int n = snprintf(buf, sizeof(buf), "%.*s\n", (int)(len - 2), line);
+	int i;
+
+	for(i = 0; i < n; i++){
+		term->putc_function(buf[i], term0);
+	}
+	return n + 1;
+}
+
+// The alt_p2uart.c stream route: the formatted line handed over as one run, as alt_vfprintf() does on a flush
+static size_t bench_write_p2uart_run(ALT_16550_HANDLE_t *handle, const char *line, size_t len){
+	char buf[BENCH_LINE_LEN];
+	ALT_PRINTF_STREAM_t *term = (ALT_PRINTF_STREAM_t *)term0;
+
+	memcpy(buf, line, len - 2);
+	buf[len - 2] = '\n';
+	term->write_function(buf, len - 1, term0);
+	return len;
+}
+
+static const bench_path_t bench_path[] = {
+	{ "c5_uart_write_str",         bench_write_c5_uart },
+	{ "alt_16550_fifo_write_safe", bench_write_fifo_safe },
+	{ "alt_16550_fifo_write",      bench_write_fifo },
+	{ "alt_p2uart printf",         bench_write_p2uart },
+	{ "alt_p2uart stream write",   bench_write_p2uart_run }
+};
+
+#define BENCH_PATH_NUM (sizeof(bench_path) / sizeof(bench_path[0]))
+
+static void bench_wait_empty(ALT_16550_HANDLE_t *handle){
+	uint32_t line_status;
+
+	do{
+		alt_16550_line_status_get(handle, &line_status);
+	}while((line_status & ALT_16550_LINE_STATUS_TEMT) == 0);
+}
+
+static void bench_run_path(ALT_16550_HANDLE_t *handle, const bench_path_t *path, const char *line, bench_result_t *result){
+	uint64_t start;
+	uint64_t t0;
+	uint64_t t1;
+	uint32_t i;
+
+	memset(result, 0, sizeof(*result));
+	bench_wait_empty(handle);
+
+	start = alt_globaltmr_get64();
+	for(i = 0; i < BENCH_LINE_NUM; i++){
+		t0 = alt_globaltmr_get64();
+		result->bytes += path->write(handle, line, BENCH_LINE_LEN);
+		t1 = alt_globaltmr_get64();
+
+		if(t1 - t0 > result->max_ticks) result->max_ticks = t1 - t0;
+	}
+	bench_wait_empty(handle);
+	result->total_ticks = alt_globaltmr_get64() - start;
+
+	// Again, but let the transmitter drain between calls so only the cost of the path is timed
+	for(i = 0; i < BENCH_LINE_NUM; i++){
+		bench_wait_empty(handle);
+		t0 = alt_globaltmr_get64();
+		result->burst_bytes += path->write(handle, line, BENCH_LINE_LEN);
+		t1 = alt_globaltmr_get64();
+
+		result->burst_ticks += t1 - t0;
+	}
+}
+
+static void bench_print(const bench_path_t *path, uint32_t baud, const bench_result_t *result, uint32_t tmr_freq, uint32_t cpu_freq){
+	uint64_t bytes_per_sec = result->bytes * tmr_freq / result->total_ticks;
+	uint64_t cycles_per_byte_x10 = result->burst_ticks * 10 * (cpu_freq / tmr_freq) / result->burst_bytes;
+	uint64_t max_us = result->max_ticks * 1000000 / tmr_freq;
+
+	printf("%-26s %7lu %9lu %6lu.%lu %9lu\n",
+		path->name,
+		(unsigned long)baud,
+		(unsigned long)bytes_per_sec,
+		(unsigned long)(cycles_per_byte_x10 / 10),
+		(unsigned long)(cycles_per_byte_x10 % 10),
+		(unsigned long)max_us);
+}
+
+void bench_uart_run(ALT_16550_HANDLE_t *handle){
+	static bench_result_t result[BENCH_BAUD_NUM][BENCH_PATH_NUM];
+	char line[BENCH_LINE_LEN];
+	alt_freq_t cpu_freq = 0;
+	uint32_t tmr_freq;
+	uint32_t b;
+	uint32_t p;
+
+	// Printable test pattern with a line ending
+	for(p = 0; p < BENCH_LINE_LEN - 2; p++){
+		line[p] = '!' + (p % 94);
+	}
+	line[BENCH_LINE_LEN - 2] = '\r';
+	line[BENCH_LINE_LEN - 1] = '\n';
+
+	alt_globaltmr_init();
+	alt_globaltmr_start();
+	tmr_freq = alt_gpt_freq_get(ALT_GPT_CPU_GLOBAL_TMR);
+	alt_clk_freq_get(ALT_CLK_MPU, &cpu_freq);
+
+	// The alt_p2uart.c terminal initialises the UART itself on first use, get that out of the way and then restore our settings
+	((ALT_PRINTF_STREAM_t *)term0)->putc_function('\n', term0);
+	bench_wait_empty(handle);
+	alt_16550_fifo_trigger_set_rx(handle, ALT_16550_FIFO_TRIGGER_RX_HALF_FULL);
+	alt_16550_fifo_trigger_set_tx(handle, ALT_16550_FIFO_TRIGGER_TX_QUARTER_FULL);
+
+	for(b = 0; b < BENCH_BAUD_NUM; b++){
+		bench_wait_empty(handle);
+		alt_16550_disable(handle);
+		alt_16550_baudrate_set(handle, bench_baud[b]);
+		alt_16550_enable(handle);
+		c5_uart_mode_refresh(ALT_UART0_OFST);
+
+		for(p = 0; p < BENCH_PATH_NUM; p++){
+			bench_run_path(handle, &bench_path[p], line, &result[b][p]);
+		}
+	}
+
+	// Back to the normal baud rate before printing, in case printf uses this UART
+	bench_wait_empty(handle);
+	alt_16550_disable(handle);
+	alt_16550_baudrate_set(handle, ALT_16550_BAUDRATE_115200);
+	alt_16550_enable(handle);
+
+	printf("\nUART transmit benchmark, %u lines of %u bytes per run\n", BENCH_LINE_NUM, BENCH_LINE_LEN);
+	printf("%-26s %7s %9s %8s %9s\n", "path", "baud", "bytes/s", "cyc/B", "max us");
+	for(b = 0; b < BENCH_BAUD_NUM; b++){
+		for(p = 0; p < BENCH_PATH_NUM; p++){
+			bench_print(&bench_path[p], bench_baud[b], &result[b][p], tmr_freq, cpu_freq);
+		}
+	}
+}
+
+#endif
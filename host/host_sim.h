@@ -0,0 +1,84 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Host (PC) simulation of the Cyclone V HPS parts used by the UART code, so
+	that it can be built, tested and benchmarked without a board.  Only
+	compiled when HOST_SIM is defined, see the readme for the build command.
+
+	Register reads and writes are routed here from alt_read_word(),
+	alt_write_word(), c5_io_rd_word() and c5_io_wr_word().  Time is virtual:
+	each register access costs HOST_SIM_ACCESS_NS, and the UARTs shift
+	characters in and out at the programmed baud rate against that clock.
+	The results are deterministic, which makes them useful for tracking
+	regressions, but they do not include time spent on the CPU between
+	register accesses.
+
+	Interrupt handlers registered with alt_int_isr_register() are called
+	between register accesses when their UART has an interrupt pending, the
+	same point at which the core would take the IRQ.
+*/
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Virtual cost of one register access in nanoseconds
+#ifndef HOST_SIM_ACCESS_NS
+	#define HOST_SIM_ACCESS_NS 100
+#endif
+
+// Simulated clock frequencies
+#define HOST_SIM_MPU_FREQ    800000000UL
+#define HOST_SIM_PERIPH_FREQ 200000000UL  // MPU peripheral clock, drives the global timer
+#define HOST_SIM_L4_SP_FREQ  100000000UL  // UART reference clock
+
+// Simulated UART FIFO depth, transmit and receive
+#define HOST_SIM_UART_FIFO_DEPTH 128
+
+// Size of the receive line queue and the transmit capture buffer of each UART
+#define HOST_SIM_UART_LINE_SIZE 4096
+
+// Register access, used by the accessor macros
+uint32_t host_sim_rd_word(uintptr_t addr);
+void host_sim_wr_word(uintptr_t addr, uint32_t value);
+
+// Virtual time
+uint64_t host_sim_time_ns(void);
+void host_sim_advance(uint64_t ns);
+int host_sim_wfi(void);
+
+// UART line side
+uint64_t host_sim_uart_tx_count(uintptr_t uart_base_addr);
+size_t host_sim_uart_tx_read(uintptr_t uart_base_addr, char *buf, size_t len);
+void host_sim_uart_tx_echo(uintptr_t uart_base_addr, int echo);
+size_t host_sim_uart_rx_push(uintptr_t uart_base_addr, const char *data, size_t len);
+uint32_t host_sim_uart_irq_pending(uintptr_t uart_base_addr);
+
+// Interrupt controller, in host_sim_hwlib.c
+void host_sim_irq_dispatch(void);
+
+#endif
@@ -0,0 +1,157 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Host (PC) replacements for the HWLib clock manager, interrupt controller
+	and timer functions used by the UART code.  The global timer counts the
+	simulated MPU peripheral clock against the virtual time of the simulator,
+	and registered UART interrupt handlers are called when the simulated UART
+	raises its interrupt.
+*/
+
+#ifdef HOST_SIM
+
+#include "host_sim.h"
+#include "alt_clock_manager.h"
+#include "alt_interrupt.h"
+#include "alt_globaltmr.h"
+#include "alt_timers.h"
+#include "socal/hps.h"
+
+// Clock manager
+ALT_STATUS_CODE alt_clk_is_enabled(ALT_CLK_t clk){
+	(void)clk;
+	return ALT_E_TRUE;
+}
+
+ALT_STATUS_CODE alt_clk_freq_get(ALT_CLK_t clk, alt_freq_t *freq){
+	switch(clk){
+		case ALT_CLK_MPU:
+			*freq = HOST_SIM_MPU_FREQ;
+			break;
+		case ALT_CLK_MPU_PERIPH:
+			*freq = HOST_SIM_PERIPH_FREQ;
+			break;
+		case ALT_CLK_L4_SP:
+			*freq = HOST_SIM_L4_SP_FREQ;
+			break;
+		default:
+			return ALT_E_BAD_ARG;
+	}
+	return ALT_E_SUCCESS;
+}
+
+// Interrupt controller, only the UART interrupts are simulated
+typedef struct{
+	ALT_INT_INTERRUPT_t int_id;
+	uintptr_t uart_base_addr;
+	alt_int_callback_t callback;
+	void *context;
+	uint32_t enabled;
+}sim_isr_t;
+
+static sim_isr_t sim_isr[] = {
+	{ ALT_INT_INTERRUPT_UART0, ALT_UART0_OFST, 0, 0, 0 },
+	{ ALT_INT_INTERRUPT_UART1, ALT_UART1_OFST, 0, 0, 0 }
+};
+
+#define SIM_ISR_NUM (sizeof(sim_isr) / sizeof(sim_isr[0]))
+
+static uint32_t sim_irq_active;
+
+static sim_isr_t *sim_isr_get(ALT_INT_INTERRUPT_t int_id){
+	uint32_t i;
+
+	for(i = 0; i < SIM_ISR_NUM; i++){
+		if(sim_isr[i].int_id == int_id) return &sim_isr[i];
+	}
+	return 0;
+}
+
+ALT_STATUS_CODE alt_int_isr_register(ALT_INT_INTERRUPT_t int_id, alt_int_callback_t callback, void *context){
+	sim_isr_t *isr = sim_isr_get(int_id);
+
+	if(!isr) return ALT_E_BAD_ARG;
+	isr->callback = callback;
+	isr->context = context;
+	return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_int_dist_target_set(ALT_INT_INTERRUPT_t int_id, alt_int_cpu_target_t target){
+	(void)target;
+	return sim_isr_get(int_id) ? ALT_E_SUCCESS : ALT_E_BAD_ARG;
+}
+
+ALT_STATUS_CODE alt_int_dist_enable(ALT_INT_INTERRUPT_t int_id){
+	sim_isr_t *isr = sim_isr_get(int_id);
+
+	if(!isr) return ALT_E_BAD_ARG;
+	isr->enabled = 1;
+	return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_int_dist_disable(ALT_INT_INTERRUPT_t int_id){
+	sim_isr_t *isr = sim_isr_get(int_id);
+
+	if(!isr) return ALT_E_BAD_ARG;
+	isr->enabled = 0;
+	return ALT_E_SUCCESS;
+}
+
+/*
+	Call the handler of every enabled interrupt that is pending.  Called by the
+	simulator after each register access.  Handlers are not nested, the same
+	as an IRQ handler on the core running with IRQ masked.
+*/
+void host_sim_irq_dispatch(void){
+	uint32_t i;
+
+	if(sim_irq_active) return;
+	sim_irq_active = 1;
+	for(i = 0; i < SIM_ISR_NUM; i++){
+		if(sim_isr[i].enabled && sim_isr[i].callback && host_sim_uart_irq_pending(sim_isr[i].uart_base_addr)){
+			sim_isr[i].callback(sim_isr[i].int_id, sim_isr[i].context);
+		}
+	}
+	sim_irq_active = 0;
+}
+
+// Global timer
+ALT_STATUS_CODE alt_globaltmr_init(void){
+	return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_globaltmr_start(void){
+	return ALT_E_SUCCESS;
+}
+
+uint64_t alt_globaltmr_get64(void){
+	return host_sim_time_ns() * (HOST_SIM_PERIPH_FREQ / 1000000) / 1000;
+}
+
+uint32_t alt_gpt_freq_get(ALT_GPT_TIMER_t tmr_id){
+	return (tmr_id == ALT_GPT_CPU_GLOBAL_TMR) ? HOST_SIM_PERIPH_FREQ : 0;
+}
+
+#endif
@@ -0,0 +1,567 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Simulated Synopsys DesignWare 16550 UART, as found in the Cyclone V HPS.
+
+	Models what the UART drivers rely on:
+	- transmit and receive FIFOs, or a single holding register with the FIFO
+	  disabled
+	- the transmit shift register and the receive line running at the
+	  programmed baud rate and line format
+	- LSR, USR, TFL and RFL status, including a sticky overrun error
+	- the FCR trigger levels with their SFE, SRT, STET, SDMAM and SRR shadow
+	  registers, and HTX
+	- IIR interrupt identification in priority order, including the
+	  programmable THRE mode and the character timeout
+	- loopback through MCR
+
+	Characters to receive are queued on the line with host_sim_uart_rx_push()
+	and arrive one character time apart.  Transmitted characters are kept in
+	a capture buffer, see host_sim_uart_tx_read().
+*/
+
+#ifdef HOST_SIM
+
+#include <stdio.h>
+#include "host_sim.h"
+#include "socal/alt_uart.h"
+#include "socal/hps.h"
+
+#define SIM_UART_NUM 2
+#define SIM_REG_NUM 64
+
+typedef struct{
+	char *data;
+	uint32_t size;
+	uint32_t head;
+	uint32_t count;
+}sim_queue_t;
+
+typedef struct{
+	uint32_t ier;
+	uint32_t lcr;
+	uint32_t mcr;
+	uint32_t scr;
+	uint32_t divisor;
+	uint32_t fifo_en;
+	uint32_t dmam;
+	uint32_t tet;       // TX empty trigger, FCR[5:4] and STET
+	uint32_t rt;        // RX trigger, FCR[7:6] and SRT
+	uint32_t htx;
+	uint32_t lsr_err;   // Sticky line errors, cleared by reading LSR
+
+	sim_queue_t tx_fifo;
+	uint32_t tx_shifting;
+	char tx_shift;
+	uint64_t tx_done;   // Time the character in the shift register is out
+	uint64_t tx_total;
+
+	sim_queue_t rx_fifo;
+	sim_queue_t rx_line;
+	uint64_t rx_next;   // Arrival time of the next character on the line
+	uint64_t rx_last;   // Time of the last receive FIFO activity, for the character timeout
+
+	sim_queue_t tx_cap;
+	int tx_echo;
+
+	char tx_fifo_data[HOST_SIM_UART_FIFO_DEPTH];
+	char rx_fifo_data[HOST_SIM_UART_FIFO_DEPTH];
+	char rx_line_data[HOST_SIM_UART_LINE_SIZE];
+	char tx_cap_data[HOST_SIM_UART_LINE_SIZE];
+}sim_uart_t;
+
+typedef struct{
+	uintptr_t addr;
+	uint32_t value;
+}sim_reg_t;
+
+static const uintptr_t sim_uart_base[SIM_UART_NUM] = { ALT_UART0_OFST, ALT_UART1_OFST };
+
+static uint64_t sim_now;
+static uint32_t sim_init_done;
+static sim_uart_t sim_uart[SIM_UART_NUM];
+static sim_reg_t sim_reg[SIM_REG_NUM];
+
+static void sim_queue_init(sim_queue_t *q, char *data, uint32_t size){
+	q->data = data;
+	q->size = size;
+	q->head = 0;
+	q->count = 0;
+}
+
+static int sim_queue_put(sim_queue_t *q, char c){
+	if(q->count >= q->size) return 0;
+	q->data[(q->head + q->count) % q->size] = c;
+	q->count++;
+	return 1;
+}
+
+static char sim_queue_get(sim_queue_t *q){
+	char c = q->data[q->head];
+
+	q->head = (q->head + 1) % q->size;
+	q->count--;
+	return c;
+}
+
+static void sim_uart_reset(sim_uart_t *u){
+	u->ier = 0;
+	u->lcr = 0;
+	u->mcr = 0;
+	u->scr = 0;
+	u->divisor = 0;
+	u->fifo_en = 0;
+	u->dmam = 0;
+	u->tet = 0;
+	u->rt = 0;
+	u->htx = 0;
+	u->lsr_err = 0;
+	u->tx_fifo.count = 0;
+	u->tx_shifting = 0;
+	u->rx_fifo.count = 0;
+}
+
+// Power up into the state U-Boot-SPL leaves the UARTs in: 115200 8-N-1 with the FIFO enabled
+static void sim_init(void){
+	sim_uart_t *u;
+	uint32_t i;
+
+	for(i = 0; i < SIM_UART_NUM; i++){
+		u = &sim_uart[i];
+		sim_queue_init(&u->tx_fifo, u->tx_fifo_data, HOST_SIM_UART_FIFO_DEPTH);
+		sim_queue_init(&u->rx_fifo, u->rx_fifo_data, HOST_SIM_UART_FIFO_DEPTH);
+		sim_queue_init(&u->rx_line, u->rx_line_data, HOST_SIM_UART_LINE_SIZE);
+		sim_queue_init(&u->tx_cap, u->tx_cap_data, HOST_SIM_UART_LINE_SIZE);
+		sim_uart_reset(u);
+		u->lcr = 0x3;
+		u->divisor = (HOST_SIM_L4_SP_FREQ + 8 * 115200) / (16 * 115200);
+		u->fifo_en = 1;
+	}
+	sim_init_done = 1;
+}
+
+static sim_uart_t *sim_uart_get(uintptr_t addr){
+	uint32_t i;
+
+	if(!sim_init_done) sim_init();
+	for(i = 0; i < SIM_UART_NUM; i++){
+		if(addr >= sim_uart_base[i] && addr < sim_uart_base[i] + 0x100) return &sim_uart[i];
+	}
+	return 0;
+}
+
+static uint32_t sim_uart_depth(sim_uart_t *u){
+	return u->fifo_en ? HOST_SIM_UART_FIFO_DEPTH : 1;
+}
+
+// Time in nanoseconds to shift one character, including start, parity and stop bits
+static uint64_t sim_uart_char_ns(sim_uart_t *u){
+	uint64_t bits = 1 + 5 + (u->lcr & 0x3) + ((u->lcr >> 3) & 1) + ((u->lcr & 0x4) ? 2 : 1);
+
+	return bits * 16 * u->divisor * 1000000000ULL / HOST_SIM_L4_SP_FREQ;
+}
+
+static uint32_t sim_uart_rx_trigger(sim_uart_t *u){
+	if(!u->fifo_en) return 1;
+	switch(u->rt){
+		case 0: return 1;
+		case 1: return HOST_SIM_UART_FIFO_DEPTH / 4;
+		case 2: return HOST_SIM_UART_FIFO_DEPTH / 2;
+		default: return HOST_SIM_UART_FIFO_DEPTH - 2;
+	}
+}
+
+static uint32_t sim_uart_tx_trigger(sim_uart_t *u){
+	switch(u->tet){
+		case 0: return 0;
+		case 1: return 2;
+		case 2: return HOST_SIM_UART_FIFO_DEPTH / 4;
+		default: return HOST_SIM_UART_FIFO_DEPTH / 2;
+	}
+}
+
+static void sim_uart_rx_line_put(sim_uart_t *u, char c){
+	if(u->rx_line.count == 0) u->rx_next = sim_now + sim_uart_char_ns(u);
+	sim_queue_put(&u->rx_line, c);
+}
+
+static void sim_uart_tx_out(sim_uart_t *u, char c){
+	u->tx_total++;
+	if(u->tx_cap.count == u->tx_cap.size) sim_queue_get(&u->tx_cap);  // Keep the most recent
+	sim_queue_put(&u->tx_cap, c);
+	if(u->tx_echo) fputc(c, stdout);
+	if(u->mcr & ALT_UART_MCR_LOOPBACK_SET_MSK) sim_uart_rx_line_put(u, c);
+}
+
+// Bring the transmitter and receiver up to the current virtual time
+static void sim_uart_advance(sim_uart_t *u){
+	uint64_t char_ns = sim_uart_char_ns(u);
+
+	for(;;){
+		if(u->tx_shifting){
+			if(sim_now < u->tx_done) break;
+			u->tx_shifting = 0;
+			sim_uart_tx_out(u, u->tx_shift);
+			if(u->tx_fifo.count && !u->htx){
+				// Next character follows back to back
+				u->tx_shift = sim_queue_get(&u->tx_fifo);
+				u->tx_shifting = 1;
+				u->tx_done += char_ns;
+			}
+		}else{
+			if(u->tx_fifo.count == 0 || u->htx || char_ns == 0) break;
+			u->tx_shift = sim_queue_get(&u->tx_fifo);
+			u->tx_shifting = 1;
+			u->tx_done = sim_now + char_ns;
+		}
+	}
+
+	while(u->rx_line.count && char_ns && sim_now >= u->rx_next){
+		char c = sim_queue_get(&u->rx_line);
+
+		if(u->rx_fifo.count < sim_uart_depth(u)){
+			sim_queue_put(&u->rx_fifo, c);
+		}else{
+			u->lsr_err |= ALT_UART_LSR_OE_SET_MSK;  // Overrun, the character is lost
+		}
+		u->rx_last = u->rx_next;
+		u->rx_next += char_ns;
+	}
+}
+
+static uint32_t sim_uart_rx_timeout(sim_uart_t *u){
+	return u->fifo_en && u->rx_fifo.count && sim_now >= u->rx_last + 4 * sim_uart_char_ns(u);
+}
+
+static uint32_t sim_uart_lsr(sim_uart_t *u){
+	uint32_t lsr = u->lsr_err;
+
+	if(u->rx_fifo.count) lsr |= ALT_UART_LSR_DR_SET_MSK;
+	if(u->fifo_en && (u->ier & ALT_UART_IER_DLH_PTIME_DLH7_SET_MSK)){
+		// Programmable THRE mode: THRE means the FIFO is full
+		if(u->tx_fifo.count >= HOST_SIM_UART_FIFO_DEPTH) lsr |= ALT_UART_LSR_THRE_SET_MSK;
+	}else{
+		if(u->tx_fifo.count == 0) lsr |= ALT_UART_LSR_THRE_SET_MSK;
+	}
+	if(u->tx_fifo.count == 0 && !u->tx_shifting) lsr |= ALT_UART_LSR_TEMT_SET_MSK;
+
+	return lsr;
+}
+
+// IIR interrupt ID, highest priority first
+static uint32_t sim_uart_iid(sim_uart_t *u){
+	uint32_t thre;
+
+	if((u->ier & ALT_UART_IER_DLH_ELSI_DHL2_SET_MSK) && u->lsr_err) return 0x6;
+	if(u->ier & ALT_UART_IER_DLH_ERBFI_DLH0_SET_MSK){
+		if(u->rx_fifo.count >= sim_uart_rx_trigger(u)) return 0x4;
+		if(sim_uart_rx_timeout(u)) return 0xc;
+	}
+	if(u->ier & ALT_UART_IER_DLH_ETBEI_DLHL_SET_MSK){
+		if(u->fifo_en && (u->ier & ALT_UART_IER_DLH_PTIME_DLH7_SET_MSK)){
+			thre = u->tx_fifo.count <= sim_uart_tx_trigger(u);
+		}else{
+			thre = u->tx_fifo.count == 0;
+		}
+		if(thre) return 0x2;
+	}
+	return 0x1;
+}
+
+static void sim_uart_fcr(sim_uart_t *u, uint32_t value){
+	uint32_t fifo_en = value & ALT_UART_FCR_FIFOE_SET_MSK;
+
+	if(u->fifo_en != fifo_en){
+		// Changing mode resets the FIFOs
+		u->tx_fifo.count = 0;
+		u->rx_fifo.count = 0;
+	}
+	u->fifo_en = fifo_en;
+	if(value & ALT_UART_FCR_RFIFOR_SET_MSK) u->rx_fifo.count = 0;
+	if(value & ALT_UART_FCR_XFIFOR_SET_MSK) u->tx_fifo.count = 0;
+	u->dmam = (value & ALT_UART_FCR_DMAM_SET_MSK) ? 1 : 0;
+	u->tet = (value & ALT_UART_FCR_TET_SET_MSK) >> 4;
+	u->rt = (value & ALT_UART_FCR_RT_SET_MSK) >> 6;
+}
+
+static uint32_t sim_uart_rd(sim_uart_t *u, uint32_t offset){
+	uint32_t dlab = u->lcr & ALT_UART_LCR_DLAB_SET_MSK;
+	uint32_t value;
+
+	switch(offset){
+		case ALT_UART_RBR_THR_DLL_OFST:
+			if(dlab) return u->divisor & 0xff;
+			if(u->rx_fifo.count == 0) return 0;
+			u->rx_last = sim_now;
+			return (uint8_t)sim_queue_get(&u->rx_fifo);
+		case ALT_UART_IER_DLH_OFST:
+			return dlab ? ((u->divisor >> 8) & 0xff) : u->ier;
+		case ALT_UART_IIR_OFST:
+			return (u->fifo_en ? 0xc0 : 0) | sim_uart_iid(u);
+		case ALT_UART_LCR_OFST:
+			return u->lcr;
+		case ALT_UART_MCR_OFST:
+			return u->mcr;
+		case ALT_UART_LSR_OFST:
+			value = sim_uart_lsr(u);
+			u->lsr_err = 0;
+			return value;
+		case ALT_UART_MSR_OFST:
+			return 0;
+		case ALT_UART_SCR_OFST:
+			return u->scr;
+		case ALT_UART_USR_OFST:
+			value = 0;
+			if(u->tx_fifo.count < sim_uart_depth(u)) value |= ALT_UART_USR_TFNF_SET_MSK;
+			if(u->tx_fifo.count == 0) value |= ALT_UART_USR_TFE_SET_MSK;
+			if(u->rx_fifo.count) value |= ALT_UART_USR_RFNE_SET_MSK;
+			if(u->rx_fifo.count >= sim_uart_depth(u)) value |= ALT_UART_USR_RFF_SET_MSK;
+			return value;
+		case ALT_UART_TFL_OFST:
+			return u->tx_fifo.count;
+		case ALT_UART_RFL_OFST:
+			return u->rx_fifo.count;
+		case ALT_UART_SDMAM_OFST:
+			return u->dmam;
+		case ALT_UART_SFE_OFST:
+			return u->fifo_en;
+		case ALT_UART_SRT_OFST:
+			return u->rt;
+		case ALT_UART_STET_OFST:
+			return u->tet;
+		case ALT_UART_HTX_OFST:
+			return u->htx;
+		case ALT_UART_CPR_OFST:
+			return (HOST_SIM_UART_FIFO_DEPTH >> 4) << ALT_UART_CPR_FIFO_MOD_LSB;
+		case ALT_UART_UCV_OFST:
+			return ALT_UART_UCV_UART_COMPONENT_VER_RESET;
+		default:
+			return 0;
+	}
+}
+
+static void sim_uart_wr(sim_uart_t *u, uint32_t offset, uint32_t value){
+	uint32_t dlab = u->lcr & ALT_UART_LCR_DLAB_SET_MSK;
+
+	switch(offset){
+		case ALT_UART_RBR_THR_DLL_OFST:
+			if(dlab){
+				u->divisor = (u->divisor & 0xff00) | (value & 0xff);
+			}else if(u->tx_fifo.count < sim_uart_depth(u)){
+				sim_queue_put(&u->tx_fifo, (char)value);
+				sim_uart_advance(u);
+			}
+			break;
+		case ALT_UART_IER_DLH_OFST:
+			if(dlab){
+				u->divisor = (u->divisor & 0xff) | ((value & 0xff) << 8);
+			}else{
+				u->ier = value;
+			}
+			break;
+		case ALT_UART_FCR_OFST:
+			sim_uart_fcr(u, value);
+			break;
+		case ALT_UART_LCR_OFST:
+			u->lcr = value;
+			break;
+		case ALT_UART_MCR_OFST:
+			u->mcr = value;
+			break;
+		case ALT_UART_SCR_OFST:
+			u->scr = value;
+			break;
+		case ALT_UART_SRR_OFST:
+			if(value & ALT_UART_SRR_UR_SET_MSK){
+				sim_uart_reset(u);
+				break;
+			}
+			if(value & ALT_UART_SRR_RFR_SET_MSK) u->rx_fifo.count = 0;
+			if(value & ALT_UART_SRR_XFR_SET_MSK) u->tx_fifo.count = 0;
+			break;
+		case ALT_UART_SDMAM_OFST:
+			u->dmam = value & 1;
+			break;
+		case ALT_UART_SFE_OFST:
+			if(u->fifo_en != (value & 1)){
+				u->tx_fifo.count = 0;
+				u->rx_fifo.count = 0;
+			}
+			u->fifo_en = value & 1;
+			break;
+		case ALT_UART_SRT_OFST:
+			u->rt = value & 0x3;
+			break;
+		case ALT_UART_STET_OFST:
+			u->tet = value & 0x3;
+			break;
+		case ALT_UART_HTX_OFST:
+			u->htx = value & 1;
+			sim_uart_advance(u);
+			break;
+		default:
+			break;
+	}
+}
+
+// Any other register is plain storage, e.g. the reset manager
+static sim_reg_t *sim_reg_get(uintptr_t addr){
+	uint32_t i;
+
+	for(i = 0; i < SIM_REG_NUM; i++){
+		if(sim_reg[i].addr == addr) return &sim_reg[i];
+		if(sim_reg[i].addr == 0){
+			sim_reg[i].addr = addr;
+			return &sim_reg[i];
+		}
+	}
+	return &sim_reg[SIM_REG_NUM - 1];
+}
+
+static void sim_advance_all(void){
+	uint32_t i;
+
+	for(i = 0; i < SIM_UART_NUM; i++){
+		sim_uart_advance(&sim_uart[i]);
+	}
+}
+
+uint32_t host_sim_rd_word(uintptr_t addr){
+	sim_uart_t *u = sim_uart_get(addr);
+	uint32_t value;
+
+	sim_now += HOST_SIM_ACCESS_NS;
+	sim_advance_all();
+
+	value = u ? sim_uart_rd(u, addr & 0xff) : sim_reg_get(addr)->value;
+	host_sim_irq_dispatch();
+	return value;
+}
+
+void host_sim_wr_word(uintptr_t addr, uint32_t value){
+	sim_uart_t *u = sim_uart_get(addr);
+
+	sim_now += HOST_SIM_ACCESS_NS;
+	sim_advance_all();
+
+	if(u){
+		sim_uart_wr(u, addr & 0xff, value);
+	}else{
+		sim_reg_get(addr)->value = value;
+	}
+	host_sim_irq_dispatch();
+}
+
+uint64_t host_sim_time_ns(void){
+	return sim_now;
+}
+
+// Let virtual time pass, e.g. for code running on the CPU between register accesses
+void host_sim_advance(uint64_t ns){
+	if(!sim_init_done) sim_init();
+	sim_now += ns;
+	sim_advance_all();
+	host_sim_irq_dispatch();
+}
+
+/*
+	Wait for interrupt: jump virtual time to the next UART event, i.e. a
+	character finished sending, a character arriving or a receive timeout,
+	and take any interrupt it raises.  Returns 0 when nothing is left that
+	could ever raise one, where the real core would sleep forever.
+*/
+int host_sim_wfi(void){
+	uint64_t next = UINT64_MAX;
+	uint64_t t;
+	sim_uart_t *u;
+	uint32_t i;
+
+	if(!sim_init_done) sim_init();
+	for(i = 0; i < SIM_UART_NUM; i++){
+		u = &sim_uart[i];
+		if(u->tx_shifting && u->tx_done < next) next = u->tx_done;
+		if(u->rx_line.count && sim_uart_char_ns(u) && u->rx_next < next) next = u->rx_next;
+		if(u->fifo_en && u->rx_fifo.count){
+			t = u->rx_last + 4 * sim_uart_char_ns(u);
+			if(t > sim_now && t < next) next = t;
+		}
+	}
+	if(next == UINT64_MAX) return 0;
+
+	if(next > sim_now) sim_now = next;
+	sim_advance_all();
+	host_sim_irq_dispatch();
+	return 1;
+}
+
+uint64_t host_sim_uart_tx_count(uintptr_t uart_base_addr){
+	sim_uart_t *u = sim_uart_get(uart_base_addr);
+
+	if(!u) return 0;
+	sim_uart_advance(u);
+	return u->tx_total;
+}
+
+// Read back, and remove, characters that have been shifted out
+size_t host_sim_uart_tx_read(uintptr_t uart_base_addr, char *buf, size_t len){
+	sim_uart_t *u = sim_uart_get(uart_base_addr);
+	size_t i = 0;
+
+	if(!u) return 0;
+	sim_uart_advance(u);
+	while(i < len && u->tx_cap.count){
+		buf[i++] = sim_queue_get(&u->tx_cap);
+	}
+	return i;
+}
+
+// Also write characters that have been shifted out to stdout
+void host_sim_uart_tx_echo(uintptr_t uart_base_addr, int echo){
+	sim_uart_t *u = sim_uart_get(uart_base_addr);
+
+	if(u) u->tx_echo = echo;
+}
+
+// Queue characters on the receive line, they arrive one character time apart.  Returns the count queued
+size_t host_sim_uart_rx_push(uintptr_t uart_base_addr, const char *data, size_t len){
+	sim_uart_t *u = sim_uart_get(uart_base_addr);
+	size_t i = 0;
+
+	if(!u) return 0;
+	sim_uart_advance(u);
+	while(i < len && u->rx_line.count < u->rx_line.size){
+		sim_uart_rx_line_put(u, data[i++]);
+	}
+	return i;
+}
+
+uint32_t host_sim_uart_irq_pending(uintptr_t uart_base_addr){
+	sim_uart_t *u = sim_uart_get(uart_base_addr);
+
+	if(!u) return 0;
+	return sim_uart_iid(u) != 0x1;
+}
+
+#endif
@@ -40,6 +40,27 @@
 #include "hwlib.h"
 #include "alt_clock_manager.h"
 
+/*!
+ * \addtogroup UART_COMPILE UART API Compile Options
+ *
+ * This API provides control over the compile time inclusion of selected
+ * modules. This can allow for a smaller resulting binary.
+ *
+ * @{
+ */
+
+#ifndef ALT_16550_PROVISION_DMA_SUPPORT
+#define ALT_16550_PROVISION_DMA_SUPPORT (1)
+#endif
+
+#if ALT_16550_PROVISION_DMA_SUPPORT
+#include "alt_dma.h"
+#endif
+
+/*!
+ * @}
+ */
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -94,6 +115,41 @@ typedef enum ALT_16550_DEVICE_e
 }
 ALT_16550_DEVICE_t;
 
+/*!
+ * This structure is used to represent a software ring buffer used by the
+ * interrupt driven transfer APIs. The storage is provided by the user and
+ * attached to a UART by calling alt_16550_tx_async_init() or
+ * alt_16550_rx_async_init(). The internal
+ * members are undocumented and should be not altered outside of this API.
+ */
+typedef struct ALT_16550_RING_s
+{
+    char *            buffer;
+    uint32_t          size;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t          high_water;
+    uint32_t          dropped;
+    uint32_t          errors;
+}
+ALT_16550_RING_t;
+
+/*!
+ * This structure describes one segment of a vectored (scatter-gather) write.
+ * An array of these is passed to alt_16550_fifo_writev(),
+ * alt_16550_tx_async_writev() or alt_16550_dma_writev() to transmit several
+ * buffers back to back without first concatenating them.
+ */
+typedef struct ALT_16550_IOVEC_s
+{
+    /*! Pointer to the characters of the segment. */
+    const char * buffer;
+
+    /*! The count of characters in the segment. */
+    size_t       count;
+}
+ALT_16550_IOVEC_t;
+
 /*!
  * This structure is used to represent a handle to a specific UART on the
  * system. The internal members are undocumented and should be not altered
@@ -106,6 +162,10 @@ typedef struct ALT_16550_HANDLE_s
     alt_freq_t         clock_freq;
     uint32_t           data;
     uint32_t           fcr;
+    uint32_t           tx_fifo_size;
+    ALT_16550_RING_t * tx_ring;
+    ALT_16550_RING_t * rx_ring;
+    struct ALT_16550_DMA_s * tx_dma;
 }
 ALT_16550_HANDLE_t;
 
@@ -426,6 +486,12 @@ ALT_STATUS_CODE alt_16550_fifo_write(ALT_16550_HANDLE_t * handle,
  * Writes the given buffer to the transmitter FIFO in the UART, blocking 
  * if the fifo is full until there is enough space to write the string
  *
+ * For the SoCFPGA UARTs, the free space is computed from the TX FIFO size
+ * cached by alt_16550_fifo_enable() and a single read of the TX FIFO level,
+ * and then as many characters as fit are written in one burst. For the
+ * Altera 16550 Compatible Soft UART, which has no TX FIFO level, the line
+ * status is polled before every character.
+ *
  * Writing more data that there is space can result in data lost due to
  * overflowing.
  *
@@ -455,6 +521,37 @@ ALT_STATUS_CODE alt_16550_fifo_write_safe(ALT_16550_HANDLE_t * handle,
                                      const char * buffer,
                                      size_t count,
                                      bool safe);
+
+/*!
+ * Writes the given segments, in order, to the transmitter FIFO in the UART.
+ * This behaves as if alt_16550_fifo_write_safe() were called for each
+ * segment, except that for the SoCFPGA UARTs the free FIFO space carries
+ * over from one segment to the next. No intermediate copy is made.
+ *
+ * The FIFOs must first be enabled before calling this function by calling
+ * alt_16550_fifo_enable().
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       iov
+ *              Pointer to an array of segments to be written.
+ *
+ * \param       iovcnt
+ *              The count of segments in the array.
+ *
+ * \param       safe
+ *              true = block when the FIFO is full until space is available
+ *              false = do not block.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given UART device handle is invalid.
+ */
+ALT_STATUS_CODE alt_16550_fifo_writev(ALT_16550_HANDLE_t * handle,
+                                      const ALT_16550_IOVEC_t * iov,
+                                      size_t iovcnt,
+                                      bool safe);
 /*!
  * Clears the contents of the receiver FIFO. Any characters which were
  * previously contained in that FIFO will be discarded.
@@ -1580,6 +1677,498 @@ ALT_STATUS_CODE alt_16550_line_status_get(ALT_16550_HANDLE_t * handle,
  * @}
  */
 
+/*!
+ * \addtogroup UART_ASYNC UART Interrupt Driven Transfers
+ *
+ * This group of APIs provides buffered, interrupt driven transmission and
+ * reception for the UART. Rather than spinning on the line status for every
+ * character, the caller queues data into a software ring buffer and returns
+ * immediately. The UART TX interrupt then refills the transmitter FIFO in
+ * bursts until the ring buffer is drained.
+ *
+ * In the receive direction, the RX data and RX character timeout interrupts
+ * empty the receiver FIFO into a software ring buffer, from where it is
+ * read by calling alt_16550_rx_async_read(). The character timeout interrupt
+ * ensures that characters below the RX trigger level are not left in the
+ * receiver FIFO.
+ *
+ * The recommended bring up is as follows:
+ *  * Initialize and configure the UART and enable the FIFOs as usual.
+ *  * Attach a ring buffer by calling alt_16550_tx_async_init().
+ *  * Register the UART interrupt by calling alt_16550_async_int_register(),
+ *    or register alt_16550_async_isr() with alt_int_isr_register() directly
+ *    for an Altera 16550 Compatible Soft IP UART.
+ *  * Queue data by calling alt_16550_tx_async_write().
+ *
+ * Reception is brought up by calling alt_16550_rx_async_init() in place of,
+ * or in addition to, alt_16550_tx_async_init().
+ *
+ * Each ring buffer is lock-free for a single producer and a single consumer,
+ * one of which is the interrupt handler. The user side and the UART
+ * interrupt are expected to run on the same CPU.
+ *
+ * @{
+ */
+
+/*!
+ * This structure is used to report the usage statistics of a ring buffer.
+ */
+typedef struct ALT_16550_RING_STATS_s
+{
+    /*! The capacity of the ring buffer in characters. */
+    uint32_t size;
+
+    /*! The count of characters currently held in the ring buffer. */
+    uint32_t level;
+
+    /*! The highest level reached since the last statistics reset. */
+    uint32_t high_water;
+
+    /*! The count of characters discarded because the ring buffer was full. */
+    uint32_t dropped;
+
+    /*!
+     * The count of line status errors (overrun, parity, framing or break)
+     * reported by the receiver. This is always 0 for the transmit ring buffer.
+     */
+    uint32_t errors;
+}
+ALT_16550_RING_STATS_t;
+
+/*!
+ * Attaches a transmit ring buffer to the UART, enabling the interrupt driven
+ * transmit APIs. Any previously attached ring buffer is detached.
+ *
+ * The FIFOs should be enabled by calling alt_16550_fifo_enable() so that the
+ * interrupt handler can refill the transmitter FIFO in bursts.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       ring
+ *              [out] Pointer to the ring buffer control structure. This must
+ *              remain valid until alt_16550_tx_async_uninit() is called.
+ *
+ * \param       buffer
+ *              Pointer to the storage used by the ring buffer.
+ *
+ * \param       size
+ *              The size of the storage in characters. This must be a power
+ *              of 2 and at least 2.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given size or buffer is invalid.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_init(ALT_16550_HANDLE_t * handle,
+                                        ALT_16550_RING_t * ring,
+                                        char * buffer,
+                                        uint32_t size);
+
+/*!
+ * Detaches the transmit ring buffer from the UART and disables the TX
+ * interrupt. Any characters still queued are discarded.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_uninit(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * Queues the given buffer into the transmit ring buffer and enables the TX
+ * interrupt. The function returns as soon as the data is queued; the
+ * interrupt handler moves it to the transmitter FIFO.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       buffer
+ *              Pointer to a buffer from where the specified count of
+ *              characters will be queued.
+ *
+ * \param       count
+ *              The count of characters from the given buffer to be queued.
+ *
+ * \param       safe
+ *              true = block when the ring buffer is full until the interrupt
+ *                     handler frees enough space. This must not be used with
+ *                     the UART interrupt masked.
+ *              false = do not block. Characters which do not fit are
+ *                      discarded and counted in the statistics.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BUF_OVF   Some characters were discarded.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_write(ALT_16550_HANDLE_t * handle,
+                                         const char * buffer,
+                                         size_t count,
+                                         bool safe);
+
+/*!
+ * Queues the given segments, in order, into the transmit ring buffer and
+ * enables the TX interrupt once for the whole set. This behaves as
+ * alt_16550_tx_async_write() for the concatenation of the segments.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       iov
+ *              Pointer to an array of segments to be queued.
+ *
+ * \param       iovcnt
+ *              The count of segments in the array.
+ *
+ * \param       safe
+ *              true = block when the ring buffer is full.
+ *              false = do not block, discard what does not fit.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BUF_OVF   Some characters were discarded.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_writev(ALT_16550_HANDLE_t * handle,
+                                          const ALT_16550_IOVEC_t * iov,
+                                          size_t iovcnt,
+                                          bool safe);
+
+/*!
+ * Blocks until the transmit ring buffer is drained and the transmitter is
+ * empty. This must not be used with the UART interrupt masked.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_flush(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * Queries the usage statistics of the transmit ring buffer. This can be used
+ * to size the ring buffer under load.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       stats
+ *              [out] Pointer to an output parameter that contains the
+ *              statistics of the transmit ring buffer.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_stats_get(ALT_16550_HANDLE_t * handle,
+                                             ALT_16550_RING_STATS_t * stats);
+
+/*!
+ * Resets the high water mark and dropped count of the transmit ring buffer.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_tx_async_stats_reset(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * Attaches a receive ring buffer to the UART and enables the RX data, RX
+ * character timeout and line status interrupts. Any previously attached ring
+ * buffer is detached.
+ *
+ * The FIFOs should be enabled by calling alt_16550_fifo_enable() and the RX
+ * trigger level set by calling alt_16550_fifo_trigger_set_rx(). A higher
+ * trigger level results in fewer interrupts; the character timeout interrupt
+ * collects any remainder.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       ring
+ *              [out] Pointer to the ring buffer control structure. This must
+ *              remain valid until alt_16550_rx_async_uninit() is called.
+ *
+ * \param       buffer
+ *              Pointer to the storage used by the ring buffer.
+ *
+ * \param       size
+ *              The size of the storage in characters. This must be a power
+ *              of 2 and at least 2.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given size or buffer is invalid.
+ */
+ALT_STATUS_CODE alt_16550_rx_async_init(ALT_16550_HANDLE_t * handle,
+                                        ALT_16550_RING_t * ring,
+                                        char * buffer,
+                                        uint32_t size);
+
+/*!
+ * Detaches the receive ring buffer from the UART and disables the RX and line
+ * status interrupts. Any characters still buffered are discarded.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_rx_async_uninit(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * Reads up to the given count of characters from the receive ring buffer.
+ * This never blocks; it returns with however many characters were available,
+ * which may be 0.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       buffer
+ *              [out] Pointer to a buffer where the received characters will
+ *              be copied to.
+ *
+ * \param       count
+ *              The maximum count of characters to copy.
+ *
+ * \param       read_count
+ *              [out] Pointer to an output parameter that contains the count
+ *              of characters copied.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_rx_async_read(ALT_16550_HANDLE_t * handle,
+                                        char * buffer,
+                                        size_t count,
+                                        size_t * read_count);
+
+/*!
+ * Queries the usage statistics of the receive ring buffer. The level is the
+ * count of received characters waiting to be read.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       stats
+ *              [out] Pointer to an output parameter that contains the
+ *              statistics of the receive ring buffer.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_rx_async_stats_get(ALT_16550_HANDLE_t * handle,
+                                             ALT_16550_RING_STATS_t * stats);
+
+/*!
+ * Resets the high water mark, dropped count and error count of the receive
+ * ring buffer.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_rx_async_stats_reset(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * The UART interrupt handler used by the interrupt driven transfer APIs. It
+ * has the signature of alt_int_callback_t and expects the UART device handle
+ * as its context. It services every pending UART interrupt before returning.
+ *
+ * \param       icciar
+ *              The interrupt acknowledge register value.
+ *
+ * \param       context
+ *              The UART device handle.
+ */
+void alt_16550_async_isr(uint32_t icciar, void * context);
+
+/*!
+ * Registers alt_16550_async_isr() with the interrupt controller for the
+ * given UART and enables the interrupt in the distributor. The interrupt
+ * controller must first be initialized by calling alt_int_global_init() and
+ * alt_int_cpu_init().
+ *
+ * This is only supported for the SoCFPGA UARTs. For the Altera 16550
+ * Compatible Soft IP UART, register alt_16550_async_isr() with the
+ * appropriate FPGA interrupt by calling alt_int_isr_register().
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given UART device is not supported.
+ */
+ALT_STATUS_CODE alt_16550_async_int_register(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * @}
+ */
+
+#if ALT_16550_PROVISION_DMA_SUPPORT
+
+/*!
+ * \addtogroup UART_DMA UART DMA Transmit
+ *
+ * This group of APIs provides a DMA backed transmit path for bulk output.
+ * The data is copied into one half of a double buffer while the DMA
+ * controller feeds the other half into the transmitter FIFO using the UART
+ * DMA handshake. The CPU is therefore only busy for the copy, not for the
+ * wire time of the data.
+ *
+ * Writes shorter than a configurable threshold are sent with the CPU by
+ * calling alt_16550_fifo_write_safe() when no DMA transfer is in flight, as
+ * the cost of building and launching a DMA program outweighs the benefit.
+ *
+ * The DMA controller must first be initialized by calling alt_dma_init() and
+ * a channel allocated by calling alt_dma_channel_alloc() or
+ * alt_dma_channel_alloc_any(). Only the SoCFPGA UARTs are supported.
+ *
+ * @{
+ */
+
+/*!
+ * This structure holds the state of the DMA transmit path. The storage is
+ * provided by the user and attached to a UART by calling
+ * alt_16550_dma_tx_init(). The internal members are undocumented and should
+ * be not altered outside of this API.
+ */
+typedef struct ALT_16550_DMA_s
+{
+    ALT_DMA_CHANNEL_t channel;
+    ALT_DMA_PERIPH_t  periph;
+    char *            buffer[2];
+    uint32_t          buffer_size;
+    uint32_t          threshold;
+    uint32_t          fill;
+    bool              busy;
+    ALT_DMA_PROGRAM_t program[2];
+}
+ALT_16550_DMA_t;
+
+/*!
+ * Attaches a DMA transmit path to the UART and switches the UART DMA
+ * handshake to multiple transfer mode.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       dma
+ *              [out] Pointer to the DMA transmit state. This must remain
+ *              valid until alt_16550_dma_tx_uninit() is called.
+ *
+ * \param       channel
+ *              An allocated DMA channel to use for the transfers.
+ *
+ * \param       buffer
+ *              Pointer to the staging storage, which is split into two
+ *              halves. This must be aligned to ALT_CACHE_LINE_SIZE.
+ *
+ * \param       size
+ *              The size of the staging storage in bytes. This must be a
+ *              non-zero multiple of 2 * ALT_CACHE_LINE_SIZE.
+ *
+ * \param       threshold
+ *              Writes shorter than this count of characters are sent with the
+ *              CPU when no DMA transfer is in flight.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given device, buffer or size is invalid.
+ */
+ALT_STATUS_CODE alt_16550_dma_tx_init(ALT_16550_HANDLE_t * handle,
+                                      ALT_16550_DMA_t * dma,
+                                      ALT_DMA_CHANNEL_t channel,
+                                      char * buffer,
+                                      uint32_t size,
+                                      uint32_t threshold);
+
+/*!
+ * Waits for any DMA transfer in flight, then detaches the DMA transmit path
+ * from the UART. The DMA channel is not freed.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ */
+ALT_STATUS_CODE alt_16550_dma_tx_uninit(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * Writes the given buffer to the UART using the DMA transmit path. The data
+ * is copied into the staging buffers, so the given buffer may be reused as
+ * soon as the function returns. The function blocks only while both halves
+ * of the staging buffer are in use; the last part of the data is still being
+ * transmitted when it returns.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       buffer
+ *              Pointer to a buffer from where the specified count of
+ *              characters will be transmitted.
+ *
+ * \param       count
+ *              The count of characters from the given buffer to transmit.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed or the DMA channel
+ *                              faulted.
+ */
+ALT_STATUS_CODE alt_16550_dma_write(ALT_16550_HANDLE_t * handle,
+                                    const char * buffer,
+                                    size_t count);
+
+/*!
+ * Writes the given segments, in order, to the UART using the DMA transmit
+ * path. The segments are gathered directly into the staging buffers, so the
+ * only copy made is the one into DMA visible memory. The CPU fallback for
+ * short writes applies to the total size of all segments.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \param       iov
+ *              Pointer to an array of segments to be transmitted.
+ *
+ * \param       iovcnt
+ *              The count of segments in the array.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed or the DMA channel
+ *                              faulted.
+ */
+ALT_STATUS_CODE alt_16550_dma_writev(ALT_16550_HANDLE_t * handle,
+                                     const ALT_16550_IOVEC_t * iov,
+                                     size_t iovcnt);
+
+/*!
+ * Blocks until the DMA transfer in flight, if any, completes and the
+ * transmitter is empty.
+ *
+ * \param       handle
+ *              The UART device handle.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed or the DMA channel
+ *                              faulted.
+ */
+ALT_STATUS_CODE alt_16550_dma_flush(ALT_16550_HANDLE_t * handle);
+
+/*!
+ * @}
+ */
+
+#endif /* ALT_16550_PROVISION_DMA_SUPPORT */
+
 /*!
  * @}
  */
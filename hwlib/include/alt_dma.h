@@ -805,6 +805,70 @@ ALT_STATUS_CODE alt_dma_memory_to_memory(ALT_DMA_CHANNEL_t channel,
                                          bool send_evt,
                                          ALT_DMA_EVENT_t evt);
 
+/*!
+ * This type defines one entry of the list given to
+ * alt_dma_memory_to_memory_sg().
+ */
+typedef struct ALT_DMA_SG_ENTRY_s
+{
+    /*! The destination memory address to copy to. */
+    void * dst;
+
+    /*! The source memory address to copy from. */
+    const void * src;
+
+    /*! The size of the copy in bytes. Entries with a size of zero are skipped. */
+    size_t size;
+}
+ALT_DMA_SG_ENTRY_t;
+
+/*!
+ * Uses the DMA engine to asynchronously copy a list of memory regions, e.g.
+ * to gather a packet header and payload or to copy many small records. All
+ * entries are assembled into one program that runs on the channel once, so
+ * each entry only costs its address and burst instructions. The entries are
+ * copied in list order.
+ *
+ * The source and destination of an entry must not overlap. The number of
+ * entries is limited by the program buffer size; if they do not fit
+ * ALT_E_BUF_OVF is returned and ALT_DMA_PROGRAM_PROVISION_BUFFER_SIZE may be
+ * increased.
+ *
+ * \param       channel
+ *              The DMA channel thread to use for the transfer.
+ *
+ * \param       program
+ *              An allocated DMA program buffer to use for the life of the
+ *              transfer.
+ *
+ * \param       list
+ *              The list of regions to copy. It is only read during the call.
+ *
+ * \param       count
+ *              The number of entries in the list.
+ *
+ * \param       send_evt
+ *              If set to true, the DMA engine will be instructed to send an
+ *              event after the last entry has completed, or upon a fault.
+ *
+ * \param       evt
+ *              If send_evt is true, the event specified will be sent.
+ *              Otherwise the parameter is ignored.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The given channel or event identifier (if
+ *                              used) is invalid, or the memory regions of an
+ *                              entry are overlapping.
+ * \retval      ALT_E_BUF_OVF   The list does not fit in the program buffer.
+ */
+ALT_STATUS_CODE alt_dma_memory_to_memory_sg(ALT_DMA_CHANNEL_t channel,
+                                            ALT_DMA_PROGRAM_t * program,
+                                            const ALT_DMA_SG_ENTRY_t * list,
+                                            size_t count,
+                                            bool send_evt,
+                                            ALT_DMA_EVENT_t evt);
+
 /*!
  * Uses the DMA engine to asynchronously zero out the specified memory buffer.
  *
@@ -1112,6 +1176,211 @@ ALT_STATUS_CODE alt_dma_periph_to_memory(ALT_DMA_CHANNEL_t channel,
  * @}
  */
 
+/*!
+ * \addtogroup ALT_DMA_TEMPLATE DMA API for Program Templates
+ *
+ * The functions in this group assemble a memory to memory, zero to memory or
+ * memory to register program once and then relaunch it on new buffers. The
+ * standard operations reassemble the whole program, validate it, clean it to
+ * RAM and translate its address on every call. A template does that once
+ * when it is built. A relaunch only patches the SAR, DAR and loop count
+ * immediates of the program, cleans the cache line(s) holding them and
+ * issues the DMAGO.
+ *
+ * A template is fixed to the shape of the transfer it was built for. A
+ * relaunch is accepted when the new transfer assembles to the same program
+ * apart from those immediates:
+ *  * The buffers must have the same alignment modulo 8 as the ones used to
+ *    build the template. For alt_dma_template_memory_to_register() they only
+ *    need to be aligned to the register width.
+ *  * The size must be the same, or differ by a whole number of 16 beat
+ *    bursts (128 bytes, or 16 register transfers) when both the template and
+ *    the relaunch need 2 - 256 of those bursts.
+ *  * Each buffer must translate to a single physical segment.
+ *
+ * The same cache maintenance precautions as for the standard operations
+ * apply to the source and destination buffers. A template must not be
+ * relaunched while an earlier launch of it is still running.
+ *
+ * @{
+ */
+
+/*!
+ * This type defines the structure used to hold a pre-assembled DMA program
+ * template. The internal members are undocumented and should not be altered
+ * outside of this API.
+ */
+typedef struct ALT_DMA_TEMPLATE_s
+{
+    ALT_DMA_PROGRAM_t program;
+
+    uintptr_t pgmpa;
+
+    uint8_t  type;
+    uint8_t  align;
+    uint8_t  head;
+    uint8_t  tail;
+    uint32_t loops;
+    size_t   size;
+}
+ALT_DMA_TEMPLATE_t;
+
+/*!
+ * Builds a memory to memory template from a first transfer. The program is
+ * assembled as for alt_dma_memory_to_memory() but not run.
+ *
+ * \param       tmpl
+ *              The template to build. It must be kept for as long as the
+ *              template is used.
+ *
+ * \param       dest
+ *              The destination memory address to copy to.
+ *
+ * \param       src
+ *              The source memory address to copy from.
+ *
+ * \param       size
+ *              The size of the transfer in bytes.
+ *
+ * \param       send_evt
+ *              If set to true, the DMA engine will be instructed to send an
+ *              event upon completion or fault.
+ *
+ * \param       evt
+ *              If send_evt is true, the event specified will be sent.
+ *              Otherwise the parameter is ignored.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The size is zero, the event identifier (if
+ *                              used) is invalid, the memory regions specified
+ *                              are overlapping, or a buffer does not
+ *                              translate to a single physical segment.
+ */
+ALT_STATUS_CODE alt_dma_template_memory_to_memory(ALT_DMA_TEMPLATE_t * tmpl,
+                                                  void * dest,
+                                                  const void * src,
+                                                  size_t size,
+                                                  bool send_evt,
+                                                  ALT_DMA_EVENT_t evt);
+
+/*!
+ * Builds a zero to memory template from a first transfer. The program is
+ * assembled as for alt_dma_zero_to_memory() but not run.
+ *
+ * \param       tmpl
+ *              The template to build. It must be kept for as long as the
+ *              template is used.
+ *
+ * \param       buf
+ *              The buffer memory address to zero out.
+ *
+ * \param       size
+ *              The size of the buffer in bytes.
+ *
+ * \param       send_evt
+ *              If set to true, the DMA engine will be instructed to send an
+ *              event upon completion or fault.
+ *
+ * \param       evt
+ *              If send_evt is true, the event specified will be sent.
+ *              Otherwise the parameter is ignored.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The size is zero, the event identifier (if
+ *                              used) is invalid, or the buffer does not
+ *                              translate to a single physical segment.
+ */
+ALT_STATUS_CODE alt_dma_template_zero_to_memory(ALT_DMA_TEMPLATE_t * tmpl,
+                                                void * buf,
+                                                size_t size,
+                                                bool send_evt,
+                                                ALT_DMA_EVENT_t evt);
+
+/*!
+ * Builds a memory to register template from a first transfer. The program is
+ * assembled as for alt_dma_memory_to_register() but not run.
+ *
+ * \param       tmpl
+ *              The template to build. It must be kept for as long as the
+ *              template is used.
+ *
+ * \param       dst_reg
+ *              The address of the register to write buffer to.
+ *
+ * \param       src_buf
+ *              The address of the memory buffer for the data.
+ *
+ * \param       count
+ *              The number of transfers to make.
+ *
+ * \param       register_width_bits
+ *              The width of the register to transfer to in bits. Valid values
+ *              are 8, 16, 32, and 64.
+ *
+ * \param       send_evt
+ *              If set to true, the DMA engine will be instructed to send an
+ *              event upon completion or fault.
+ *
+ * \param       evt
+ *              If send_evt is true, the event specified will be sent.
+ *              Otherwise the parameter is ignored.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The operation failed.
+ * \retval      ALT_E_BAD_ARG   The count is zero, the event identifier (if
+ *                              used) or register width are invalid, the
+ *                              destination register or source buffer is
+ *                              unaligned to the register width, or the source
+ *                              buffer does not translate to a single physical
+ *                              segment.
+ */
+ALT_STATUS_CODE alt_dma_template_memory_to_register(ALT_DMA_TEMPLATE_t * tmpl,
+                                                    void * dst_reg,
+                                                    const void * src_buf,
+                                                    size_t count,
+                                                    uint32_t register_width_bits,
+                                                    bool send_evt,
+                                                    ALT_DMA_EVENT_t evt);
+
+/*!
+ * Relaunches a template on new buffers. The parameters have the same meaning
+ * as for the function that built the template. Parameters which do not apply
+ * to it are ignored.
+ *
+ * \param       channel
+ *              The DMA channel thread to use for the transfer.
+ *
+ * \param       tmpl
+ *              The template to run.
+ *
+ * \param       dest
+ *              The destination memory address, buffer or register.
+ *
+ * \param       src
+ *              The source memory address. Ignored for zero to memory.
+ *
+ * \param       size
+ *              The size of the transfer in bytes, or the number of transfers
+ *              for memory to register.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_ERROR     The channel is not allocated or not stopped,
+ *                              or the template has not been built.
+ * \retval      ALT_E_BAD_ARG   The channel is invalid, or the transfer does
+ *                              not fit the shape of the template.
+ */
+ALT_STATUS_CODE alt_dma_template_exec(ALT_DMA_CHANNEL_t channel,
+                                      ALT_DMA_TEMPLATE_t * tmpl,
+                                      void * dest,
+                                      const void * src,
+                                      size_t size);
+
+/*!
+ * @}
+ */
+
 #ifdef __cplusplus
 }
 #endif  /* __cplusplus */
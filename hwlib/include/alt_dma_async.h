@@ -0,0 +1,132 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+/*
+ * Interrupt driven completion for DMA transfers.
+ *
+ * Each channel signals its completion with the DMA event of the same number,
+ * see alt_dma_async_event(), and alt_dma_async_init() routes the 8 events to
+ * the DMA interrupts. One ISR serves all of them and the DMA abort interrupt.
+ *
+ * To run a transfer asynchronously, attach an ALT_DMA_ASYNC_t to the channel
+ * with alt_dma_async_attach(), then start the transfer with send_evt set to
+ * true and evt set to alt_dma_async_event(channel). When the event arrives
+ * the ISR completes the transfer: it stores the status, marks it done and
+ * calls the callback, if any, in interrupt context. The transfer is detached
+ * first, so the callback may attach and start the next transfer on the same
+ * channel. A channel which does not stop shortly after its event is killed
+ * and the transfer completes with ALT_E_TMO, so the channel can be reused.
+ * Without a callback, wait with alt_dma_async_wait() or poll
+ * alt_dma_async_done().
+ *
+ * A channel which faults raises the abort interrupt instead of its event.
+ * The ISR kills it and completes the transfer with ALT_E_ERROR and the
+ * channel fault status in the fault member. Faults on channels without an
+ * attached transfer are left for their owner to handle, and the abort
+ * interrupt is masked until the next alt_dma_async_attach().
+ */
+
+#if !defined(ALT_DMA_ASYNC_H)
+#define ALT_DMA_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "alt_dma.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Passed to alt_dma_async_wait() to wait without a timeout. A timeout of 0
+ * polls once.
+ */
+#define ALT_DMA_ASYNC_WAIT_FOREVER (UINT32_MAX)
+
+/* Called in interrupt context when an attached transfer completes */
+typedef void (*alt_dma_async_callback_t)(ALT_DMA_CHANNEL_t channel, ALT_STATUS_CODE status, void * context);
+
+/* One asynchronous transfer. It must stay valid until it has completed */
+typedef struct ALT_DMA_ASYNC_s
+{
+    alt_dma_async_callback_t callback;
+    void * context;
+
+    /* Set by the ISR, after status and fault */
+    volatile bool done;
+    volatile ALT_STATUS_CODE status;
+    ALT_DMA_CHANNEL_FAULT_t fault;
+}
+ALT_DMA_ASYNC_t;
+
+/*
+ * Routes the DMA events 0 - 7 to their interrupts and registers the ISR for
+ * them and the abort interrupt, targeted at CPU0. The interrupt controller
+ * must have been initialised.
+ */
+ALT_STATUS_CODE alt_dma_async_init(void);
+
+/* Unregisters the ISR and returns the events to the DMAWFE use */
+ALT_STATUS_CODE alt_dma_async_uninit(void);
+
+/* The event a transfer on the channel must send to complete */
+ALT_DMA_EVENT_t alt_dma_async_event(ALT_DMA_CHANNEL_t channel);
+
+/*
+ * Attaches a transfer to the channel, to be completed by the channel's
+ * next event. callback may be NULL. Returns ALT_E_ERROR if another transfer
+ * is attached.
+ */
+ALT_STATUS_CODE alt_dma_async_attach(ALT_DMA_CHANNEL_t channel,
+                                     ALT_DMA_ASYNC_t * xfer,
+                                     alt_dma_async_callback_t callback,
+                                     void * context);
+
+/*
+ * Detaches the channel's transfer without completing it, e.g. when starting
+ * the transfer failed or after a timeout. The channel is not stopped.
+ */
+ALT_STATUS_CODE alt_dma_async_detach(ALT_DMA_CHANNEL_t channel);
+
+/* True once the transfer has completed */
+bool alt_dma_async_done(const ALT_DMA_ASYNC_t * xfer);
+
+/*
+ * Waits for the transfer to complete and returns its status, or ALT_E_TMO
+ * after timeout_us microseconds. The transfer stays attached on a timeout.
+ * With ALT_DMA_ASYNC_WAIT_FOREVER the core sleeps in WFI between interrupts.
+ */
+ALT_STATUS_CODE alt_dma_async_wait(const ALT_DMA_ASYNC_t * xfer, uint32_t timeout_us);
+
+/* The ISR, for registering with a custom interrupt setup */
+void alt_dma_async_isr(uint32_t icciar, void * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -120,6 +120,9 @@ typedef struct ALT_DMA_PROGRAM_s
     uint16_t sar;
     uint16_t dar;
 
+    uint16_t lc0;
+    uint16_t lc1;
+
     /*
      * Add a little extra space so that regardless of where this structure
      * sits in memory, a suitable start address can be aligned to the cache
@@ -309,6 +312,31 @@ ALT_STATUS_CODE alt_dma_program_progress_reg(ALT_DMA_PROGRAM_t * pgm,
 ALT_STATUS_CODE alt_dma_program_update_reg(ALT_DMA_PROGRAM_t * pgm,
                                            ALT_DMA_PROGRAM_REG_t reg, uint32_t val);
 
+/*!
+ * This function updates the iteration count of a pre-existing DMALP. The
+ * first DMALP assembled for each of the loop counter registers LC0 and LC1 is
+ * tracked. Together with alt_dma_program_update_reg() this allows for
+ * pre-assembled programs that can be used on transfers of different sizes.
+ *
+ * \param       pgm
+ *              A pointer to a DMA program buffer structure.
+ *
+ * \param       loop
+ *              The loop counter register of the DMALP to change, 0 for LC0 or
+ *              1 for LC1.
+ *
+ * \param       iterations
+ *              The number of iterations, 1 - 256.
+ *
+ * \retval      ALT_E_SUCCESS   The operation was successful.
+ * \retval      ALT_E_BAD_ARG   The specified loop is invalid, the iterations
+ *                              is out of range, or no DMALP for the specified
+ *                              loop has been assembled in the current program
+ *                              buffer.
+ */
+ALT_STATUS_CODE alt_dma_program_update_loop(ALT_DMA_PROGRAM_t * pgm,
+                                            uint32_t loop, uint32_t iterations);
+
 /*!
  */
 
@@ -0,0 +1,207 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+/*
+ * Priority scheduler for DMA jobs on a pool of channels.
+ *
+ * alt_dma_sched_init() takes free channels with alt_dma_channel_alloc_any()
+ * into the pool. Jobs submitted to the scheduler wait in one queue, highest
+ * priority first and in submission order within a priority, and start as
+ * soon as a channel they may use is free. Completions arrive through
+ * alt_dma_async.h, so alt_dma_async_init() must have been called. The
+ * completion of a job starts the next one from the DMA interrupt.
+ *
+ * Every job belongs to a client. A client can reserve channels out of the
+ * pool with alt_dma_sched_client_init(), e.g. for UART RX or SPI, which must
+ * not wait behind bulk copies. Its jobs run on its reserved channels first
+ * and then on the shared channels. Clients without reserved channels share
+ * the channels nobody has reserved. Each client counts its jobs, the bytes
+ * in the size member of its jobs, the time its jobs held a channel and the
+ * longest time a job waited in the queue.
+ *
+ * A job is started by its start function, called with IRQ masked, which
+ * assembles and runs the transfer on the given channel and program, sending
+ * the given event at the end. alt_dma_sched_copy() submits a memory to
+ * memory copy with a built in start function. As with
+ * alt_dma_memory_to_memory(), cache maintenance of the buffers is left to
+ * the caller.
+ */
+
+#if !defined(ALT_DMA_SCHED_H)
+#define ALT_DMA_SCHED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "alt_dma.h"
+#include "alt_dma_async.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Passed to alt_dma_sched_wait() to wait without a timeout */
+#define ALT_DMA_SCHED_WAIT_FOREVER ALT_DMA_ASYNC_WAIT_FOREVER
+
+/* Passed to alt_dma_sched_init() to take every free channel */
+#define ALT_DMA_SCHED_ALL_CHANNELS (0)
+
+/* A user of the scheduler, with its reserved channels and statistics */
+typedef struct ALT_DMA_SCHED_CLIENT_s
+{
+    /* Bit mask of the channels reserved for the client */
+    uint32_t reserved;
+
+    /* Statistics since alt_dma_sched_client_stats_reset() */
+    uint32_t jobs;
+    uint32_t failed;
+    uint64_t bytes;
+    uint64_t busy_ticks;
+    uint64_t wait_ticks_max;
+    uint64_t since;
+}
+ALT_DMA_SCHED_CLIENT_t;
+
+struct ALT_DMA_SCHED_JOB_s;
+
+/*
+ * Starts the job's transfer on the channel with the program, which belongs
+ * to the channel and stays untouched until the job has completed. The
+ * transfer must send evt when it is done. Called with IRQ masked.
+ */
+typedef ALT_STATUS_CODE (*alt_dma_sched_start_t)(struct ALT_DMA_SCHED_JOB_s * job,
+                                                 ALT_DMA_CHANNEL_t channel,
+                                                 ALT_DMA_PROGRAM_t * program,
+                                                 ALT_DMA_EVENT_t evt);
+
+/* Called when a job completes, in interrupt context unless the start failed */
+typedef void (*alt_dma_sched_callback_t)(struct ALT_DMA_SCHED_JOB_s * job, ALT_STATUS_CODE status);
+
+/*
+ * One job. Zero it before its first submission. It must stay valid until it
+ * has completed or been cancelled, and can then be submitted again.
+ */
+typedef struct ALT_DMA_SCHED_JOB_s
+{
+    /* The transfer, for the start function. size is counted in the client bytes */
+    void * dst;
+    const void * src;
+    size_t size;
+
+    alt_dma_sched_callback_t callback;
+    void * context;
+
+    /* Set on completion, after status */
+    volatile bool done;
+    volatile ALT_STATUS_CODE status;
+
+    /* Internal */
+    struct ALT_DMA_SCHED_JOB_s * next;
+    ALT_DMA_SCHED_CLIENT_t * client;
+    alt_dma_sched_start_t start;
+    uint32_t priority;
+    volatile uint32_t state;
+    ALT_DMA_CHANNEL_t channel;
+    uint64_t queued;
+    uint64_t started;
+    ALT_DMA_ASYNC_t async;
+}
+ALT_DMA_SCHED_JOB_t;
+
+/*
+ * Takes up to count free channels, or all with ALT_DMA_SCHED_ALL_CHANNELS,
+ * into the pool. Returns ALT_E_ERROR if no channel is free.
+ */
+ALT_STATUS_CODE alt_dma_sched_init(uint32_t count);
+
+/* Frees the pool channels. Returns ALT_E_ERROR while jobs are queued or running */
+ALT_STATUS_CODE alt_dma_sched_uninit(void);
+
+/*
+ * Initialises a client and reserves reserve channels of the shared ones for
+ * it. A reserved channel still running a shared job is used by the client
+ * once that job completes. Returns ALT_E_ERROR if fewer channels are shared.
+ */
+ALT_STATUS_CODE alt_dma_sched_client_init(ALT_DMA_SCHED_CLIENT_t * client, uint32_t reserve);
+
+/* Returns the reserved channels of the client to the shared ones */
+ALT_STATUS_CODE alt_dma_sched_client_uninit(ALT_DMA_SCHED_CLIENT_t * client);
+
+/* Clears the statistics of the client and starts a new measurement period */
+void alt_dma_sched_client_stats_reset(ALT_DMA_SCHED_CLIENT_t * client);
+
+/*
+ * The time the client's jobs held a channel, in parts per thousand of the
+ * time since the statistics were reset. Above 1000 when the client used
+ * several channels at once.
+ */
+uint32_t alt_dma_sched_client_load(const ALT_DMA_SCHED_CLIENT_t * client);
+
+/*
+ * Queues a job with the priority, higher values first, and starts it if a
+ * channel is free. The dst, src and size members are passed on as set by
+ * the caller. callback may be NULL. Returns ALT_E_ERROR if the job is
+ * already queued or running.
+ */
+ALT_STATUS_CODE alt_dma_sched_submit(ALT_DMA_SCHED_JOB_t * job,
+                                     ALT_DMA_SCHED_CLIENT_t * client,
+                                     uint32_t priority,
+                                     alt_dma_sched_start_t start,
+                                     alt_dma_sched_callback_t callback,
+                                     void * context);
+
+/* Submits a copy of size bytes from src to dst with alt_dma_memory_to_memory() */
+ALT_STATUS_CODE alt_dma_sched_copy(ALT_DMA_SCHED_JOB_t * job,
+                                   ALT_DMA_SCHED_CLIENT_t * client,
+                                   uint32_t priority,
+                                   void * dst,
+                                   const void * src,
+                                   size_t size,
+                                   alt_dma_sched_callback_t callback,
+                                   void * context);
+
+/*
+ * Removes a job from the queue without completing it. Returns ALT_E_ERROR
+ * if it is not queued, e.g. already running.
+ */
+ALT_STATUS_CODE alt_dma_sched_cancel(ALT_DMA_SCHED_JOB_t * job);
+
+/* True once the job has completed */
+bool alt_dma_sched_done(const ALT_DMA_SCHED_JOB_t * job);
+
+/*
+ * Waits for the job to complete and returns its status, or ALT_E_TMO after
+ * timeout_us microseconds. With ALT_DMA_SCHED_WAIT_FOREVER the core sleeps
+ * in WFI between interrupts.
+ */
+ALT_STATUS_CODE alt_dma_sched_wait(const ALT_DMA_SCHED_JOB_t * job, uint32_t timeout_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -47,7 +47,6 @@ extern "C"
 {
 #endif  /* __cplusplus */
 
-#define ETH_RESET_DELAY           ((uint32_t)0x000FFFFF)
 #define NUMBER_OF_TX_DESCRIPTORS  32
 #define NUMBER_OF_RX_DESCRIPTORS  32
 #define ETH_BUFFER_SIZE           1536
@@ -417,13 +416,19 @@ typedef struct ALT_ETH_EMAC_INSTANCE_s
 } alt_eth_emac_instance_t;
 
 
+/* Delay in microseconds used during ethernet setup and reset. This keeps the
+ * time of the counted loop it replaced, 0xFFFFF iterations of a volatile
+ * decrement at -O0. At 6 to 10 cycles per iteration and 925 MHz that loop took
+ * 7 to 11 ms, and longer with the caches off. */
+#define ALT_ETH_RESET_DELAY_US  10000
+
 /******************************************************************************/
 /*!
- * A simple delay function which loops until the specified count is reached.
+ * A busy-wait delay timed on the global timer, see alt_mono.h.
  *
  *
  * \param       delay
- *              The number to count to.
+ *              The delay in microseconds.
  */
 void alt_eth_delay(volatile uint32_t delay);
 
@@ -252,6 +252,53 @@ ALT_STATUS_CODE alt_int_global_enable_all(void);
  */
 ALT_STATUS_CODE alt_int_global_disable_all(void);
 
+/*!
+ * Masks IRQ on the calling CPU and returns the previous CPSR, for short
+ * sections shared with interrupt handlers. Pass the result to
+ * alt_int_irq_restore() at the end of the section. Sections may nest.
+ * Does nothing in a host build.
+ *
+ * \returns    The CPSR before masking.
+ */
+static __inline uint32_t alt_int_irq_save(void)
+{
+#if defined(__arm__)
+    uint32_t cpsr;
+    __asm volatile("mrs %0, cpsr\n cpsid i" : "=r" (cpsr) : : "memory");
+    return cpsr;
+#else
+    return 0;
+#endif
+}
+
+/*!
+ * Waits for an interrupt (WFI). Called with IRQ masked by alt_int_irq_save()
+ * after checking the condition, a pending interrupt still wakes the CPU, so
+ * it cannot be missed between the check and the wait. Returns at once in a
+ * host build.
+ */
+static __inline void alt_int_wfi(void)
+{
+#if defined(__arm__)
+    __asm volatile("wfi" : : : "memory");
+#endif
+}
+
+/*!
+ * Restores the IRQ mask saved by alt_int_irq_save().
+ *
+ * \param       cpsr
+ *              The value returned by alt_int_irq_save().
+ */
+static __inline void alt_int_irq_restore(uint32_t cpsr)
+{
+#if defined(__arm__)
+    __asm volatile("msr cpsr_c, %0" : : "r" (cpsr) : "memory");
+#else
+    (void)cpsr;
+#endif
+}
+
 /*!
  * @}
  */
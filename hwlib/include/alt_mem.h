@@ -0,0 +1,85 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+/*
+ * Memory primitives for the HWLib driver paths, tuned for the Cortex-A9.
+ *
+ * alt_mem_copy(), alt_mem_set() and alt_mem_cmp() move 64 bytes per loop
+ * with NEON 128 bit loads and stores and prefetch ahead with PLD. Bytes are
+ * handled one by one up to an 8 byte aligned address (the head) and after
+ * the last whole block (the tail). Only aligned NEON accesses are made,
+ * because with the MMU off all memory is strongly ordered and does not
+ * allow unaligned accesses. So when the source and destination are
+ * misaligned to each other, or the size is below ALT_MEM_NEON_MIN, the
+ * newlib function is used instead. Without NEON (e.g. a host build) they
+ * are the newlib functions.
+ *
+ * alt_mem_fifo_read32() and alt_mem_fifo_write32() move words between
+ * memory and a peripheral FIFO data register at a fixed address, with the
+ * register accesses issued back to back in groups of four.
+ */
+
+#if !defined(ALT_MEM_H)
+#define ALT_MEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Smaller sizes go to the newlib functions, the NEON setup does not pay off */
+#if !defined(ALT_MEM_NEON_MIN)
+#define ALT_MEM_NEON_MIN (64)
+#endif
+
+/* PLD distance in bytes ahead of the current source address */
+#if !defined(ALT_MEM_PLD_AHEAD)
+#define ALT_MEM_PLD_AHEAD (192)
+#endif
+
+/* memcpy(), the areas must not overlap. Returns dst */
+void * alt_mem_copy(void * dst, const void * src, size_t size);
+
+/* memset(). Returns dst */
+void * alt_mem_set(void * dst, int value, size_t size);
+
+/* memcmp() */
+int alt_mem_cmp(const void * a, const void * b, size_t size);
+
+/* Read count words from the FIFO data register at address fifo into dst */
+void alt_mem_fifo_read32(uint32_t * dst, uintptr_t fifo, size_t count);
+
+/* Write count words from src to the FIFO data register at address fifo */
+void alt_mem_fifo_write32(uintptr_t fifo, const uint32_t * src, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALT_MEM_H */
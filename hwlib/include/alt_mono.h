@@ -0,0 +1,98 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+/*
+ * Monotonic clock on the Cortex-A9 64-bit global timer.
+ *
+ * Timestamps are global timer counts ("ticks"), which never wrap in
+ * practice. alt_mono_now_ns() and the other nanosecond helpers convert them
+ * with the multiply and shift factors of alt_timers.c, so they take a few
+ * multiplies and no division. The factors follow prescaler and clock
+ * configuration changes made through HWLib.
+ *
+ * Deadlines are absolute tick values. The busy-wait delays wait for at
+ * least the requested time: the conversion to ticks is rounded up and one
+ * tick is added for the partial tick at the start. The global timer is
+ * started by the first deadline or delay if nothing has started it yet.
+ *
+ * alt_mono_delay_cycles() waits a number of MPU clock cycles. On the
+ * Cyclone V and Arria V the global timer is clocked by mpu_periph_clk,
+ * which is mpu_clk divided by 4, so this holds while the clocks are being
+ * reconfigured or the main PLL is bypassed.
+ */
+
+#if !defined(ALT_MONO_H)
+#define ALT_MONO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* An absolute point in time in global timer ticks */
+typedef uint64_t alt_mono_deadline_t;
+
+/* Starts the global timer counter if it is not running */
+void alt_mono_init(void);
+
+/* Current time in global timer ticks */
+uint64_t alt_mono_now_ticks(void);
+
+/* Current time in MPU clock cycles */
+uint64_t alt_mono_now_cycles(void);
+
+/* Current time in nanoseconds */
+uint64_t alt_mono_now_ns(void);
+
+/* Converts ticks to nanoseconds, rounded down */
+uint64_t alt_mono_ticks_to_ns(uint64_t ticks);
+
+/* Converts nanoseconds to ticks, rounded up */
+uint64_t alt_mono_ns_to_ticks(uint64_t ns);
+
+/* Nanoseconds since start, a value from alt_mono_now_ticks() */
+uint64_t alt_mono_elapsed_ns(uint64_t start);
+
+/* The deadline ns or us from now */
+alt_mono_deadline_t alt_mono_deadline_ns(uint64_t ns);
+alt_mono_deadline_t alt_mono_deadline_us(uint32_t us);
+
+/* True once the deadline has passed */
+bool alt_mono_expired(alt_mono_deadline_t deadline);
+
+/* Busy-wait delays */
+void alt_mono_delay_ns(uint64_t ns);
+void alt_mono_delay_us(uint32_t us);
+void alt_mono_delay_cycles(uint32_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALT_MONO_H */
@@ -36,12 +36,39 @@
 #include <stdarg.h>
 #include <inttypes.h>
 
-typedef struct ALT_PRINTF_MEM_INFO_s
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Flush points of a buffered stream, besides a full buffer and alt_fflush() */
+typedef enum ALT_PRINTF_FLUSH_e
+{
+    ALT_PRINTF_FLUSH_CALL = 0,  /* at the end of each print or alt_fwrite call */
+    ALT_PRINTF_FLUSH_LINE,      /* after each newline */
+    ALT_PRINTF_FLUSH_FULL       /* no automatic flush */
+} ALT_PRINTF_FLUSH_t;
+
+/*
+ * Output stream, passed around as FILE *.
+ *
+ * alt_vfprintf() and alt_fwrite() collect the output in buf and hand it to
+ * write_function in runs, so a sink is called once per run instead of once
+ * per character. With size 0 the runs go to write_function directly.
+ *
+ * A stream without write_function gets one putc_function call per character
+ * instead. putc_function must always be set, it is also the single character
+ * entry point for other callers.
+ */
+typedef struct ALT_PRINTF_STREAM_s
 {
     void (*putc_function)(char pchar,FILE * info);
-    char *toptr;
-    char *maxptr;
-} ALT_PRINTF_MEM_INFO_t;
+    void (*write_function)(const char *buf, size_t len, FILE * info);
+    char *buf;
+    size_t size;
+    size_t len;
+    ALT_PRINTF_FLUSH_t flush;
+} ALT_PRINTF_STREAM_t;
 
 #ifndef DEFAULT_TERM
   #ifdef soc_a10
@@ -62,6 +89,47 @@ int alt_snprintf(char *to, size_t n, const char *format, ...);
 int alt_sprintf(char *to, const char *format, ...);
 int alt_fprintf(FILE *stream, const char *format, ...);
 int alt_vfprintf(FILE *stream, const char *format, va_list args);
+int alt_fflush(FILE *stream);
+size_t alt_fwrite(const void *ptr, size_t size, size_t count, FILE *stream);
+
+/*
+ * Pre-parsed format string, an array of operations ended by one with len
+ * and specifier both 0. Normally built at compile time by the C++ front end
+ * in alt_printf.hpp, see ALT_PRINTF_CT() below.
+ */
+#define ALT_PRINTF_OP_STAR (-1)  /* width or precision taken from the argument list */
+
+typedef struct ALT_PRINTF_OP_s
+{
+    uint16_t offset;     /* literal text: start in the format string */
+    uint16_t len;        /* literal text: count of characters, 0 for a conversion */
+    char specifier;      /* conversion: one of diuxXpsc */
+    char flag;           /* conversion: one of -+ #0, or 0 */
+    uint8_t length;      /* conversion: count of l modifiers */
+    uint8_t dot;         /* conversion: 1 if a precision was given */
+    int16_t width;       /* conversion: or ALT_PRINTF_OP_STAR */
+    int16_t precision;   /* conversion: or ALT_PRINTF_OP_STAR */
+} ALT_PRINTF_OP_t;
+
+int alt_fprintf_ops(FILE *stream, const char *format, const ALT_PRINTF_OP_t *ops, ...);
+int alt_vfprintf_ops(FILE *stream, const char *format, const ALT_PRINTF_OP_t *ops, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
+
+/*
+ * ALT_PRINTF_CT(format, ...) and ALT_FPRINTF_CT(stream, format, ...) print
+ * like ALT_PRINTF() and fprintf(). Built as C++ the format, which must be a
+ * string literal, is parsed at compile time and mismatched arguments fail
+ * the build, see alt_printf.hpp. Built as C they are the normal calls.
+ */
+#ifdef __cplusplus
+    #include "alt_printf.hpp"
+#else
+    #define ALT_PRINTF_CT(...) ALT_PRINTF(__VA_ARGS__)
+    #define ALT_FPRINTF_CT(...) fprintf(__VA_ARGS__)
+#endif
 
 #if defined (PRINTF_HOST) 
     #define ALT_PRINTF printf
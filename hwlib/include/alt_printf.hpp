@@ -0,0 +1,323 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+/*
+ * Compile time front end of alt_printf.c for C++14 and later, included by
+ * alt_printf.h. Use it through the macros:
+ *
+ *   ALT_PRINTF_CT("count %u of %s\n", n, name);
+ *   ALT_FPRINTF_CT(term1, "%08x\n", reg);
+ *
+ * The format must be a string literal. It is parsed at compile time into an
+ * ALT_PRINTF_OP_t list kept in read only data, so the run time only does
+ * the conversions (alt_vfprintf_ops()). The arguments are checked against
+ * the conversions with static_assert:
+ *   %d %i %u %x %X %c   integer or enum of up to 32 bits
+ *   %ll...              64 bit integer
+ *   %s                  char pointer
+ *   %p                  any pointer
+ *   * width/precision   integer of up to 32 bits
+ * Conversions which alt_printf.c does not support also fail the build.
+ */
+
+#if !defined(ALT_PRINTF_HPP)
+#define ALT_PRINTF_HPP
+
+#include <type_traits>
+
+namespace alt_printf_ct
+{
+
+enum arg_kind
+{
+    ARG_INT32,
+    ARG_INT64,
+    ARG_STR,
+    ARG_PTR,
+    ARG_OTHER
+};
+
+enum result
+{
+    OK = 0,
+    ERR_SPECIFIER,   /* not one of diuxXpsc, or more than two l */
+    ERR_TOO_FEW,     /* fewer arguments than conversions */
+    ERR_TOO_MANY,    /* more arguments than conversions */
+    ERR_TYPE         /* argument type does not match its conversion */
+};
+
+template <class T>
+constexpr arg_kind kind_of()
+{
+    typedef typename std::decay<T>::type U;
+    typedef typename std::remove_cv<typename std::remove_pointer<U>::type>::type P;
+
+    return (std::is_integral<U>::value || std::is_enum<U>::value) ?
+               ((sizeof(U) <= 4) ? ARG_INT32 : ((sizeof(U) == 8) ? ARG_INT64 : ARG_OTHER)) :
+           std::is_pointer<U>::value ?
+               (std::is_same<P, char>::value ? ARG_STR : ARG_PTR) :
+           ARG_OTHER;
+}
+
+constexpr bool is_flag(char c)
+{
+    return (c == '-') || (c == '+') || (c == ' ') || (c == '#') || (c == '0');
+}
+
+constexpr bool is_specifier(char c)
+{
+    return (c == 'd') || (c == 'i') || (c == 'u') || (c == 'x') || (c == 'X') ||
+           (c == 'p') || (c == 's') || (c == 'c');
+}
+
+/* Operation list with room for N operations, the last is the end marker */
+template <unsigned N>
+struct op_list
+{
+    ALT_PRINTF_OP_t op[N];
+    unsigned count;      /* operations before the end marker */
+    unsigned nargs;      /* arguments consumed */
+    result error;
+};
+
+/*
+ * Parses the format the same way as alt_vfprintf(). Literal text between
+ * conversions becomes one operation, "%%" becomes a one character literal.
+ * With N of 0 only the counts are worked out.
+ */
+template <unsigned N>
+constexpr op_list<(N > 0) ? N : 1> parse(const char *fmt)
+{
+    op_list<(N > 0) ? N : 1> r{};
+    unsigned i = 0;
+    unsigned start = 0;
+    ALT_PRINTF_OP_t op{};
+
+    while (fmt[i] != 0)
+    {
+        if (fmt[i] != '%' || fmt[i + 1] == '%')
+        {
+            /* Literal run up to the next conversion */
+            start = (fmt[i] == '%') ? i + 1 : i;
+            i = start + 1;
+            while ((fmt[i] != 0) && (fmt[i] != '%'))
+            {
+                i++;
+            }
+            op = ALT_PRINTF_OP_t{};
+            op.offset = (uint16_t)start;
+            op.len = (uint16_t)(i - start);
+        }
+        else
+        {
+            op = ALT_PRINTF_OP_t{};
+            i++;
+            if (is_flag(fmt[i]))
+            {
+                op.flag = fmt[i++];
+            }
+            if (fmt[i] == '*')
+            {
+                op.width = ALT_PRINTF_OP_STAR;
+                r.nargs++;
+                i++;
+            }
+            else
+            {
+                while ((fmt[i] >= '0') && (fmt[i] <= '9'))
+                {
+                    op.width = (int16_t)(op.width * 10 + (fmt[i++] - '0'));
+                }
+            }
+            if (fmt[i] == '.')
+            {
+                op.dot = 1;
+                i++;
+                if (fmt[i] == '*')
+                {
+                    op.precision = ALT_PRINTF_OP_STAR;
+                    r.nargs++;
+                    i++;
+                }
+                else
+                {
+                    while ((fmt[i] >= '0') && (fmt[i] <= '9'))
+                    {
+                        op.precision = (int16_t)(op.precision * 10 + (fmt[i++] - '0'));
+                    }
+                }
+            }
+            while (fmt[i] == 'l')
+            {
+                op.length++;
+                i++;
+            }
+            if (!is_specifier(fmt[i]) || (op.length > 2))
+            {
+                r.error = ERR_SPECIFIER;
+                return r;
+            }
+            op.specifier = fmt[i++];
+            r.nargs++;
+        }
+
+        if (r.count < N)
+        {
+            r.op[r.count] = op;
+        }
+        r.count++;
+    }
+
+    return r;
+}
+
+/* The argument kind each consumed argument must have, in order */
+template <unsigned N>
+constexpr result check(const op_list<N> &ops, const arg_kind *kinds, unsigned nkinds)
+{
+    unsigned a = 0;
+    unsigned i = 0;
+    char s = 0;
+
+    if (ops.error != OK)
+    {
+        return ops.error;
+    }
+    if (ops.nargs > nkinds)
+    {
+        return ERR_TOO_FEW;
+    }
+    if (ops.nargs < nkinds)
+    {
+        return ERR_TOO_MANY;
+    }
+
+    for (i = 0; i < ops.count; i++)
+    {
+        if (ops.op[i].len != 0)
+        {
+            continue;
+        }
+        if ((ops.op[i].width == ALT_PRINTF_OP_STAR) && (kinds[a++] != ARG_INT32))
+        {
+            return ERR_TYPE;
+        }
+        if ((ops.op[i].precision == ALT_PRINTF_OP_STAR) && (kinds[a++] != ARG_INT32))
+        {
+            return ERR_TYPE;
+        }
+        s = ops.op[i].specifier;
+        if (s == 's')
+        {
+            if (kinds[a] != ARG_STR) return ERR_TYPE;
+        }
+        else if (s == 'p')
+        {
+            if ((kinds[a] != ARG_STR) && (kinds[a] != ARG_PTR)) return ERR_TYPE;
+        }
+        else if ((ops.op[i].length == 2) && (s != 'c'))
+        {
+            if (kinds[a] != ARG_INT64) return ERR_TYPE;
+        }
+        else
+        {
+            if (kinds[a] != ARG_INT32) return ERR_TYPE;
+        }
+        a++;
+    }
+
+    return OK;
+}
+
+/* Holds the parsed list of format F in read only data, one per format */
+template <class F>
+struct compiled
+{
+    static constexpr op_list<1> size = parse<0>(F::get());
+    static constexpr op_list<size.count + 1> ops = parse<size.count + 1>(F::get());
+};
+
+template <class F>
+constexpr op_list<1> compiled<F>::size;
+
+template <class F>
+constexpr op_list<compiled<F>::size.count + 1> compiled<F>::ops;
+
+template <class F, class... Args>
+inline int fprintf(FILE *stream, F, Args... args)
+{
+    constexpr arg_kind kinds[] = { kind_of<Args>()..., ARG_OTHER };
+    constexpr result rc = check(compiled<F>::ops, kinds, sizeof...(Args));
+
+    static_assert(rc != ERR_SPECIFIER, "alt_printf: unsupported conversion in the format string");
+    static_assert(rc != ERR_TOO_FEW, "alt_printf: fewer arguments than the format string needs");
+    static_assert(rc != ERR_TOO_MANY, "alt_printf: more arguments than the format string needs");
+    static_assert(rc != ERR_TYPE, "alt_printf: argument type does not match its conversion");
+
+    return alt_fprintf_ops(stream, F::get(), compiled<F>::ops.op, args...);
+}
+
+/* Type check, then the C library printf, for PRINTF_HOST */
+template <class F, class... Args>
+inline int host_printf(F, Args... args)
+{
+    constexpr arg_kind kinds[] = { kind_of<Args>()..., ARG_OTHER };
+    constexpr result rc = check(compiled<F>::ops, kinds, sizeof...(Args));
+
+    static_assert(rc == OK, "alt_printf: the format string does not match its arguments");
+
+    return ::printf(F::get(), args...);
+}
+
+/* Type check only, for when ALT_PRINTF() is switched off */
+template <class F, class... Args>
+inline int null_printf(F, Args...)
+{
+    constexpr arg_kind kinds[] = { kind_of<Args>()..., ARG_OTHER };
+    constexpr result rc = check(compiled<F>::ops, kinds, sizeof...(Args));
+
+    static_assert(rc == OK, "alt_printf: the format string does not match its arguments");
+
+    return 0;
+}
+
+} /* namespace alt_printf_ct */
+
+/* A type carrying the string literal fmt, so it can be parsed in a constant expression */
+#define ALT_PRINTF_CT_FMT(fmt) \
+    ([] { struct alt_printf_fmt_s { static constexpr const char *get() { return fmt; } }; return alt_printf_fmt_s(); }())
+
+#define ALT_FPRINTF_CT(stream, fmt, ...) alt_printf_ct::fprintf((stream), ALT_PRINTF_CT_FMT(fmt), ##__VA_ARGS__)
+
+#if defined (PRINTF_HOST)
+    #define ALT_PRINTF_CT(fmt, ...) alt_printf_ct::host_printf(ALT_PRINTF_CT_FMT(fmt), ##__VA_ARGS__)
+#elif defined (PRINTF_UART)
+    #define ALT_PRINTF_CT(fmt, ...) ALT_FPRINTF_CT(DEFAULT_TERM, fmt, ##__VA_ARGS__)
+#else
+    #define ALT_PRINTF_CT(fmt, ...) alt_printf_ct::null_printf(ALT_PRINTF_CT_FMT(fmt), ##__VA_ARGS__)
+#endif
+
+#endif /* ALT_PRINTF_HPP */
@@ -0,0 +1,67 @@
+/******************************************************************************
+*
+* Copyright 2013-2017 Altera Corporation. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its contributors
+* may be used to endorse or promote products derived from this software without
+* specific prior written permission.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+******************************************************************************/
+
+/*
+ * Integer to ASCII conversion engines of alt_printf.c, kept apart from the
+ * formatter so they are built without the libc replacements and can be
+ * benchmarked against each other.
+ *
+ * All functions write the digits without leading zeros and without a
+ * terminating 0, and return the count of characters written. A value of 0
+ * converts to "0".
+ */
+
+#if !defined(ALT_PRINTF_NUM_H)
+#define ALT_PRINTF_NUM_H
+
+#include <stdint.h>
+
+/* Longest decimal and hexadecimal output, a 64 bit value */
+#define ALT_PRINTF_UTOA_MAX (20)
+#define ALT_PRINTF_XTOA_MAX (16)
+
+/* Repeated 64 bit % 10 and / 10, each a libgcc division call on the Cortex-A9 */
+int alt_printf_utoa_div(uint64_t val, char *stg);
+
+/* Double dabble over three 64 bit BCD words, no division (ALT_PRINTF_NO_DIVIDE) */
+int alt_printf_utoa_bcd(uint64_t val, char *stg);
+
+/* Reciprocal multiplication and a two digit table, 32 bit fast path (default) */
+int alt_printf_utoa_fast(uint64_t val, char *stg);
+
+/* Hexadecimal, one shift and compare per digit for all digits */
+int alt_printf_xtoa_loop(uint64_t val, char *stg, int digits, int upper);
+
+/* Hexadecimal, digit count found first then a table lookup per digit (default) */
+int alt_printf_xtoa_fast(uint64_t val, char *stg, int digits, int upper);
+
+#endif /* ALT_PRINTF_NUM_H */
@@ -67,6 +67,13 @@ extern "C"
  *     Each type has a somewhat different HW interface This API presents the same
  *     external interface for each.
  *
+ *     Times in seconds, milliseconds, microseconds and nanoseconds are
+ *     converted from timer counts with a multiply and shift per timer rather
+ *     than a division. The factors are refreshed when the prescaler or the
+ *     clock configuration (alt_clk_cfg_gen) changes. A converted time is never
+ *     more than the exact, truncated, value and is at most one unit less than
+ *     it for values below 2^31 units.
+ *
  * @{
  */
 
@@ -538,6 +545,42 @@ uint32_t alt_gpt_curtime_microsecs_get(ALT_GPT_TIMER_t tmr_id);
 uint32_t alt_gpt_curtime_nanosecs_get(ALT_GPT_TIMER_t tmr_id);
 
 
+/******************************************************************************/
+/*!
+ * Converts a number of counts of the specified timer, at its current prescaler
+ * setting, to nanoseconds. The result is rounded down and saturates at
+ * UINT64_MAX.
+ *
+ * \param       tmr_id
+ *              The timer identifier.
+ *
+ * \param       counts
+ *              The number of timer counts.
+ *
+ * \retval      uint64_t     The time in nanoseconds. Returns 0 if the timer
+ *                         clock frequency is unknown.
+ */
+uint64_t alt_gpt_counts_to_nanosecs(ALT_GPT_TIMER_t tmr_id, uint64_t counts);
+
+
+/******************************************************************************/
+/*!
+ * Converts nanoseconds to a number of counts of the specified timer, at its
+ * current prescaler setting. The result is rounded up, so that waiting for
+ * that many counts takes at least the given time.
+ *
+ * \param       tmr_id
+ *              The timer identifier.
+ *
+ * \param       nanoseconds
+ *              The time in nanoseconds.
+ *
+ * \retval      uint64_t     The number of timer counts. Returns 0 if the
+ *                         timer clock frequency is unknown.
+ */
+uint64_t alt_gpt_nanosecs_to_counts(ALT_GPT_TIMER_t tmr_id, uint64_t nanoseconds);
+
+
 /******************************************************************************/
 /*!
  * Returns the maximum available period of the specified
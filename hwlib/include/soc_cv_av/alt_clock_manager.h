@@ -1259,6 +1259,17 @@ ALT_STATUS_CODE alt_clk_divider_set(ALT_CLK_t clk,
 ALT_STATUS_CODE alt_clk_freq_get(ALT_CLK_t clk,
                                  alt_freq_t* freq);
 
+/******************************************************************************/
+/*!
+ * Clock configuration generation count. It is incremented by every function of
+ * this API that can change the frequency of a clock, so that values derived
+ * from clock frequencies and cached elsewhere, such as the timer count to time
+ * conversion factors of alt_timers.c, can tell when to recompute them.
+ * Software that changes the clock manager registers directly should increment
+ * it too.
+ */
+extern volatile uint32_t alt_clk_cfg_gen;
+
 /*! @} */
 
 /******************************************************************************/
@@ -123,13 +123,24 @@ extern "C"
  *  \param dest - Write destination pointer address
  *  \param src  - 32 bit data word to write to memory
  */
+#if defined(HOST_SIM)
+/* Host builds route word accesses to the device simulator, see host/host_sim.h */
+uint32_t host_sim_rd_word(uintptr_t addr);
+void host_sim_wr_word(uintptr_t addr, uint32_t value);
+#define alt_write_word(dest, src)       host_sim_wr_word(ALT_CAST(uintptr_t, (dest)), (src))
+#else
 #define alt_write_word(dest, src)       (*ALT_CAST(volatile uint32_t *, (dest)) = (src))
+#endif
 
 /*! Read and return the 32 bit word from the source address in device memory.
  *  \param src    Read source pointer address
  *  \returns      32 bit data word value
  */
+#if defined(HOST_SIM)
+#define alt_read_word(src)              host_sim_rd_word(ALT_CAST(uintptr_t, (src)))
+#else
 #define alt_read_word(src)              (*ALT_CAST(volatile uint32_t *, (src)))
+#endif
 
 /*! Write the 64 bit double word to the destination address in device memory.
  *  \param dest - Write destination pointer address
@@ -34,12 +34,20 @@
  * $Id: //acds/rel/20.1/embedded/ip/hps/altera_hps/hwlib/src/hwmgr/alt_16550_uart.c#1 $
  */
 
+#include <string.h>
 #include "alt_16550_uart.h"
 #include "alt_clock_manager.h"
+#include "alt_interrupt.h"
+#if ALT_16550_PROVISION_DMA_SUPPORT
+#include "alt_cache.h"
+#endif
 #include "socal/alt_rstmgr.h"
 #include "socal/alt_uart.h"
 #include "socal/hps.h"
 #include "socal/socal.h"
+#if defined(HOST_SIM)
+#include "host_sim.h"
+#endif
 
 #define DEFAULT_BAUD ALT_16550_BAUDRATE_115200
 
@@ -190,8 +198,12 @@ ALT_STATUS_CODE alt_16550_init(ALT_16550_DEVICE_t device,
                                ALT_16550_HANDLE_t * handle)
 {
     handle->device = device;
-    handle->data   = 0;
-    handle->fcr    = 0;
+    handle->data    = 0;
+    handle->fcr     = 0;
+    handle->tx_fifo_size = 0;
+    handle->tx_ring = NULL;
+    handle->rx_ring = NULL;
+    handle->tx_dma  = NULL;
 
     switch (device)
     {
@@ -376,6 +388,9 @@ ALT_STATUS_CODE alt_16550_fifo_enable(ALT_16550_HANDLE_t * handle)
         /* Set FCR::FIFOE (FIFO Control Register :: FIFO Enable) bit. */
         handle->fcr |= ALT_UART_FCR_FIFOE_SET_MSK | ALT_UART_FCR_RFIFOR_SET_MSK | ALT_UART_FCR_XFIFOR_SET_MSK;
         alt_write_word(ALT_UART_FCR_ADDR(handle->location), handle->fcr);
+
+        /* Cache the TX FIFO size so the write paths need not query CPR. */
+        alt_16550_fifo_size_get_tx(handle, &handle->tx_fifo_size);
         break;
     default:
         return ALT_E_ERROR;
@@ -439,12 +454,15 @@ ALT_STATUS_CODE alt_16550_fifo_read(ALT_16550_HANDLE_t * handle,
     return ALT_E_SUCCESS;
 }
 
+static uint32_t alt_16550_fifo_space_tx_helper(ALT_16550_HANDLE_t * handle);
+
 ALT_STATUS_CODE alt_16550_fifo_write_safe(ALT_16550_HANDLE_t * handle,
                                      const char * buffer,
                                      size_t count,
                                      bool safe)
 {
     size_t i;
+    uint32_t space;
     /* Verify that the UART is enabled */
     if (!(handle->data & ALT_16550_HANDLE_DATA_UART_ENABLED_MSK))
     {
@@ -461,6 +479,26 @@ ALT_STATUS_CODE alt_16550_fifo_write_safe(ALT_16550_HANDLE_t * handle,
     {
     case ALT_16550_DEVICE_SOCFPGA_UART0:
     case ALT_16550_DEVICE_SOCFPGA_UART1:
+        if (safe)
+        {
+            /* Write the buffer into the THR (Transmit Holding Register) in */
+            /* bursts, one TFL (Transmit FIFO Level) read per burst. */
+            i = 0;
+            while (i < count)
+            {
+                space = alt_16550_fifo_space_tx_helper(handle);
+                if (space > count - i)
+                {
+                    space = count - i;
+                }
+                while (space-- != 0)
+                {
+                    alt_write_word(ALT_UART_RBR_THR_DLL_ADDR(handle->location), buffer[i++]);
+                }
+            }
+            break;
+        }
+        /* Fall through */
     case ALT_16550_DEVICE_ALTERA_16550_UART:
         /* Write the buffer into the THR (Transmit Holding Register) */
         for (i = 0; i < count; ++i)
@@ -485,6 +523,64 @@ ALT_STATUS_CODE alt_16550_fifo_write(ALT_16550_HANDLE_t * handle,
     return alt_16550_fifo_write_safe(handle, buffer, count, false);
 }
 
+ALT_STATUS_CODE alt_16550_fifo_writev(ALT_16550_HANDLE_t * handle,
+                                      const ALT_16550_IOVEC_t * iov,
+                                      size_t iovcnt,
+                                      bool safe)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    uint32_t space = 0;
+    size_t i;
+
+    /* Verify that the UART is enabled */
+    if (!(handle->data & ALT_16550_HANDLE_DATA_UART_ENABLED_MSK))
+    {
+        return ALT_E_ERROR;
+    }
+
+    /* Verify that the FIFO is enabled */
+    if (!(handle->fcr & ALT_UART_FCR_FIFOE_SET_MSK))
+    {
+        return ALT_E_ERROR;
+    }
+
+    switch (handle->device)
+    {
+    case ALT_16550_DEVICE_SOCFPGA_UART0:
+    case ALT_16550_DEVICE_SOCFPGA_UART1:
+        if (safe)
+        {
+            /* Stream the segments through the THR (Transmit Holding Register) */
+            /* in bursts. The free space carries over between segments so a */
+            /* short segment does not cost an extra TFL read. */
+            for (; iovcnt != 0; ++iov, --iovcnt)
+            {
+                for (i = 0; i < iov->count; ++i)
+                {
+                    while (space == 0)
+                    {
+                        space = alt_16550_fifo_space_tx_helper(handle);
+                    }
+                    alt_write_word(ALT_UART_RBR_THR_DLL_ADDR(handle->location), iov->buffer[i]);
+                    --space;
+                }
+            }
+            break;
+        }
+        /* Fall through */
+    case ALT_16550_DEVICE_ALTERA_16550_UART:
+        for (; (iovcnt != 0) && (status == ALT_E_SUCCESS); ++iov, --iovcnt)
+        {
+            status = alt_16550_fifo_write_safe(handle, iov->buffer, iov->count, safe);
+        }
+        break;
+    default:
+        return ALT_E_ERROR;
+    }
+
+    return status;
+}
+
 ALT_STATUS_CODE alt_16550_fifo_clear_rx(ALT_16550_HANDLE_t * handle)
 {
     /* Verify that the FIFO is enabled */
@@ -1211,3 +1307,837 @@ ALT_STATUS_CODE alt_16550_modem_status_get(ALT_16550_HANDLE_t * handle,
 
     return ALT_E_SUCCESS;
 }
+
+/*
+// Memory barrier between the ring buffer producer and consumer. The ring
+// buffer indices must only be published after the data they cover.
+*/
+static __inline void alt_16550_ring_barrier_helper(void)
+{
+#if   defined(__ARMCOMPILER_VERSION)
+    __asm volatile("dmb" : : : "memory");
+#elif defined(__ARMCC_VERSION)
+    __dmb(0xf);
+#else
+    __sync_synchronize();
+#endif
+}
+
+/*
+// Body of loops which spin waiting on the interrupt handler. In a host build
+// (see host/host_sim.h) simulated time only passes on register accesses, so
+// let it run to the next event instead.
+*/
+static __inline void alt_16550_spin_helper(void)
+{
+#if defined(HOST_SIM)
+    host_sim_wfi();
+#endif
+}
+
+/*
+// Helper function which returns the number of characters which can be written
+// to the transmitter without overflowing it.
+*/
+static uint32_t alt_16550_fifo_space_tx_helper(ALT_16550_HANDLE_t * handle)
+{
+    uint32_t size = handle->tx_fifo_size;
+    uint32_t level;
+
+    /* Without FIFOs only the THR (Transmit Holding Register) is available, */
+    /* and only once LSR::THRE (Line Status :: THR Empty) says so. */
+    if (!(handle->fcr & ALT_UART_FCR_FIFOE_SET_MSK) || (size == 0))
+    {
+        return ALT_UART_LSR_THRE_GET(alt_read_word(ALT_UART_LSR_ADDR(handle->location))) ? 1 : 0;
+    }
+
+    switch (handle->device)
+    {
+    case ALT_16550_DEVICE_SOCFPGA_UART0:
+    case ALT_16550_DEVICE_SOCFPGA_UART1:
+        /* Read TFL (Transmit FIFO Level). */
+        level = alt_read_word(ALT_UART_TFL_ADDR(handle->location));
+        break;
+    case ALT_16550_DEVICE_ALTERA_16550_UART:
+    default:
+        /* TFL not implemented. The TX interrupt fires when the level is at or */
+        /* below the FCR::TET (FIFO Control Register :: Transmit Empty Trigger). */
+        switch (ALT_UART_FCR_TET_GET(handle->fcr))
+        {
+        case ALT_16550_FIFO_TRIGGER_TX_ALMOST_EMPTY:
+            level = 2;
+            break;
+        case ALT_16550_FIFO_TRIGGER_TX_QUARTER_FULL:
+            level = size >> 2;
+            break;
+        case ALT_16550_FIFO_TRIGGER_TX_HALF_FULL:
+            level = size >> 1;
+            break;
+        case ALT_16550_FIFO_TRIGGER_TX_EMPTY:
+        default:
+            level = 0;
+            break;
+        }
+        break;
+    }
+
+    return (level < size) ? (size - level) : 0;
+}
+
+/*
+// Helper function which moves queued characters from the transmit ring buffer
+// into the transmitter. Called from the interrupt handler only.
+*/
+static void alt_16550_tx_async_refill_helper(ALT_16550_HANDLE_t * handle)
+{
+    ALT_16550_RING_t * ring = handle->tx_ring;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t space;
+
+    if (ring == NULL)
+    {
+        alt_16550_int_disable_tx(handle);
+        return;
+    }
+
+    mask  = ring->size - 1;
+    head  = ring->head;
+    tail  = ring->tail;
+    alt_16550_ring_barrier_helper();
+
+    /* Write a burst of characters, bounded by the free space in the FIFO. */
+    space = alt_16550_fifo_space_tx_helper(handle);
+    while ((space != 0) && (tail != head))
+    {
+        alt_write_word(ALT_UART_RBR_THR_DLL_ADDR(handle->location), ring->buffer[tail & mask]);
+        ++tail;
+        --space;
+    }
+
+    alt_16550_ring_barrier_helper();
+    ring->tail = tail;
+
+    if (tail == head)
+    {
+        /* Drained. Disable the TX interrupt, then check again in case the */
+        /* producer queued more data after the head was sampled. */
+        alt_16550_int_disable_tx(handle);
+        alt_16550_ring_barrier_helper();
+        if (ring->head != tail)
+        {
+            alt_16550_int_enable_tx(handle);
+        }
+    }
+}
+
+/*
+// Helper function which moves received characters from the receiver into the
+// receive ring buffer. Called from the interrupt handler only.
+*/
+static void alt_16550_rx_async_drain_helper(ALT_16550_HANDLE_t * handle)
+{
+    ALT_16550_RING_t * ring = handle->rx_ring;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t level;
+    char item;
+
+    if (ring == NULL)
+    {
+        alt_16550_int_disable_rx(handle);
+        return;
+    }
+
+    mask = ring->size - 1;
+    head = ring->head;
+    tail = ring->tail;
+
+    for (;;)
+    {
+        switch (handle->device)
+        {
+        case ALT_16550_DEVICE_SOCFPGA_UART0:
+        case ALT_16550_DEVICE_SOCFPGA_UART1:
+            /* Read RFL (Receive FIFO Level) once per burst. */
+            level = (handle->fcr & ALT_UART_FCR_FIFOE_SET_MSK) ?
+                    alt_read_word(ALT_UART_RFL_ADDR(handle->location)) : 0;
+            if (level == 0)
+            {
+                level = ALT_UART_LSR_DR_GET(alt_read_word(ALT_UART_LSR_ADDR(handle->location)));
+            }
+            break;
+        case ALT_16550_DEVICE_ALTERA_16550_UART:
+        default:
+            /* RFL not implemented. Poll LSR::DR (Line Status Register :: Data Ready). */
+            level = ALT_UART_LSR_DR_GET(alt_read_word(ALT_UART_LSR_ADDR(handle->location)));
+            break;
+        }
+
+        if (level == 0)
+        {
+            break;
+        }
+
+        while (level-- != 0)
+        {
+            /* Reading the RBR (Receive Buffer Register) is what clears the */
+            /* interrupt, so always read it even when the ring buffer is full. */
+            item = ALT_UART_RBR_THR_DLL_VALUE_GET(alt_read_word(ALT_UART_RBR_THR_DLL_ADDR(handle->location)));
+
+            if (head - tail == ring->size)
+            {
+                tail = ring->tail;
+                if (head - tail == ring->size)
+                {
+                    ++ring->dropped;
+                    continue;
+                }
+            }
+
+            ring->buffer[head & mask] = item;
+            ++head;
+
+            if (head - tail > ring->high_water)
+            {
+                ring->high_water = head - tail;
+            }
+        }
+    }
+
+    /* Publish the new data to the reader. */
+    alt_16550_ring_barrier_helper();
+    ring->head = head;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_init(ALT_16550_HANDLE_t * handle,
+                                        ALT_16550_RING_t * ring,
+                                        char * buffer,
+                                        uint32_t size)
+{
+    /* The size must be a power of 2 so the indices can be masked. */
+    if ((ring == NULL) || (buffer == NULL) || (size < 2) || (size & (size - 1)))
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    alt_16550_int_disable_tx(handle);
+
+    ring->buffer     = buffer;
+    ring->size       = size;
+    ring->head       = 0;
+    ring->tail       = 0;
+    ring->high_water = 0;
+    ring->dropped    = 0;
+    ring->errors     = 0;
+
+    alt_16550_ring_barrier_helper();
+    handle->tx_ring = ring;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_uninit(ALT_16550_HANDLE_t * handle)
+{
+    ALT_STATUS_CODE status = alt_16550_int_disable_tx(handle);
+
+    handle->tx_ring = NULL;
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_write(ALT_16550_HANDLE_t * handle,
+                                         const char * buffer,
+                                         size_t count,
+                                         bool safe)
+{
+    ALT_16550_IOVEC_t iov;
+
+    iov.buffer = buffer;
+    iov.count  = count;
+
+    return alt_16550_tx_async_writev(handle, &iov, 1, safe);
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_writev(ALT_16550_HANDLE_t * handle,
+                                          const ALT_16550_IOVEC_t * iov,
+                                          size_t iovcnt,
+                                          bool safe)
+{
+    ALT_16550_RING_t * ring = handle->tx_ring;
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    const char * buffer;
+    size_t count;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t level;
+
+    /* Verify that the UART is enabled and a ring buffer is attached */
+    if (!(handle->data & ALT_16550_HANDLE_DATA_UART_ENABLED_MSK) || (ring == NULL))
+    {
+        return ALT_E_ERROR;
+    }
+
+    mask = ring->size - 1;
+    head = ring->head;
+
+    for (; iovcnt != 0; ++iov, --iovcnt)
+    {
+        buffer = iov->buffer;
+        count  = iov->count;
+
+        if (status != ALT_E_SUCCESS)
+        {
+            /* The ring buffer overflowed on an earlier segment. */
+            ring->dropped += count;
+            continue;
+        }
+
+        while (count != 0)
+        {
+            level = head - ring->tail;
+            if (level == ring->size)
+            {
+                if (!safe)
+                {
+                    ring->dropped += count;
+                    status = ALT_E_BUF_OVF;
+                    break;
+                }
+
+                /* Publish what is queued so far and spin waiting for space. */
+                alt_16550_ring_barrier_helper();
+                ring->head = head;
+                alt_16550_int_enable_tx(handle);
+                continue;
+            }
+
+            ring->buffer[head & mask] = *buffer++;
+            ++head;
+            --count;
+
+            if (level + 1 > ring->high_water)
+            {
+                ring->high_water = level + 1;
+            }
+        }
+    }
+
+    /* Publish the new data to the interrupt handler and kick the transmitter. */
+    alt_16550_ring_barrier_helper();
+    ring->head = head;
+
+    alt_16550_int_enable_tx(handle);
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_flush(ALT_16550_HANDLE_t * handle)
+{
+    ALT_16550_RING_t * ring = handle->tx_ring;
+    uint32_t line_status;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    while (ring->tail != ring->head)
+    {
+        /* Spin waiting for the interrupt handler to drain the ring buffer */
+        alt_16550_spin_helper();
+    }
+
+    do
+    {
+        if (alt_16550_line_status_get(handle, &line_status) != ALT_E_SUCCESS)
+        {
+            return ALT_E_ERROR;
+        }
+    } while ((line_status & ALT_16550_LINE_STATUS_TEMT) == 0);
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_stats_get(ALT_16550_HANDLE_t * handle,
+                                             ALT_16550_RING_STATS_t * stats)
+{
+    ALT_16550_RING_t * ring = handle->tx_ring;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    stats->size       = ring->size;
+    stats->level      = ring->head - ring->tail;
+    stats->high_water = ring->high_water;
+    stats->dropped    = ring->dropped;
+    stats->errors     = ring->errors;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_tx_async_stats_reset(ALT_16550_HANDLE_t * handle)
+{
+    ALT_16550_RING_t * ring = handle->tx_ring;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    ring->high_water = ring->head - ring->tail;
+    ring->dropped    = 0;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_rx_async_init(ALT_16550_HANDLE_t * handle,
+                                        ALT_16550_RING_t * ring,
+                                        char * buffer,
+                                        uint32_t size)
+{
+    ALT_STATUS_CODE status;
+
+    /* The size must be a power of 2 so the indices can be masked. */
+    if ((ring == NULL) || (buffer == NULL) || (size < 2) || (size & (size - 1)))
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    alt_16550_int_disable_rx(handle);
+
+    ring->buffer     = buffer;
+    ring->size       = size;
+    ring->head       = 0;
+    ring->tail       = 0;
+    ring->high_water = 0;
+    ring->dropped    = 0;
+    ring->errors     = 0;
+
+    alt_16550_ring_barrier_helper();
+    handle->rx_ring = ring;
+
+    /* RX data and RX timeout interrupts share IER::ERBFI. Line status */
+    /* interrupts are enabled so receive errors are counted and cleared. */
+    status = alt_16550_int_enable_line(handle);
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_16550_int_enable_rx(handle);
+    }
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_rx_async_uninit(ALT_16550_HANDLE_t * handle)
+{
+    ALT_STATUS_CODE status = alt_16550_int_disable_rx(handle);
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_16550_int_disable_line(handle);
+    }
+
+    handle->rx_ring = NULL;
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_rx_async_read(ALT_16550_HANDLE_t * handle,
+                                        char * buffer,
+                                        size_t count,
+                                        size_t * read_count)
+{
+    ALT_16550_RING_t * ring = handle->rx_ring;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+    size_t i = 0;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    mask = ring->size - 1;
+    head = ring->head;
+    tail = ring->tail;
+    alt_16550_ring_barrier_helper();
+
+    while ((i < count) && (tail != head))
+    {
+        buffer[i++] = ring->buffer[tail & mask];
+        ++tail;
+    }
+
+    /* Release the space back to the interrupt handler. */
+    alt_16550_ring_barrier_helper();
+    ring->tail = tail;
+
+    *read_count = i;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_rx_async_stats_get(ALT_16550_HANDLE_t * handle,
+                                             ALT_16550_RING_STATS_t * stats)
+{
+    ALT_16550_RING_t * ring = handle->rx_ring;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    stats->size       = ring->size;
+    stats->level      = ring->head - ring->tail;
+    stats->high_water = ring->high_water;
+    stats->dropped    = ring->dropped;
+    stats->errors     = ring->errors;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_rx_async_stats_reset(ALT_16550_HANDLE_t * handle)
+{
+    ALT_16550_RING_t * ring = handle->rx_ring;
+
+    if (ring == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    ring->high_water = ring->head - ring->tail;
+    ring->dropped    = 0;
+    ring->errors     = 0;
+
+    return ALT_E_SUCCESS;
+}
+
+void alt_16550_async_isr(uint32_t icciar, void * context)
+{
+    ALT_16550_HANDLE_t * handle = (ALT_16550_HANDLE_t *) context;
+    ALT_16550_INT_STATUS_t status;
+
+    (void) icciar;
+
+    /* Service every pending condition, highest priority first. */
+    while (alt_16550_int_status_get(handle, &status) == ALT_E_SUCCESS)
+    {
+        switch (status)
+        {
+        case ALT_16550_INT_STATUS_RX_DATA:
+        case ALT_16550_INT_STATUS_RX_TIMEOUT:
+            alt_16550_rx_async_drain_helper(handle);
+            break;
+        case ALT_16550_INT_STATUS_TX_IDLE:
+            alt_16550_tx_async_refill_helper(handle);
+            break;
+        case ALT_16550_INT_STATUS_LINE:
+            /* Cleared by reading the LSR (Line Status Register). */
+            if ((alt_read_word(ALT_UART_LSR_ADDR(handle->location)) &
+                 (ALT_16550_LINE_STATUS_OE | ALT_16550_LINE_STATUS_PE |
+                  ALT_16550_LINE_STATUS_FE | ALT_16550_LINE_STATUS_BI)) && (handle->rx_ring != NULL))
+            {
+                ++handle->rx_ring->errors;
+            }
+            break;
+        case ALT_16550_INT_STATUS_MODEM:
+            /* Cleared by reading the MSR (Modem Status Register). */
+            alt_read_word_helper(ALT_UART_MSR_ADDR(handle->location));
+            break;
+        case ALT_16550_INT_STATUS_NONE:
+            return;
+        default:
+            /* Busy detect indication. Cleared by reading the USR (UART Status Register). */
+            alt_read_word_helper(ALT_UART_USR_ADDR(handle->location));
+            break;
+        }
+    }
+}
+
+ALT_STATUS_CODE alt_16550_async_int_register(ALT_16550_HANDLE_t * handle)
+{
+    ALT_INT_INTERRUPT_t int_id;
+    ALT_STATUS_CODE status;
+
+    switch (handle->device)
+    {
+    case ALT_16550_DEVICE_SOCFPGA_UART0:
+        int_id = ALT_INT_INTERRUPT_UART0;
+        break;
+    case ALT_16550_DEVICE_SOCFPGA_UART1:
+        int_id = ALT_INT_INTERRUPT_UART1;
+        break;
+    default:
+        return ALT_E_BAD_ARG;
+    }
+
+    status = alt_int_isr_register(int_id, alt_16550_async_isr, handle);
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_int_dist_target_set(int_id, 0x1); /* CPU0 */
+    }
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_int_dist_enable(int_id);
+    }
+
+    return status;
+}
+
+#if ALT_16550_PROVISION_DMA_SUPPORT
+
+/*
+// Helper function which waits for the DMA transfer in flight, if any, to
+// complete. A faulted channel is killed and reported as an error.
+*/
+static ALT_STATUS_CODE alt_16550_dma_wait_helper(ALT_16550_DMA_t * dma)
+{
+    ALT_DMA_CHANNEL_STATE_t state;
+    ALT_STATUS_CODE status;
+
+    while (dma->busy)
+    {
+        status = alt_dma_channel_state_get(dma->channel, &state);
+        if (status != ALT_E_SUCCESS)
+        {
+            return status;
+        }
+
+        switch (state)
+        {
+        case ALT_DMA_CHANNEL_STATE_STOPPED:
+            dma->busy = false;
+            break;
+        case ALT_DMA_CHANNEL_STATE_FAULTING:
+        case ALT_DMA_CHANNEL_STATE_FAULTING_COMPLETING:
+            alt_dma_channel_kill(dma->channel);
+            dma->busy = false;
+            return ALT_E_ERROR;
+        default:
+            break; /* Spin waiting for the transfer to complete */
+        }
+    }
+
+    return ALT_E_SUCCESS;
+}
+
+/*
+// Clears the busy flag if the last transfer has stopped, without waiting.
+// Faults are left for alt_16550_dma_wait_helper() to report.
+*/
+static void alt_16550_dma_poll_helper(ALT_16550_DMA_t * dma)
+{
+    ALT_DMA_CHANNEL_STATE_t state;
+
+    if (dma->busy
+        && (alt_dma_channel_state_get(dma->channel, &state) == ALT_E_SUCCESS)
+        && (state == ALT_DMA_CHANNEL_STATE_STOPPED))
+    {
+        dma->busy = false;
+    }
+}
+
+ALT_STATUS_CODE alt_16550_dma_tx_init(ALT_16550_HANDLE_t * handle,
+                                      ALT_16550_DMA_t * dma,
+                                      ALT_DMA_CHANNEL_t channel,
+                                      char * buffer,
+                                      uint32_t size,
+                                      uint32_t threshold)
+{
+    uint32_t half = size >> 1;
+
+    switch (handle->device)
+    {
+    case ALT_16550_DEVICE_SOCFPGA_UART0:
+        dma->periph = ALT_DMA_PERIPH_UART0_TX;
+        break;
+    case ALT_16550_DEVICE_SOCFPGA_UART1:
+        dma->periph = ALT_DMA_PERIPH_UART1_TX;
+        break;
+    default:
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Each half is cleaned from the cache independently, so both must be */
+    /* cache line aligned. */
+    if ((buffer == NULL) || (half == 0) ||
+        ((uintptr_t)buffer & (ALT_CACHE_LINE_SIZE - 1)) ||
+        (half & (ALT_CACHE_LINE_SIZE - 1)))
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    dma->channel     = channel;
+    dma->buffer[0]   = buffer;
+    dma->buffer[1]   = buffer + half;
+    dma->buffer_size = half;
+    dma->threshold   = threshold;
+    dma->fill        = 0;
+    dma->busy        = false;
+
+    /* Set FCR::DMAM (FIFO Control Register :: DMA Mode) to multiple transfer */
+    /* mode so the DMA request stays asserted until the FIFO is full. The */
+    /* FIFO reset bits are not written back so pending data is kept. */
+    handle->fcr |= ALT_UART_FCR_DMAM_SET_MSK;
+    alt_write_word(ALT_UART_FCR_ADDR(handle->location),
+                   handle->fcr & ~(ALT_UART_FCR_RFIFOR_SET_MSK | ALT_UART_FCR_XFIFOR_SET_MSK));
+
+    handle->tx_dma = dma;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_16550_dma_tx_uninit(ALT_16550_HANDLE_t * handle)
+{
+    ALT_STATUS_CODE status;
+
+    if (handle->tx_dma == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    status = alt_16550_dma_wait_helper(handle->tx_dma);
+
+    handle->fcr &= ~ALT_UART_FCR_DMAM_SET_MSK;
+    alt_write_word(ALT_UART_FCR_ADDR(handle->location),
+                   handle->fcr & ~(ALT_UART_FCR_RFIFOR_SET_MSK | ALT_UART_FCR_XFIFOR_SET_MSK));
+
+    handle->tx_dma = NULL;
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_dma_write(ALT_16550_HANDLE_t * handle,
+                                    const char * buffer,
+                                    size_t count)
+{
+    ALT_16550_IOVEC_t iov;
+
+    iov.buffer = buffer;
+    iov.count  = count;
+
+    return alt_16550_dma_writev(handle, &iov, 1);
+}
+
+ALT_STATUS_CODE alt_16550_dma_writev(ALT_16550_HANDLE_t * handle,
+                                     const ALT_16550_IOVEC_t * iov,
+                                     size_t iovcnt)
+{
+    ALT_16550_DMA_t * dma = handle->tx_dma;
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    const char * buffer = NULL;
+    size_t count = 0;
+    size_t total = 0;
+    uint32_t chunk;
+    uint32_t fill;
+    size_t i;
+    char * stage;
+
+    if (dma == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    for (i = 0; i < iovcnt; ++i)
+    {
+        total += iov[i].count;
+    }
+
+    /* Short writes are cheaper with the CPU, but only when that cannot */
+    /* overtake data still queued in the DMA. */
+    alt_16550_dma_poll_helper(dma);
+    if ((total < dma->threshold) && !dma->busy)
+    {
+        return alt_16550_fifo_writev(handle, iov, iovcnt, true);
+    }
+
+    while ((total != 0) && (status == ALT_E_SUCCESS))
+    {
+        stage = dma->buffer[dma->fill];
+        chunk = (total < dma->buffer_size) ? (uint32_t)total : dma->buffer_size;
+
+        /* Gather the next chunk from the segments while the previous one is */
+        /* on the wire. */
+        for (fill = 0; fill < chunk; )
+        {
+            uint32_t n;
+
+            while (count == 0)
+            {
+                buffer = iov->buffer;
+                count  = iov->count;
+                ++iov;
+            }
+
+            n = chunk - fill;
+            if (n > count)
+            {
+                n = (uint32_t)count;
+            }
+
+            memcpy(stage + fill, buffer, n);
+            fill   += n;
+            buffer += n;
+            count  -= n;
+        }
+
+        status = alt_cache_system_clean(stage, (chunk + ALT_CACHE_LINE_SIZE - 1) & ~(ALT_CACHE_LINE_SIZE - 1));
+
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_16550_dma_wait_helper(dma);
+        }
+
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_dma_memory_to_periph(dma->channel,
+                                              &dma->program[dma->fill],
+                                              dma->periph,
+                                              stage,
+                                              chunk,
+                                              handle,
+                                              false,
+                                              ALT_DMA_EVENT_0);
+        }
+
+        if (status == ALT_E_SUCCESS)
+        {
+            dma->busy = true;
+            dma->fill ^= 1;
+            total -= chunk;
+        }
+    }
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_16550_dma_flush(ALT_16550_HANDLE_t * handle)
+{
+    ALT_STATUS_CODE status;
+    uint32_t line_status;
+
+    if (handle->tx_dma == NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    status = alt_16550_dma_wait_helper(handle->tx_dma);
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    do
+    {
+        status = alt_16550_line_status_get(handle, &line_status);
+    } while ((status == ALT_E_SUCCESS) && ((line_status & ALT_16550_LINE_STATUS_TEMT) == 0));
+
+    return status;
+}
+
+#endif /* ALT_16550_PROVISION_DMA_SUPPORT */
@@ -71,6 +71,10 @@
 
 #ifdef DEBUG_ALT_DMA
   #define dprintf  printf
+#elif defined(TRU_LOG_HWLIB)
+  /* Route the debug prints to the tru_logger trace level, see tru_logger.h */
+  #include "tru_logger.h"
+  #define dprintf(...) TRU_LOG_TRACE(DMA, __VA_ARGS__)
 #else
   #define dprintf  null_printf
 #endif
@@ -647,6 +651,69 @@ ALT_STATUS_CODE alt_dma_channel_free(ALT_DMA_CHANNEL_t channel)
     return ALT_E_SUCCESS;
 }
 
+/*
+ * Cleans the assembled program to RAM and gets the PA of the program buffer.
+ * */
+static ALT_STATUS_CODE alt_dma_program_sync(ALT_DMA_PROGRAM_t * pgm, uintptr_t * pgmpa)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+
+    /* Sync the DMA program to RAM. */
+
+    if (status == ALT_E_SUCCESS)
+    {
+        void * vaddr  = (void *)((uintptr_t)(pgm->program + pgm->buffer_start) & ~(ALT_CACHE_LINE_SIZE - 1));
+        void * vend   = (void *)(((uintptr_t)(pgm->program + pgm->buffer_start + pgm->code_size) + (ALT_CACHE_LINE_SIZE - 1)) & ~(ALT_CACHE_LINE_SIZE - 1));
+        size_t length = (uintptr_t)vend - (uintptr_t)vaddr;
+
+        status = alt_cache_system_clean(vaddr, length);
+    }
+
+    /*
+     * Get the PA of the program buffer.
+     * */
+
+    if (status == ALT_E_SUCCESS)
+    {
+        uint32_t dfsr;
+        uint32_t seglength;
+        *pgmpa = alt_mmu_va_to_pa(pgm->program + pgm->buffer_start, &seglength, &dfsr);
+        if (dfsr)
+        {
+            dprintf("DMA[exec]: ERROR: Cannot get VA-to-PA of pgm->program + pgm->buffer_start= %p.\n", pgm->program + pgm->buffer_start);
+            status = ALT_E_ERROR;
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Starts the program at the given PA on the channel.
+ * */
+static void alt_dma_channel_go(ALT_DMA_CHANNEL_t channel, uintptr_t pgmpa)
+{
+    /* Configure DBGINST0 and DBGINST1 to execute DMAGO targetting the requested channel. */
+
+    /* For information on APB Interface, see PL330, section 2.5.1.
+     * For information on DBGINSTx, see PL330, section 3.3.20 - 3.3.21.
+     * For information on DMAGO, see PL330, section 4.3.5. */
+
+    dprintf("DMA[exec]: program = 0x%x (PA).\n", pgmpa);
+
+    alt_write_word(ALT_DMA_DBGINST0_ADDR(ALT_DMASECURE_ADDR),
+                   ALT_DMA_DBGINST0_INSTRUCTIONBYTE0_SET(0xa0) |
+                   ALT_DMA_DBGINST0_INSTRUCTIONBYTE1_SET(channel));
+
+    alt_write_word(ALT_DMA_DBGINST1_ADDR(ALT_DMASECURE_ADDR), pgmpa);
+
+    /* Execute the instruction held in DBGINST{0,1} */
+
+    /* For information on DBGCMD, see PL330, section 3.3.19. */
+
+    alt_write_word(ALT_DMA_DBGCMD_ADDR(ALT_DMASECURE_ADDR), 0);
+}
+
 ALT_STATUS_CODE alt_dma_channel_exec(ALT_DMA_CHANNEL_t channel, ALT_DMA_PROGRAM_t * pgm)
 {
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
@@ -695,58 +762,20 @@ ALT_STATUS_CODE alt_dma_channel_exec(ALT_DMA_CHANNEL_t channel, ALT_DMA_PROGRAM_
         status = alt_dma_program_validate(pgm);
     }
 
-    /* Sync the DMA program to RAM. */
-
-    if (status == ALT_E_SUCCESS)
-    {
-        void * vaddr  = (void *)((uintptr_t)(pgm->program + pgm->buffer_start) & ~(ALT_CACHE_LINE_SIZE - 1));
-        void * vend   = (void *)(((uintptr_t)(pgm->program + pgm->buffer_start + pgm->code_size) + (ALT_CACHE_LINE_SIZE - 1)) & ~(ALT_CACHE_LINE_SIZE - 1));
-        size_t length = (uintptr_t)vend - (uintptr_t)vaddr;
-
-        status = alt_cache_system_clean(vaddr, length);
-    }
-
-    /*
-     * Get the PA of the program buffer.
-     * */
+    /* Sync the DMA program to RAM and get the PA of the program buffer. */
 
     if (status == ALT_E_SUCCESS)
     {
-        uint32_t dfsr;
-        uint32_t seglength;
-        pgmpa = alt_mmu_va_to_pa(pgm->program + pgm->buffer_start, &seglength, &dfsr);
-        if (dfsr)
-        {
-            dprintf("DMA[exec]: ERROR: Cannot get VA-to-PA of pgm->program + pgm->buffer_start= %p.\n", pgm->program + pgm->buffer_start);
-            status = ALT_E_ERROR;
-        }
+        status = alt_dma_program_sync(pgm, &pgmpa);
     }
 
     /*
      * Execute the program
      * */
 
-    /* Configure DBGINST0 and DBGINST1 to execute DMAGO targetting the requested channel. */
-
-    /* For information on APB Interface, see PL330, section 2.5.1.
-     * For information on DBGINSTx, see PL330, section 3.3.20 - 3.3.21.
-     * For information on DMAGO, see PL330, section 4.3.5. */
-
     if (status == ALT_E_SUCCESS)
     {
-        dprintf("DMA[exec]: program = 0x%x (PA).\n", pgmpa);
-
-        alt_write_word(ALT_DMA_DBGINST0_ADDR(ALT_DMASECURE_ADDR),
-                       ALT_DMA_DBGINST0_INSTRUCTIONBYTE0_SET(0xa0) |
-                       ALT_DMA_DBGINST0_INSTRUCTIONBYTE1_SET(channel));
-
-        alt_write_word(ALT_DMA_DBGINST1_ADDR(ALT_DMASECURE_ADDR), pgmpa);
-
-        /* Execute the instruction held in DBGINST{0,1} */
-
-        /* For information on DBGCMD, see PL330, section 3.3.19. */
-
-        alt_write_word(ALT_DMA_DBGCMD_ADDR(ALT_DMASECURE_ADDR), 0);
+        alt_dma_channel_go(channel, pgmpa);
     }
 
     return status;
@@ -1400,157 +1429,174 @@ static ALT_STATUS_CODE alt_dma_memory_to_memory_segment(ALT_DMA_PROGRAM_t * prog
     return status;
 }
 
-ALT_STATUS_CODE alt_dma_memory_to_memory(ALT_DMA_CHANNEL_t channel,
-                                         ALT_DMA_PROGRAM_t * program,
-                                         void * dst,
-                                         const void * src,
-                                         size_t size,
-                                         bool send_evt,
-                                         ALT_DMA_EVENT_t evt)
+/*
+ * Assembles the transfer of one (dst, src, size) triple into the program,
+ * splitting it where either buffer crosses a physical segment boundary.
+ * */
+static ALT_STATUS_CODE alt_dma_memory_to_memory_coalesce(ALT_DMA_PROGRAM_t * program,
+                                                         void * dst,
+                                                         const void * src,
+                                                         size_t size)
 {
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    ALT_MMU_VA_TO_PA_COALESCE_t coalesce_dst;
+    ALT_MMU_VA_TO_PA_COALESCE_t coalesce_src;
+    uintptr_t segpa_dst   = 0;
+    uintptr_t segpa_src   = 0;
+    uint32_t  segsize_dst = 0;
+    uint32_t  segsize_src = 0;
+
+    dprintf("DMA[M->M]: dst  = %p.\n",   dst);
+    dprintf("DMA[M->M]: src  = %p.\n",   src);
+    dprintf("DMA[M->M]: size = 0x%x.\n", size);
+
+    /* Detect if memory regions overshoots the address space.
+     * This error checking is handled by the coalescing API. */
 
-    /* If the size is zero, and no event is requested, just return success. */
-    if ((size == 0) && (send_evt == false))
+    /* Detect if memory regions overlaps. */
+
+    if ((uintptr_t)dst > (uintptr_t)src)
     {
-        return ALT_E_SUCCESS;
+        if ((uintptr_t)src + size - 1 > (uintptr_t)dst)
+        {
+            return ALT_E_BAD_ARG;
+        }
+    }
+    else
+    {
+        if ((uintptr_t)dst + size - 1 > (uintptr_t)src)
+        {
+            return ALT_E_BAD_ARG;
+        }
     }
 
+    /*
+     * Attempt to coalesce and make the transfer.
+     */
+
     if (status == ALT_E_SUCCESS)
     {
-        status = alt_dma_program_init(program);
+        status = alt_mmu_va_to_pa_coalesce_begin(&coalesce_dst, dst, size);
     }
 
-    if (size != 0)
+    if (status == ALT_E_SUCCESS)
     {
-        ALT_MMU_VA_TO_PA_COALESCE_t coalesce_dst;
-        ALT_MMU_VA_TO_PA_COALESCE_t coalesce_src;
-        uintptr_t segpa_dst   = 0;
-        uintptr_t segpa_src   = 0;
-        uint32_t  segsize_dst = 0;
-        uint32_t  segsize_src = 0;
-
-        dprintf("DMA[M->M]: dst  = %p.\n",   dst);
-        dprintf("DMA[M->M]: src  = %p.\n",   src);
-        dprintf("DMA[M->M]: size = 0x%x.\n", size);
-
-        /* Detect if memory regions overshoots the address space.
-         * This error checking is handled by the coalescing API. */
-
-        /* Detect if memory regions overlaps. */
+        status = alt_mmu_va_to_pa_coalesce_begin(&coalesce_src, src, size);
+    }
 
-        if ((uintptr_t)dst > (uintptr_t)src)
-        {
-            if ((uintptr_t)src + size - 1 > (uintptr_t)dst)
-            {
-                return ALT_E_BAD_ARG;
-            }
-        }
-        else
+    while (size)
+    {
+        uint32_t segsize;
+        if (status != ALT_E_SUCCESS)
         {
-            if ((uintptr_t)dst + size - 1 > (uintptr_t)src)
-            {
-                return ALT_E_BAD_ARG;
-            }
+            break;
         }
 
         /*
-         * Attempt to coalesce and make the transfer.
+         * If any of dst or src segments has been completed (or not started), determine its
+         * next segment.
          */
 
-        if (status == ALT_E_SUCCESS)
+        if ((status == ALT_E_SUCCESS) && (segsize_dst == 0))
         {
-            status = alt_mmu_va_to_pa_coalesce_begin(&coalesce_dst, dst, size);
-        }
+            status = alt_mmu_va_to_pa_coalesce_next(&coalesce_dst, &segpa_dst, &segsize_dst);
 
-        if (status == ALT_E_SUCCESS)
-        {
-            status = alt_mmu_va_to_pa_coalesce_begin(&coalesce_src, src, size);
+            dprintf("DMA[M->M]: Next dst segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_dst, segsize_dst);
         }
 
-        while (size)
+        if ((status == ALT_E_SUCCESS) && (segsize_src == 0))
         {
-            uint32_t segsize;
-            if (status != ALT_E_SUCCESS)
-            {
-                break;
-            }
+            status = alt_mmu_va_to_pa_coalesce_next(&coalesce_src, &segpa_src, &segsize_src);
 
-            /*
-             * If any of dst or src segments has been completed (or not started), determine its
-             * next segment.
-             */
+            dprintf("DMA[M->M]: Next src segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_src, segsize_src);
+        }
 
-            if ((status == ALT_E_SUCCESS) && (segsize_dst == 0))
-            {
-                status = alt_mmu_va_to_pa_coalesce_next(&coalesce_dst, &segpa_dst, &segsize_dst);
+        /*
+         * Determine the largest segment to safely transfer next.
+         * */
 
-                dprintf("DMA[M->M]: Next dst segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_dst, segsize_dst);
-            }
+        /* This is the largest segment that can safely be transfered considering both dst and
+         * src segmentation. Typically dst or src or both segment(s) will complete. */
+        segsize = ALT_MIN(segsize_dst, segsize_src);
 
-            if ((status == ALT_E_SUCCESS) && (segsize_src == 0))
-            {
-                status = alt_mmu_va_to_pa_coalesce_next(&coalesce_src, &segpa_src, &segsize_src);
+        /*
+         * Transfer the largest safe segment.
+         * */
 
-                dprintf("DMA[M->M]: Next src segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_src, segsize_src);
-            }
+        if (status == ALT_E_SUCCESS)
+        {
+            dprintf("DMA[M->M]: Transfering safe size = 0x%" PRIx32 ".\n", segsize);
 
-            /*
-             * Determine the largest segment to safely transfer next.
-             * */
+            status = alt_dma_memory_to_memory_segment(program, segpa_dst, segpa_src, segsize);
+        }
 
-            /* This is the largest segment that can safely be transfered considering both dst and
-             * src segmentation. Typically dst or src or both segment(s) will complete. */
-            segsize = ALT_MIN(segsize_dst, segsize_src);
+        /*
+         * Update some bookkeeping.
+         * */
 
-            /*
-             * Transfer the largest safe segment.
-             * */
+        segsize_dst -= segsize;
+        segsize_src -= segsize;
 
-            if (status == ALT_E_SUCCESS)
-            {
-                dprintf("DMA[M->M]: Transfering safe size = 0x%" PRIx32 ".\n", segsize);
+        if (segsize_dst)
+        {
+            segpa_dst += segsize;
 
-                status = alt_dma_memory_to_memory_segment(program, segpa_dst, segpa_src, segsize);
-            }
+            dprintf("DMA[M->M]: Updated dst segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_dst, segsize_dst);
+        }
 
-            /*
-             * Update some bookkeeping.
-             * */
+        if (segsize_src)
+        {
+            segpa_src += segsize;
 
-            segsize_dst -= segsize;
-            segsize_src -= segsize;
+            dprintf("DMA[M->M]: Updated src segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_src, segsize_src);
+        }
 
-            if (segsize_dst)
-            {
-                segpa_dst += segsize;
+        /* Use ALT_MIN() to assuredly prevent infinite loop. If either the dst or src has not yet
+         * completed, coalesce_end() will catch that logical error. */
+        size -= ALT_MIN(segsize, size);
+    }
 
-                dprintf("DMA[M->M]: Updated dst segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_dst, segsize_dst);
-            }
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_mmu_va_to_pa_coalesce_end(&coalesce_dst);
+    }
 
-            if (segsize_src)
-            {
-                segpa_src += segsize;
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_mmu_va_to_pa_coalesce_end(&coalesce_src);
+    }
 
-                dprintf("DMA[M->M]: Updated src segment: PA = 0x%x, size = 0x%" PRIx32 ".\n", segpa_src, segsize_src);
-            }
+    return status;
+}
 
-            /* Use ALT_MIN() to assuredly prevent infinite loop. If either the dst or src has not yet
-             * completed, coalesce_end() will catch that logical error. */
-            size -= ALT_MIN(segsize, size);
-        }
+ALT_STATUS_CODE alt_dma_memory_to_memory(ALT_DMA_CHANNEL_t channel,
+                                         ALT_DMA_PROGRAM_t * program,
+                                         void * dst,
+                                         const void * src,
+                                         size_t size,
+                                         bool send_evt,
+                                         ALT_DMA_EVENT_t evt)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
 
-        if (status == ALT_E_SUCCESS)
-        {
-            status = alt_mmu_va_to_pa_coalesce_end(&coalesce_dst);
-        }
+    /* If the size is zero, and no event is requested, just return success. */
+    if ((size == 0) && (send_evt == false))
+    {
+        return ALT_E_SUCCESS;
+    }
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_init(program);
+    }
 
+    if (size != 0)
+    {
         if (status == ALT_E_SUCCESS)
         {
-            status = alt_mmu_va_to_pa_coalesce_end(&coalesce_src);
+            status = alt_dma_memory_to_memory_coalesce(program, dst, src, size);
         }
-
-    } /* if (size != 0) */
+    }
 
     /* Send event if requested. */
     if (send_evt)
@@ -1586,41 +1632,119 @@ ALT_STATUS_CODE alt_dma_memory_to_memory(ALT_DMA_CHANNEL_t channel,
     return alt_dma_channel_exec(channel, program);
 }
 
-static ALT_STATUS_CODE alt_dma_zero_to_memory_segment(ALT_DMA_PROGRAM_t * program,
-                                                      uintptr_t segbufpa,
-                                                      size_t segsize)
+ALT_STATUS_CODE alt_dma_memory_to_memory_sg(ALT_DMA_CHANNEL_t channel,
+                                            ALT_DMA_PROGRAM_t * program,
+                                            const ALT_DMA_SG_ENTRY_t * list,
+                                            size_t count,
+                                            bool send_evt,
+                                            ALT_DMA_EVENT_t evt)
 {
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
-    size_t sizeleft = segsize;
-    uint32_t burstcount;
-    uint32_t loop0;
-    uint32_t loop1;
+    size_t total = 0;
+    size_t i;
 
-    dprintf("DMA[Z->M][seg]: buf  = 0x%x (PA).\n", segbufpa);
-    dprintf("DMA[Z->M][seg]: size = 0x%x.\n",      segsize);
+    for (i = 0; i < count; ++i)
+    {
+        total += list[i].size;
+    }
+
+    /* If the size is zero, and no event is requested, just return success. */
+    if ((total == 0) && (send_evt == false))
+    {
+        return ALT_E_SUCCESS;
+    }
 
     if (status == ALT_E_SUCCESS)
     {
-        status = alt_dma_program_DMAMOV(program, ALT_DMA_PROGRAM_REG_DAR, segbufpa);
+        status = alt_dma_program_init(program);
     }
 
-    /* First see how many byte(s) we need to transfer to get dst to be 8 byte aligned. */
-    if (segbufpa & 0x7)
+    /* Each entry adds its own SAR, DAR and burst instructions to the one program. */
+
+    for (i = 0; i < count; ++i)
     {
-        uint32_t aligncount = ALT_MIN(8 - (segbufpa & 0x7), sizeleft);
-        sizeleft -= aligncount;
+        if (status != ALT_E_SUCCESS)
+        {
+            break;
+        }
 
-        dprintf("DMA[Z->M][seg]: Total pre-alignment 1-byte burst size transfer(s): %" PRIu32 ".\n", aligncount);
+        if (list[i].size != 0)
+        {
+            dprintf("DMA[M->M][sg]: Entry %u.\n", i);
 
-        /* Program in the following parameters:
-         *  - DS8   : Destination burst size of 1-byte
-         *  - DBx   : Destination burst length of [aligncount] transfer(s)
-         *  - DC(7) : Destination cacheable write-back, allocate on writes only
-         *  - All other options default. */
+            status = alt_dma_memory_to_memory_coalesce(program, list[i].dst, list[i].src, list[i].size);
+        }
+    }
 
+    /* Send event if requested. */
+    if (send_evt)
+    {
         if (status == ALT_E_SUCCESS)
         {
-            status = alt_dma_program_DMAMOV(program, ALT_DMA_PROGRAM_REG_CCR,
+            status = alt_dma_program_DMAWMB(program);
+        }
+
+        if (status == ALT_E_SUCCESS)
+        {
+            dprintf("DMA[M->M][sg]: Adding event ...\n");
+            status = alt_dma_program_DMASEV(program, evt);
+        }
+    }
+
+    /* Now that everything is done, end the program. */
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_DMAEND(program);
+    }
+
+    /* If there was a problem assembling the program, clean up the buffer and exit. */
+    if (status != ALT_E_SUCCESS)
+    {
+        /* Do not report the status for the clear operation. A failure should be
+         * reported regardless of if the clear is successful. */
+        alt_dma_program_clear(program);
+        return status;
+    }
+
+    /* Execute the program on the given channel. */
+    return alt_dma_channel_exec(channel, program);
+}
+
+static ALT_STATUS_CODE alt_dma_zero_to_memory_segment(ALT_DMA_PROGRAM_t * program,
+                                                      uintptr_t segbufpa,
+                                                      size_t segsize)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    size_t sizeleft = segsize;
+    uint32_t burstcount;
+    uint32_t loop0;
+    uint32_t loop1;
+
+    dprintf("DMA[Z->M][seg]: buf  = 0x%x (PA).\n", segbufpa);
+    dprintf("DMA[Z->M][seg]: size = 0x%x.\n",      segsize);
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_DMAMOV(program, ALT_DMA_PROGRAM_REG_DAR, segbufpa);
+    }
+
+    /* First see how many byte(s) we need to transfer to get dst to be 8 byte aligned. */
+    if (segbufpa & 0x7)
+    {
+        uint32_t aligncount = ALT_MIN(8 - (segbufpa & 0x7), sizeleft);
+        sizeleft -= aligncount;
+
+        dprintf("DMA[Z->M][seg]: Total pre-alignment 1-byte burst size transfer(s): %" PRIu32 ".\n", aligncount);
+
+        /* Program in the following parameters:
+         *  - DS8   : Destination burst size of 1-byte
+         *  - DBx   : Destination burst length of [aligncount] transfer(s)
+         *  - DC(7) : Destination cacheable write-back, allocate on writes only
+         *  - All other options default. */
+
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_dma_program_DMAMOV(program, ALT_DMA_PROGRAM_REG_CCR,
                                             (   ALT_DMA_CCR_OPT_SB_DEFAULT
                                               | ALT_DMA_CCR_OPT_SS_DEFAULT
                                               | ALT_DMA_CCR_OPT_SA_DEFAULT
@@ -5723,6 +5847,487 @@ ALT_STATUS_CODE alt_dma_periph_to_memory(ALT_DMA_CHANNEL_t channel,
     return alt_dma_channel_exec(channel, program);
 }
 
+/*
+ * DMA program templates
+ * */
+
+/* The operation a template was built for. Zero marks a template as not built. */
+#define ALT_DMA_TEMPLATE_TYPE_M2M 1
+#define ALT_DMA_TEMPLATE_TYPE_Z2M 2
+#define ALT_DMA_TEMPLATE_TYPE_M2R 3
+
+/*
+ * Gets the PA of a buffer which must not be split across physical segments,
+ * as a template only patches the first SAR and DAR of its program.
+ * */
+static ALT_STATUS_CODE alt_dma_template_va_to_pa(const void * va, size_t size, uintptr_t * pa)
+{
+    uint32_t dfsr;
+    uint32_t seglength;
+
+    /* Detect if memory region overshoots the address space. */
+    if ((uintptr_t)va + size - 1 < (uintptr_t)va)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    *pa = alt_mmu_va_to_pa(va, &seglength, &dfsr);
+    if (dfsr)
+    {
+        dprintf("DMA[tmpl]: ERROR: Cannot get VA-to-PA of %p.\n", va);
+        return ALT_E_ERROR;
+    }
+
+    if (seglength < size)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    return ALT_E_SUCCESS;
+}
+
+/*
+ * Works out the parts of the segment program which depend on the transfer
+ * size. This follows alt_dma_memory_to_memory_segment(),
+ * alt_dma_zero_to_memory_segment() and alt_dma_memory_to_register_segment():
+ *  - head  : 1-byte transfer(s) to get the address 8 byte aligned.
+ *  - loops : 16 burst length transfer(s). Between 2 and 256 of those are done
+ *            by the first DMALP of the program, on LC0.
+ *  - tail  : The remaining byte(s) or register transfer(s).
+ * */
+static void alt_dma_template_shape(const ALT_DMA_TEMPLATE_t * tmpl,
+                                   uintptr_t headpa,
+                                   size_t size,
+                                   uint32_t * head,
+                                   uint32_t * loops,
+                                   uint32_t * tail)
+{
+    if (tmpl->type == ALT_DMA_TEMPLATE_TYPE_M2R)
+    {
+        *head  = 0;
+        *loops = size >> 4;
+        *tail  = size & 0xf;
+    }
+    else
+    {
+        *head  = (headpa & 0x7) ? ALT_MIN(8 - (headpa & 0x7), size) : 0;
+        *loops = (size - *head) >> 7;
+        *tail  = (size - *head) & 0x7f;
+    }
+}
+
+/*
+ * Ends the template program, syncs it to RAM and records its shape.
+ * */
+static ALT_STATUS_CODE alt_dma_template_finish(ALT_DMA_TEMPLATE_t * tmpl,
+                                               ALT_STATUS_CODE status,
+                                               uint8_t type,
+                                               uint8_t align,
+                                               uintptr_t headpa,
+                                               size_t size,
+                                               bool send_evt,
+                                               ALT_DMA_EVENT_t evt)
+{
+    ALT_DMA_PROGRAM_t * program = &tmpl->program;
+
+    /* Send event if requested. */
+    if (send_evt)
+    {
+        if ((status == ALT_E_SUCCESS) && (type == ALT_DMA_TEMPLATE_TYPE_M2M))
+        {
+            status = alt_dma_program_DMAWMB(program);
+        }
+
+        if (status == ALT_E_SUCCESS)
+        {
+            dprintf("DMA[tmpl]: Adding event ...\n");
+            status = alt_dma_program_DMASEV(program, evt);
+        }
+    }
+
+    /* Now that everything is done, end the program. */
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_DMAEND(program);
+    }
+
+    /* Sync the program to RAM once, relaunches only clean what they patch. */
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_sync(program, &tmpl->pgmpa);
+    }
+
+    /* If there was a problem assembling the program, clean up the buffer and exit. */
+    if (status != ALT_E_SUCCESS)
+    {
+        /* Do not report the status for the clear operation. A failure should be
+         * reported regardless of if the clear is successful. */
+        alt_dma_program_clear(program);
+        return status;
+    }
+
+    {
+        uint32_t head;
+        uint32_t tail;
+
+        tmpl->type  = type;
+        tmpl->align = align;
+        tmpl->size  = size;
+
+        alt_dma_template_shape(tmpl, headpa, size, &head, &tmpl->loops, &tail);
+
+        tmpl->head = (uint8_t)head;
+        tmpl->tail = (uint8_t)tail;
+    }
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_dma_template_memory_to_memory(ALT_DMA_TEMPLATE_t * tmpl,
+                                                  void * dst,
+                                                  const void * src,
+                                                  size_t size,
+                                                  bool send_evt,
+                                                  ALT_DMA_EVENT_t evt)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    uintptr_t dstpa = 0;
+    uintptr_t srcpa = 0;
+
+    tmpl->type = 0;
+
+    if (size == 0)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Detect if memory regions overlaps. */
+
+    if ((uintptr_t)dst > (uintptr_t)src)
+    {
+        if ((uintptr_t)src + size - 1 > (uintptr_t)dst)
+        {
+            return ALT_E_BAD_ARG;
+        }
+    }
+    else
+    {
+        if ((uintptr_t)dst + size - 1 > (uintptr_t)src)
+        {
+            return ALT_E_BAD_ARG;
+        }
+    }
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_template_va_to_pa(dst, size, &dstpa);
+    }
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_template_va_to_pa(src, size, &srcpa);
+    }
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    dprintf("DMA[tmpl][M->M]: dst = 0x%x (PA), src = 0x%x (PA), size = 0x%x.\n", dstpa, srcpa, size);
+
+    status = alt_dma_program_init(&tmpl->program);
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_memory_to_memory_segment(&tmpl->program, dstpa, srcpa, size);
+    }
+
+    return alt_dma_template_finish(tmpl, status, ALT_DMA_TEMPLATE_TYPE_M2M,
+                                   (uint8_t)((srcpa & 0x7) | ((dstpa & 0x7) << 3)),
+                                   srcpa, size, send_evt, evt);
+}
+
+ALT_STATUS_CODE alt_dma_template_zero_to_memory(ALT_DMA_TEMPLATE_t * tmpl,
+                                                void * buf,
+                                                size_t size,
+                                                bool send_evt,
+                                                ALT_DMA_EVENT_t evt)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    uintptr_t bufpa = 0;
+
+    tmpl->type = 0;
+
+    if (size == 0)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    status = alt_dma_template_va_to_pa(buf, size, &bufpa);
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    dprintf("DMA[tmpl][Z->M]: buf = 0x%x (PA), size = 0x%x.\n", bufpa, size);
+
+    status = alt_dma_program_init(&tmpl->program);
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_zero_to_memory_segment(&tmpl->program, bufpa, size);
+    }
+
+    return alt_dma_template_finish(tmpl, status, ALT_DMA_TEMPLATE_TYPE_Z2M,
+                                   (uint8_t)(bufpa & 0x7),
+                                   bufpa, size, send_evt, evt);
+}
+
+ALT_STATUS_CODE alt_dma_template_memory_to_register(ALT_DMA_TEMPLATE_t * tmpl,
+                                                    void * dst_reg,
+                                                    const void * src_buf,
+                                                    size_t count,
+                                                    uint32_t register_width_bits,
+                                                    bool send_evt,
+                                                    ALT_DMA_EVENT_t evt)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    uint32_t ccr_ss_ds_mask = 0;
+    uint32_t reg_width_bytes_log2 = 0;
+    uintptr_t srcpa = 0;
+
+    tmpl->type = 0;
+
+    if (count == 0)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Verify valid register_width_bits and construct the CCR SS and DS parameters. */
+    switch (register_width_bits)
+    {
+    case 8:
+        ccr_ss_ds_mask = ALT_DMA_CCR_OPT_SS8 | ALT_DMA_CCR_OPT_DS8;
+        reg_width_bytes_log2 = 0;
+        break;
+    case 16:
+        ccr_ss_ds_mask = ALT_DMA_CCR_OPT_SS16 | ALT_DMA_CCR_OPT_DS16;
+        reg_width_bytes_log2 = 1;
+        break;
+    case 32:
+        ccr_ss_ds_mask = ALT_DMA_CCR_OPT_SS32 | ALT_DMA_CCR_OPT_DS32;
+        reg_width_bytes_log2 = 2;
+        break;
+    case 64:
+        ccr_ss_ds_mask = ALT_DMA_CCR_OPT_SS64 | ALT_DMA_CCR_OPT_DS64;
+        reg_width_bytes_log2 = 3;
+        break;
+    default:
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Verify that the dst_reg and src_buf are aligned to the register width */
+    if ((((uintptr_t)dst_reg | (uintptr_t)src_buf) & ((1 << reg_width_bytes_log2) - 1)) != 0)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    status = alt_dma_template_va_to_pa(src_buf, count << reg_width_bytes_log2, &srcpa);
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    dprintf("DMA[tmpl][M->R]: dst_reg = %p, src_buf = 0x%x (PA), count = 0x%x.\n", dst_reg, srcpa, count);
+
+    status = alt_dma_program_init(&tmpl->program);
+
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_DMAMOV(&tmpl->program, ALT_DMA_PROGRAM_REG_DAR, (uint32_t)dst_reg);
+    }
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_memory_to_register_segment(&tmpl->program, ccr_ss_ds_mask, srcpa, count);
+    }
+
+    return alt_dma_template_finish(tmpl, status, ALT_DMA_TEMPLATE_TYPE_M2R,
+                                   (uint8_t)reg_width_bytes_log2,
+                                   srcpa, count, send_evt, evt);
+}
+
+ALT_STATUS_CODE alt_dma_template_exec(ALT_DMA_CHANNEL_t channel,
+                                      ALT_DMA_TEMPLATE_t * tmpl,
+                                      void * dst,
+                                      const void * src,
+                                      size_t size)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    ALT_DMA_PROGRAM_t * program = &tmpl->program;
+    ALT_DMA_CHANNEL_STATE_t state;
+    uintptr_t dstpa = 0;
+    uintptr_t srcpa = 0;
+    uintptr_t headpa = 0;
+    uint32_t head;
+    uint32_t loops;
+    uint32_t tail;
+    uint32_t patch_end;
+
+    /* Validate channel */
+    switch (channel)
+    {
+    case ALT_DMA_CHANNEL_0:
+    case ALT_DMA_CHANNEL_1:
+    case ALT_DMA_CHANNEL_2:
+    case ALT_DMA_CHANNEL_3:
+    case ALT_DMA_CHANNEL_4:
+    case ALT_DMA_CHANNEL_5:
+    case ALT_DMA_CHANNEL_6:
+    case ALT_DMA_CHANNEL_7:
+        break;
+    default:
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Verify channel is allocated and stopped */
+
+    if (!(g_dmaState.channel_info[channel].flag & ALT_DMA_CHANNEL_INFO_FLAG_ALLOCED))
+    {
+        return ALT_E_ERROR;
+    }
+
+    alt_dma_channel_state_get(channel, &state);
+    if (state != ALT_DMA_CHANNEL_STATE_STOPPED)
+    {
+        return ALT_E_ERROR;
+    }
+
+    if (size == 0)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    /* Translate the buffers and check they have the alignment the template was built for. */
+
+    switch (tmpl->type)
+    {
+    case ALT_DMA_TEMPLATE_TYPE_M2M:
+        if ((uintptr_t)dst > (uintptr_t)src)
+        {
+            if ((uintptr_t)src + size - 1 > (uintptr_t)dst)
+            {
+                return ALT_E_BAD_ARG;
+            }
+        }
+        else
+        {
+            if ((uintptr_t)dst + size - 1 > (uintptr_t)src)
+            {
+                return ALT_E_BAD_ARG;
+            }
+        }
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_dma_template_va_to_pa(dst, size, &dstpa);
+        }
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_dma_template_va_to_pa(src, size, &srcpa);
+        }
+        if ((status == ALT_E_SUCCESS) && (((srcpa & 0x7) | ((dstpa & 0x7) << 3)) != tmpl->align))
+        {
+            status = ALT_E_BAD_ARG;
+        }
+        headpa = srcpa;
+        break;
+
+    case ALT_DMA_TEMPLATE_TYPE_Z2M:
+        status = alt_dma_template_va_to_pa(dst, size, &dstpa);
+        if ((status == ALT_E_SUCCESS) && ((dstpa & 0x7) != tmpl->align))
+        {
+            status = ALT_E_BAD_ARG;
+        }
+        headpa = dstpa;
+        break;
+
+    case ALT_DMA_TEMPLATE_TYPE_M2R:
+        if ((((uintptr_t)dst | (uintptr_t)src) & ((1 << tmpl->align) - 1)) != 0)
+        {
+            return ALT_E_BAD_ARG;
+        }
+        dstpa = (uintptr_t)dst;
+        status = alt_dma_template_va_to_pa(src, size << tmpl->align, &srcpa);
+        break;
+
+    default:
+        return ALT_E_ERROR;
+    }
+
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    /* Verify the new size gives the same program, apart from the loop count. */
+
+    alt_dma_template_shape(tmpl, headpa, size, &head, &loops, &tail);
+
+    if ((head != tmpl->head) || (tail != tmpl->tail))
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    /*
+     * Patch the program and sync the patched part to RAM.
+     * */
+
+    patch_end = program->dar + 4;
+
+    if (loops != tmpl->loops)
+    {
+        if ((loops < 2) || (loops > 256) || (tmpl->loops < 2) || (tmpl->loops > 256))
+        {
+            return ALT_E_BAD_ARG;
+        }
+
+        status = alt_dma_program_update_loop(program, 0, loops);
+        patch_end = ALT_MAX(patch_end, (uint32_t)program->lc0 + 1);
+    }
+
+    if ((status == ALT_E_SUCCESS) && (tmpl->type != ALT_DMA_TEMPLATE_TYPE_Z2M))
+    {
+        status = alt_dma_program_update_reg(program, ALT_DMA_PROGRAM_REG_SAR, srcpa);
+        patch_end = ALT_MAX(patch_end, (uint32_t)program->sar + 4);
+    }
+    if (status == ALT_E_SUCCESS)
+    {
+        status = alt_dma_program_update_reg(program, ALT_DMA_PROGRAM_REG_DAR, dstpa);
+    }
+
+    if (status == ALT_E_SUCCESS)
+    {
+        /* The program start is cache line aligned, see alt_dma_program_init(). */
+        void * vaddr  = program->program + program->buffer_start;
+        size_t length = (patch_end + (ALT_CACHE_LINE_SIZE - 1)) & ~(ALT_CACHE_LINE_SIZE - 1);
+
+        status = alt_cache_system_clean(vaddr, length);
+    }
+
+    if (status != ALT_E_SUCCESS)
+    {
+        return status;
+    }
+
+    tmpl->loops = loops;
+    tmpl->size  = size;
+
+    /*
+     * Execute the program
+     * */
+
+    alt_dma_channel_go(channel, tmpl->pgmpa);
+
+    return ALT_E_SUCCESS;
+}
+
 static bool alt_dma_is_init(void)
 {
 #if defined(soc_cv_av)
@@ -0,0 +1,293 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+#include "alt_dma_async.h"
+#include "alt_interrupt.h"
+#include "alt_mono.h"
+
+/* Reads of the channel state while waiting for DMAEND after the event */
+#define ALT_DMA_ASYNC_STOP_POLLS (1000)
+
+/* The transfer attached to each channel, NULL when none */
+static ALT_DMA_ASYNC_t * volatile alt_dma_async_xfer[ALT_DMA_CHANNEL_7 + 1];
+
+static void alt_dma_async_barrier(void)
+{
+    __sync_synchronize();
+}
+
+static void alt_dma_async_complete(ALT_DMA_CHANNEL_t channel, ALT_STATUS_CODE status, ALT_DMA_CHANNEL_FAULT_t fault)
+{
+    ALT_DMA_ASYNC_t * xfer = alt_dma_async_xfer[channel];
+
+    alt_dma_async_xfer[channel] = NULL;
+
+    xfer->status = status;
+    xfer->fault = fault;
+    alt_dma_async_barrier();
+    xfer->done = true;
+
+    if (xfer->callback)
+    {
+        xfer->callback(channel, status, xfer->context);
+    }
+}
+
+/* Completes the attached transfers of faulted channels */
+static void alt_dma_async_abort(void)
+{
+    ALT_DMA_MANAGER_STATE_t mgr_state;
+    ALT_DMA_CHANNEL_STATE_t state;
+    ALT_DMA_CHANNEL_FAULT_t fault;
+    bool unhandled = false;
+    uint32_t i;
+
+    for (i = ALT_DMA_CHANNEL_0; i <= ALT_DMA_CHANNEL_7; ++i)
+    {
+        alt_dma_channel_state_get((ALT_DMA_CHANNEL_t)i, &state);
+        if ((state != ALT_DMA_CHANNEL_STATE_FAULTING) && (state != ALT_DMA_CHANNEL_STATE_FAULTING_COMPLETING))
+        {
+            continue;
+        }
+
+        if (alt_dma_async_xfer[i] == NULL)
+        {
+            unhandled = true;
+            continue;
+        }
+
+        alt_dma_channel_fault_status_get((ALT_DMA_CHANNEL_t)i, &fault);
+        alt_dma_channel_kill((ALT_DMA_CHANNEL_t)i);
+        alt_dma_async_complete((ALT_DMA_CHANNEL_t)i, ALT_E_ERROR, fault);
+    }
+
+    alt_dma_manager_state_get(&mgr_state);
+    if (mgr_state == ALT_DMA_MANAGER_STATE_FAULTING)
+    {
+        unhandled = true;
+    }
+
+    /* The abort interrupt is level triggered, do not let someone else's fault keep it firing */
+    if (unhandled)
+    {
+        alt_int_dist_disable(ALT_INT_INTERRUPT_DMA_IRQ_ABORT);
+    }
+}
+
+void alt_dma_async_isr(uint32_t icciar, void * context)
+{
+    uint32_t int_id = ALT_INT_ICCIAR_ACKINTID_GET(icciar);
+    ALT_DMA_CHANNEL_t channel;
+    ALT_DMA_CHANNEL_STATE_t state = ALT_DMA_CHANNEL_STATE_STOPPED;
+    uint32_t i;
+
+    (void)context;
+
+    if (int_id == ALT_INT_INTERRUPT_DMA_IRQ_ABORT)
+    {
+        alt_dma_async_abort();
+        return;
+    }
+
+    if ((int_id < ALT_INT_INTERRUPT_DMA_IRQ0) || (int_id > ALT_INT_INTERRUPT_DMA_IRQ7))
+    {
+        return;
+    }
+
+    channel = (ALT_DMA_CHANNEL_t)(int_id - ALT_INT_INTERRUPT_DMA_IRQ0);
+    alt_dma_int_clear((ALT_DMA_EVENT_t)channel);
+
+    if (alt_dma_async_xfer[channel] == NULL)
+    {
+        return;
+    }
+
+    /* DMASEV is the last instruction before DMAEND, so the channel stops right after */
+    for (i = 0; i < ALT_DMA_ASYNC_STOP_POLLS; ++i)
+    {
+        alt_dma_channel_state_get(channel, &state);
+        if (state == ALT_DMA_CHANNEL_STATE_STOPPED)
+        {
+            break;
+        }
+    }
+
+    if ((state == ALT_DMA_CHANNEL_STATE_FAULTING) || (state == ALT_DMA_CHANNEL_STATE_FAULTING_COMPLETING))
+    {
+        /* Left for the abort interrupt */
+        return;
+    }
+
+    if (state != ALT_DMA_CHANNEL_STATE_STOPPED)
+    {
+        /* Still running, e.g. the event was not the end of the program. The */
+        /* next alt_dma_channel_exec() would be rejected, so stop it here. */
+        alt_dma_channel_kill(channel);
+        alt_dma_async_complete(channel, ALT_E_TMO, (ALT_DMA_CHANNEL_FAULT_t)0);
+        return;
+    }
+
+    alt_dma_async_complete(channel, ALT_E_SUCCESS, (ALT_DMA_CHANNEL_FAULT_t)0);
+}
+
+ALT_STATUS_CODE alt_dma_async_init(void)
+{
+    ALT_STATUS_CODE status = ALT_E_SUCCESS;
+    uint32_t i;
+
+    for (i = 0; i <= ALT_DMA_CHANNEL_7; ++i)
+    {
+        alt_dma_async_xfer[i] = NULL;
+    }
+
+    for (i = 0; (i <= ALT_DMA_EVENT_7) && (status == ALT_E_SUCCESS); ++i)
+    {
+        status = alt_dma_event_int_select((ALT_DMA_EVENT_t)i, ALT_DMA_EVENT_SELECT_SIG_IRQ);
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_dma_int_clear((ALT_DMA_EVENT_t)i);
+        }
+    }
+
+    for (i = ALT_INT_INTERRUPT_DMA_IRQ0; (i <= ALT_INT_INTERRUPT_DMA_IRQ_ABORT) && (status == ALT_E_SUCCESS); ++i)
+    {
+        status = alt_int_isr_register((ALT_INT_INTERRUPT_t)i, alt_dma_async_isr, NULL);
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_int_dist_target_set((ALT_INT_INTERRUPT_t)i, 0x1); /* CPU0 */
+        }
+        if (status == ALT_E_SUCCESS)
+        {
+            status = alt_int_dist_enable((ALT_INT_INTERRUPT_t)i);
+        }
+    }
+
+    return status;
+}
+
+ALT_STATUS_CODE alt_dma_async_uninit(void)
+{
+    uint32_t i;
+
+    for (i = ALT_INT_INTERRUPT_DMA_IRQ0; i <= ALT_INT_INTERRUPT_DMA_IRQ_ABORT; ++i)
+    {
+        alt_int_dist_disable((ALT_INT_INTERRUPT_t)i);
+        alt_int_isr_unregister((ALT_INT_INTERRUPT_t)i);
+    }
+
+    for (i = 0; i <= ALT_DMA_EVENT_7; ++i)
+    {
+        alt_dma_event_int_select((ALT_DMA_EVENT_t)i, ALT_DMA_EVENT_SELECT_SEND_EVT);
+    }
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_DMA_EVENT_t alt_dma_async_event(ALT_DMA_CHANNEL_t channel)
+{
+    return (ALT_DMA_EVENT_t)channel;
+}
+
+ALT_STATUS_CODE alt_dma_async_attach(ALT_DMA_CHANNEL_t channel,
+                                     ALT_DMA_ASYNC_t * xfer,
+                                     alt_dma_async_callback_t callback,
+                                     void * context)
+{
+    if ((uint32_t)channel > ALT_DMA_CHANNEL_7)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    if (alt_dma_async_xfer[channel] != NULL)
+    {
+        return ALT_E_ERROR;
+    }
+
+    xfer->callback = callback;
+    xfer->context  = context;
+    xfer->status   = ALT_E_SUCCESS;
+    xfer->fault    = (ALT_DMA_CHANNEL_FAULT_t)0;
+    xfer->done     = false;
+
+    /* Published before the transfer can be started */
+    alt_dma_async_barrier();
+    alt_dma_async_xfer[channel] = xfer;
+
+    /* Unmask in case an unattached fault masked it */
+    alt_int_dist_enable(ALT_INT_INTERRUPT_DMA_IRQ_ABORT);
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_dma_async_detach(ALT_DMA_CHANNEL_t channel)
+{
+    if ((uint32_t)channel > ALT_DMA_CHANNEL_7)
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    alt_dma_async_xfer[channel] = NULL;
+
+    return ALT_E_SUCCESS;
+}
+
+bool alt_dma_async_done(const ALT_DMA_ASYNC_t * xfer)
+{
+    return xfer->done;
+}
+
+ALT_STATUS_CODE alt_dma_async_wait(const ALT_DMA_ASYNC_t * xfer, uint32_t timeout_us)
+{
+    if (timeout_us == ALT_DMA_ASYNC_WAIT_FOREVER)
+    {
+        while (!xfer->done)
+        {
+            /* IRQ masked so that the completion cannot slip in between the check and the WFI */
+            uint32_t cpsr = alt_int_irq_save();
+            if (!xfer->done)
+            {
+                alt_int_wfi();
+            }
+            alt_int_irq_restore(cpsr);
+        }
+    }
+    else
+    {
+        alt_mono_deadline_t deadline = alt_mono_deadline_us(timeout_us);
+
+        while (!xfer->done)
+        {
+            if (alt_mono_expired(deadline))
+            {
+                return ALT_E_TMO;
+            }
+        }
+    }
+
+    alt_dma_async_barrier();
+
+    return xfer->status;
+}
@@ -70,6 +70,15 @@
  *    is the offset from the start of the buffer where DAR is located. */
 #define ALT_DMA_PROGRAM_FLAG_DAR (1UL << 25)
 
+/* [26] Flag that the first DMALP using LOOP0 has been programmed. The LC0
+ *    field is valid and is the offset from the start of the buffer where its
+ *    iteration count is located. */
+#define ALT_DMA_PROGRAM_FLAG_LC0 (1UL << 26)
+/* [27] Flag that the first DMALP using LOOP1 has been programmed. The LC1
+ *    field is valid and is the offset from the start of the buffer where its
+ *    iteration count is located. */
+#define ALT_DMA_PROGRAM_FLAG_LC1 (1UL << 27)
+
 /* [31] Flag that marks the last assembled instruction as DMAEND. */
 #define ALT_DMA_PROGRAM_FLAG_ENDED (1UL << 31)
 
@@ -206,6 +215,44 @@ ALT_STATUS_CODE alt_dma_program_update_reg(ALT_DMA_PROGRAM_t * pgm,
     return ALT_E_SUCCESS;
 }
 
+ALT_STATUS_CODE alt_dma_program_update_loop(ALT_DMA_PROGRAM_t * pgm,
+                                            uint32_t loop, uint32_t iterations)
+{
+    uint8_t * buffer = NULL;
+
+    /* Verify iterations in range */
+    if ((iterations == 0) || (iterations > 256))
+    {
+        return ALT_E_BAD_ARG;
+    }
+
+    switch (loop)
+    {
+    case 0:
+        if (!(pgm->flag & ALT_DMA_PROGRAM_FLAG_LC0))
+        {
+            return ALT_E_BAD_ARG;
+        }
+        buffer = pgm->program + pgm->buffer_start + pgm->lc0;
+        break;
+
+    case 1:
+        if (!(pgm->flag & ALT_DMA_PROGRAM_FLAG_LC1))
+        {
+            return ALT_E_BAD_ARG;
+        }
+        buffer = pgm->program + pgm->buffer_start + pgm->lc1;
+        break;
+
+    default:
+        return ALT_E_BAD_ARG;
+    }
+
+    buffer[0] = (uint8_t)(iterations - 1);
+
+    return ALT_E_SUCCESS;
+}
+
 ALT_STATUS_CODE alt_dma_program_DMAADDH(ALT_DMA_PROGRAM_t * pgm,
                                         ALT_DMA_PROGRAM_REG_t addr_reg, uint16_t val)
 {
@@ -539,12 +586,24 @@ ALT_STATUS_CODE alt_dma_program_DMALP(ALT_DMA_PROGRAM_t * pgm,
         pgm->flag |= ALT_DMA_PROGRAM_FLAG_LOOP0;
         pgm->loop0 = pgm->code_size + 2; /* This is the first instruction after the DMALP */
         lc_mask = 0x0;
+        /* If LC0 has not been used before, mark the location of its iteration count in the buffer. */
+        if (!(pgm->flag & ALT_DMA_PROGRAM_FLAG_LC0))
+        {
+            pgm->flag |= ALT_DMA_PROGRAM_FLAG_LC0;
+            pgm->lc0 = pgm->code_size + 1;
+        }
         break;
 
     case ALT_DMA_PROGRAM_FLAG_LOOP0:     /* LOOP0 in use. Use LOOP1. */
         pgm->flag |= ALT_DMA_PROGRAM_FLAG_LOOP1;
         pgm->loop1 = pgm->code_size + 2; /* This is the first instruction after the DMALP */
         lc_mask = 0x2;
+        /* If LC1 has not been used before, mark the location of its iteration count in the buffer. */
+        if (!(pgm->flag & ALT_DMA_PROGRAM_FLAG_LC1))
+        {
+            pgm->flag |= ALT_DMA_PROGRAM_FLAG_LC1;
+            pgm->lc1 = pgm->code_size + 1;
+        }
         break;
 
     case ALT_DMA_PROGRAM_FLAG_LOOP_ALL: /* All LOOPx in use. Report error. */
@@ -0,0 +1,475 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+#include "alt_dma_sched.h"
+#include "alt_interrupt.h"
+#include "alt_mono.h"
+
+#define ALT_DMA_SCHED_IDLE    (0)
+#define ALT_DMA_SCHED_QUEUED  (1)
+#define ALT_DMA_SCHED_RUNNING (2)
+
+#define ALT_DMA_SCHED_CHANNELS (ALT_DMA_CHANNEL_7 + 1)
+
+/* Bit masks of the pool channels, the reserved ones and the busy ones */
+static uint32_t alt_dma_sched_pool;
+static uint32_t alt_dma_sched_reserved;
+static uint32_t alt_dma_sched_busy;
+
+/* Queued jobs, highest priority first */
+static ALT_DMA_SCHED_JOB_t * alt_dma_sched_queue;
+
+/* Set while alt_dma_sched_dispatch() runs, a nested call leaves the work to it */
+static bool alt_dma_sched_dispatching;
+
+/* One program per channel, kept until the job on the channel completes */
+static ALT_DMA_PROGRAM_t alt_dma_sched_program[ALT_DMA_SCHED_CHANNELS];
+
+/* The lowest free channel the client may use, its own first. -1 if none */
+static int alt_dma_sched_pick(const ALT_DMA_SCHED_CLIENT_t * client)
+{
+    uint32_t free = alt_dma_sched_pool & ~alt_dma_sched_busy;
+    uint32_t mask = free & client->reserved;
+
+    if (mask == 0)
+    {
+        mask = free & ~alt_dma_sched_reserved;
+    }
+
+    if (mask == 0)
+    {
+        return -1;
+    }
+
+    return __builtin_ctz(mask);
+}
+
+/* Frees the channel, updates the statistics and marks the job done. The caller calls the callback */
+static void alt_dma_sched_finish(ALT_DMA_SCHED_JOB_t * job, ALT_STATUS_CODE status)
+{
+    ALT_DMA_SCHED_CLIENT_t * client = job->client;
+
+    alt_dma_sched_busy &= ~(1UL << job->channel);
+
+    client->jobs++;
+    client->busy_ticks += alt_mono_now_ticks() - job->started;
+    if (status == ALT_E_SUCCESS)
+    {
+        client->bytes += job->size;
+    }
+    else
+    {
+        client->failed++;
+    }
+
+    job->state = ALT_DMA_SCHED_IDLE;
+    job->status = status;
+    __sync_synchronize();
+    job->done = true;
+}
+
+static void alt_dma_sched_dispatch(void);
+
+/* alt_dma_async completion of a running job */
+static void alt_dma_sched_complete(ALT_DMA_CHANNEL_t channel, ALT_STATUS_CODE status, void * context)
+{
+    ALT_DMA_SCHED_JOB_t * job = (ALT_DMA_SCHED_JOB_t *)context;
+
+    (void)channel;
+
+    alt_dma_sched_finish(job, status);
+    if (job->callback)
+    {
+        job->callback(job, status);
+    }
+    alt_dma_sched_dispatch();
+}
+
+/* Starts the job on the channel. On failure the job is finished, without its callback */
+static ALT_STATUS_CODE alt_dma_sched_run(ALT_DMA_SCHED_JOB_t * job, ALT_DMA_CHANNEL_t channel)
+{
+    ALT_STATUS_CODE status;
+    uint64_t wait;
+
+    alt_dma_sched_busy |= 1UL << channel;
+    job->state = ALT_DMA_SCHED_RUNNING;
+    job->channel = channel;
+    job->started = alt_mono_now_ticks();
+
+    wait = job->started - job->queued;
+    if (wait > job->client->wait_ticks_max)
+    {
+        job->client->wait_ticks_max = wait;
+    }
+
+    status = alt_dma_async_attach(channel, &job->async, alt_dma_sched_complete, job);
+    if (status == ALT_E_SUCCESS)
+    {
+        status = job->start(job, channel, &alt_dma_sched_program[channel], alt_dma_async_event(channel));
+        if (status != ALT_E_SUCCESS)
+        {
+            alt_dma_async_detach(channel);
+        }
+    }
+
+    if (status != ALT_E_SUCCESS)
+    {
+        alt_dma_sched_finish(job, status);
+    }
+
+    return status;
+}
+
+/*
+ * Starts queued jobs while channels are free. A job whose channels are all
+ * busy does not hold back lower priority jobs which can run elsewhere.
+ *
+ * Jobs which fail to start are collected and their callbacks are called
+ * once the pass is over, with the IRQ mask of the caller restored. A
+ * callback may submit again, e.g. to retry, which only queues the job
+ * because a dispatch is in progress. Another pass then picks it up.
+ */
+static void alt_dma_sched_dispatch(void)
+{
+    ALT_DMA_SCHED_JOB_t * failed;
+    ALT_DMA_SCHED_JOB_t ** failed_tail;
+    bool again;
+    uint32_t cpsr;
+
+    cpsr = alt_int_irq_save();
+
+    if (alt_dma_sched_dispatching)
+    {
+        alt_int_irq_restore(cpsr);
+        return;
+    }
+    alt_dma_sched_dispatching = true;
+
+    do
+    {
+        failed = NULL;
+        failed_tail = &failed;
+
+        while (alt_dma_sched_pool & ~alt_dma_sched_busy)
+        {
+            ALT_DMA_SCHED_JOB_t ** link = &alt_dma_sched_queue;
+            ALT_DMA_SCHED_JOB_t * job;
+            int channel = -1;
+
+            for (job = alt_dma_sched_queue; job != NULL; job = job->next)
+            {
+                channel = alt_dma_sched_pick(job->client);
+                if (channel >= 0)
+                {
+                    break;
+                }
+                link = &job->next;
+            }
+
+            if (job == NULL)
+            {
+                break;
+            }
+
+            *link = job->next;
+            if (alt_dma_sched_run(job, (ALT_DMA_CHANNEL_t)channel) != ALT_E_SUCCESS)
+            {
+                job->next = NULL;
+                *failed_tail = job;
+                failed_tail = &job->next;
+            }
+        }
+
+        /* The callbacks, and any completions in between, may queue jobs or free channels */
+        again = (failed != NULL);
+        if (again)
+        {
+            alt_int_irq_restore(cpsr);
+            while (failed != NULL)
+            {
+                ALT_DMA_SCHED_JOB_t * job = failed;
+
+                /* Read before the callback, which may queue the job again */
+                failed = job->next;
+                if (job->callback)
+                {
+                    job->callback(job, job->status);
+                }
+            }
+            cpsr = alt_int_irq_save();
+        }
+    }
+    while (again);
+
+    alt_dma_sched_dispatching = false;
+    alt_int_irq_restore(cpsr);
+}
+
+ALT_STATUS_CODE alt_dma_sched_init(uint32_t count)
+{
+    ALT_DMA_CHANNEL_t channel;
+
+    if (count == ALT_DMA_SCHED_ALL_CHANNELS || count > ALT_DMA_SCHED_CHANNELS)
+    {
+        count = ALT_DMA_SCHED_CHANNELS;
+    }
+
+    while (count > 0 && alt_dma_channel_alloc_any(&channel) == ALT_E_SUCCESS)
+    {
+        alt_dma_sched_pool |= 1UL << channel;
+        count--;
+    }
+
+    return (alt_dma_sched_pool != 0) ? ALT_E_SUCCESS : ALT_E_ERROR;
+}
+
+ALT_STATUS_CODE alt_dma_sched_uninit(void)
+{
+    uint32_t i;
+
+    if (alt_dma_sched_queue != NULL || alt_dma_sched_busy != 0)
+    {
+        return ALT_E_ERROR;
+    }
+
+    for (i = 0; i < ALT_DMA_SCHED_CHANNELS; ++i)
+    {
+        if (alt_dma_sched_pool & (1UL << i))
+        {
+            alt_dma_channel_free((ALT_DMA_CHANNEL_t)i);
+        }
+    }
+
+    alt_dma_sched_pool = 0;
+    alt_dma_sched_reserved = 0;
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_dma_sched_client_init(ALT_DMA_SCHED_CLIENT_t * client, uint32_t reserve)
+{
+    uint32_t shared;
+    uint32_t cpsr;
+
+    client->reserved = 0;
+    alt_dma_sched_client_stats_reset(client);
+
+    cpsr = alt_int_irq_save();
+
+    shared = alt_dma_sched_pool & ~alt_dma_sched_reserved;
+    if ((uint32_t)__builtin_popcount(shared) < reserve)
+    {
+        alt_int_irq_restore(cpsr);
+        return ALT_E_ERROR;
+    }
+
+    /* The highest numbered ones, so the shared jobs keep the channels they were given first */
+    while (reserve > 0)
+    {
+        uint32_t bit = 1UL << (31 - __builtin_clz(shared));
+        client->reserved |= bit;
+        shared &= ~bit;
+        reserve--;
+    }
+    alt_dma_sched_reserved |= client->reserved;
+
+    alt_int_irq_restore(cpsr);
+
+    return ALT_E_SUCCESS;
+}
+
+ALT_STATUS_CODE alt_dma_sched_client_uninit(ALT_DMA_SCHED_CLIENT_t * client)
+{
+    uint32_t cpsr;
+
+    cpsr = alt_int_irq_save();
+    alt_dma_sched_reserved &= ~client->reserved;
+    client->reserved = 0;
+    alt_int_irq_restore(cpsr);
+
+    /* Queued shared jobs may now fit */
+    alt_dma_sched_dispatch();
+
+    return ALT_E_SUCCESS;
+}
+
+void alt_dma_sched_client_stats_reset(ALT_DMA_SCHED_CLIENT_t * client)
+{
+    uint32_t cpsr;
+
+    cpsr = alt_int_irq_save();
+    client->jobs = 0;
+    client->failed = 0;
+    client->bytes = 0;
+    client->busy_ticks = 0;
+    client->wait_ticks_max = 0;
+    client->since = alt_mono_now_ticks();
+    alt_int_irq_restore(cpsr);
+}
+
+uint32_t alt_dma_sched_client_load(const ALT_DMA_SCHED_CLIENT_t * client)
+{
+    uint64_t elapsed = alt_mono_now_ticks() - client->since;
+
+    if (elapsed == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(client->busy_ticks * 1000 / elapsed);
+}
+
+ALT_STATUS_CODE alt_dma_sched_submit(ALT_DMA_SCHED_JOB_t * job,
+                                     ALT_DMA_SCHED_CLIENT_t * client,
+                                     uint32_t priority,
+                                     alt_dma_sched_start_t start,
+                                     alt_dma_sched_callback_t callback,
+                                     void * context)
+{
+    ALT_DMA_SCHED_JOB_t ** link;
+    uint32_t cpsr;
+
+    cpsr = alt_int_irq_save();
+
+    if (job->state != ALT_DMA_SCHED_IDLE)
+    {
+        alt_int_irq_restore(cpsr);
+        return ALT_E_ERROR;
+    }
+
+    job->client   = client;
+    job->priority = priority;
+    job->start    = start;
+    job->callback = callback;
+    job->context  = context;
+    job->status   = ALT_E_SUCCESS;
+    job->done     = false;
+    job->state    = ALT_DMA_SCHED_QUEUED;
+    job->queued   = alt_mono_now_ticks();
+
+    /* Behind the jobs of the same or higher priority */
+    for (link = &alt_dma_sched_queue; *link != NULL && (*link)->priority >= priority; link = &(*link)->next)
+    {
+    }
+    job->next = *link;
+    *link = job;
+
+    alt_int_irq_restore(cpsr);
+
+    alt_dma_sched_dispatch();
+
+    return ALT_E_SUCCESS;
+}
+
+static ALT_STATUS_CODE alt_dma_sched_copy_start(ALT_DMA_SCHED_JOB_t * job,
+                                                ALT_DMA_CHANNEL_t channel,
+                                                ALT_DMA_PROGRAM_t * program,
+                                                ALT_DMA_EVENT_t evt)
+{
+    return alt_dma_memory_to_memory(channel, program, job->dst, job->src, job->size, true, evt);
+}
+
+ALT_STATUS_CODE alt_dma_sched_copy(ALT_DMA_SCHED_JOB_t * job,
+                                   ALT_DMA_SCHED_CLIENT_t * client,
+                                   uint32_t priority,
+                                   void * dst,
+                                   const void * src,
+                                   size_t size,
+                                   alt_dma_sched_callback_t callback,
+                                   void * context)
+{
+    if (job->state != ALT_DMA_SCHED_IDLE)
+    {
+        return ALT_E_ERROR;
+    }
+
+    job->dst  = dst;
+    job->src  = src;
+    job->size = size;
+
+    return alt_dma_sched_submit(job, client, priority, alt_dma_sched_copy_start, callback, context);
+}
+
+ALT_STATUS_CODE alt_dma_sched_cancel(ALT_DMA_SCHED_JOB_t * job)
+{
+    ALT_DMA_SCHED_JOB_t ** link;
+    uint32_t cpsr;
+
+    cpsr = alt_int_irq_save();
+
+    for (link = &alt_dma_sched_queue; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == job)
+        {
+            *link = job->next;
+            job->state = ALT_DMA_SCHED_IDLE;
+            alt_int_irq_restore(cpsr);
+            return ALT_E_SUCCESS;
+        }
+    }
+
+    alt_int_irq_restore(cpsr);
+
+    return ALT_E_ERROR;
+}
+
+bool alt_dma_sched_done(const ALT_DMA_SCHED_JOB_t * job)
+{
+    return job->done;
+}
+
+ALT_STATUS_CODE alt_dma_sched_wait(const ALT_DMA_SCHED_JOB_t * job, uint32_t timeout_us)
+{
+    if (timeout_us == ALT_DMA_SCHED_WAIT_FOREVER)
+    {
+        while (!job->done)
+        {
+            /* IRQ masked so that the completion cannot slip in between the check and the WFI */
+            uint32_t cpsr = alt_int_irq_save();
+            if (!job->done)
+            {
+                alt_int_wfi();
+            }
+            alt_int_irq_restore(cpsr);
+        }
+    }
+    else
+    {
+        alt_mono_deadline_t deadline = alt_mono_deadline_us(timeout_us);
+
+        while (!job->done)
+        {
+            if (alt_mono_expired(deadline))
+            {
+                return ALT_E_TMO;
+            }
+        }
+    }
+
+    __sync_synchronize();
+
+    return job->status;
+}
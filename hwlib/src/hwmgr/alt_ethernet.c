@@ -42,9 +42,15 @@
 #include "socal/hps.h"
 #include "alt_interrupt.h"
 #include "alt_printf.h"
+#include "alt_mem.h"
+#include "alt_mono.h"
 
 #ifdef ALT_DEBUG_ETHERNET
     #define dprintf printf
+#elif defined(TRU_LOG_HWLIB)
+    /* Route the debug prints to the tru_logger trace level, see tru_logger.h */
+    #include "tru_logger.h"
+    #define dprintf(...) TRU_LOG_TRACE(ETH, __VA_ARGS__)
 #else
     #define dprintf null_printf
 #endif
@@ -84,9 +90,7 @@ static const uint32_t Alt_Sysmgr_Core_Emac_Phy_Intf_Sel_Set_Msk[] = {
 /* Delay function used during ethernet setup */
 void alt_eth_delay(volatile uint32_t delay)
 {
-    volatile uint32_t i; 
-    
-    for(i = delay; i != 0; i--);
+    alt_mono_delay_us(delay);
 }
 
 /*  Reset the EMAC, Disable the FPGA Interface, and set the PHY mode  */
@@ -448,7 +452,7 @@ void alt_eth_start(uint32_t instance)
     /* Start DMA reception */
     alt_eth_dma_set_rx_state(ALT_ETH_ENABLE, instance); 
     
-    alt_eth_delay(ETH_RESET_DELAY);  
+    alt_eth_delay(ALT_ETH_RESET_DELAY_US);  
     
 }
 
@@ -470,7 +474,7 @@ void alt_eth_stop(uint32_t instance)
     /* Disable receive state machine of the MAC for reception from the MII */  
     alt_eth_mac_set_rx_state(ALT_ETH_DISABLE, instance);
           
-    alt_eth_delay(ETH_RESET_DELAY);  
+    alt_eth_delay(ALT_ETH_RESET_DELAY_US);  
 }
 
 alt_eth_enable_disable_state_t alt_eth_mac_get_bpa_state(uint32_t instance)
@@ -661,7 +665,7 @@ ALT_STATUS_CODE alt_eth_software_reset(uint32_t instance)
     /* Wait for the software reset to clear */
     for (i = 0; i < 10; i++)
     {
-        alt_eth_delay(ETH_RESET_DELAY);
+        alt_eth_delay(ALT_ETH_RESET_DELAY_US);
         if (alt_eth_get_software_reset_status(instance) == ALT_ETH_RESET)
         {
             break;
@@ -879,7 +883,6 @@ ALT_STATUS_CODE alt_eth_send_packet(uint8_t * pkt, uint32_t len, uint32_t first,
 {
     alt_eth_dma_desc_t *tx_desc;
     int32_t index=0;
-    unsigned int i;
     int32_t paranoid=NUMBER_OF_TX_DESCRIPTORS+1;
     
     tx_desc = &emac->tx_desc_ring[emac->tx_current_desc_number];
@@ -899,10 +902,7 @@ ALT_STATUS_CODE alt_eth_send_packet(uint8_t * pkt, uint32_t len, uint32_t first,
     }
     
     /* Copy data to local buffer   */
-    for (i = 0; i < len; i++)
-    {
-        *(uint8_t *)(emac->tx_buf + (emac->tx_current_desc_number * ETH_BUFFER_SIZE) + i) = *(pkt + i);
-    }
+    alt_mem_copy(emac->tx_buf + (emac->tx_current_desc_number * ETH_BUFFER_SIZE), pkt, len);
     
     /* set the buffer pointer */
     tx_desc->buffer1_addr = (uint32_t)&emac->tx_buf[emac->tx_current_desc_number * ETH_BUFFER_SIZE];
@@ -983,7 +983,7 @@ ALT_STATUS_CODE alt_eth_get_packet(uint8_t * pkt, uint32_t * len, alt_eth_emac_i
 {
     static int numrxpackets=0;
     alt_eth_dma_desc_t * desc;
-    uint32_t size=0,rx_search_desc_number,packet_end=0,packet_start=0,wrap,i;
+    uint32_t size=0,rx_search_desc_number,packet_end=0,packet_start=0,wrap;
     
     if (emac->instance > 2) { return ALT_E_ERROR; }    
     
@@ -1059,10 +1059,7 @@ ALT_STATUS_CODE alt_eth_get_packet(uint8_t * pkt, uint32_t * len, alt_eth_emac_i
         if (desc->status & ETH_DMARXDESC_LS)
         { 
             size=((desc->status >> ETH_DMARXDESC_FRAME_LENGTHSHIFT) & ETH_DMARXDESC_RBS1);  
-            for (i = 0; i < size; i++)
-            {
-                *(pkt + i) = *(uint8_t *)((uintptr_t)desc->buffer1_addr + i);
-            }
+            alt_mem_copy(pkt, (void *)(uintptr_t)desc->buffer1_addr, size);
             desc->status = ETH_DMARXDESC_OWN;            
             break;
         };
@@ -0,0 +1,123 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+#include "alt_mono.h"
+#include "alt_globaltmr.h"
+#include "alt_timers.h"
+#include "alt_mpu_registers.h"
+#include "socal/hps.h"
+#include "socal/socal.h"
+
+/* mpu_clk cycles per mpu_periph_clk cycle, fixed on the Cyclone V and Arria V */
+#define ALT_MONO_MPU_CLK_PER_PERIPH (4)
+
+void alt_mono_init(void)
+{
+    if (!(alt_read_word(ALT_GLOBALTMR_BASE + ALT_GLOBALTMR_CTRL_REG_OFFSET) & ALT_GLOBALTMR_ENABLE_BIT))
+    {
+        /* Only the counter, the comparator settings are left alone */
+        alt_setbits_word(ALT_GLOBALTMR_BASE + ALT_GLOBALTMR_CTRL_REG_OFFSET, ALT_GLOBALTMR_ENABLE_BIT);
+    }
+}
+
+uint64_t alt_mono_now_ticks(void)
+{
+    return alt_globaltmr_get64();
+}
+
+uint64_t alt_mono_now_cycles(void)
+{
+    uint32_t per_tick = ALT_MONO_MPU_CLK_PER_PERIPH * (alt_globaltmr_prescaler_get() + 1);
+
+    return alt_globaltmr_get64() * per_tick;
+}
+
+uint64_t alt_mono_now_ns(void)
+{
+    return alt_gpt_counts_to_nanosecs(ALT_GPT_CPU_GLOBAL_TMR, alt_globaltmr_get64());
+}
+
+uint64_t alt_mono_ticks_to_ns(uint64_t ticks)
+{
+    return alt_gpt_counts_to_nanosecs(ALT_GPT_CPU_GLOBAL_TMR, ticks);
+}
+
+uint64_t alt_mono_ns_to_ticks(uint64_t ns)
+{
+    return alt_gpt_nanosecs_to_counts(ALT_GPT_CPU_GLOBAL_TMR, ns);
+}
+
+uint64_t alt_mono_elapsed_ns(uint64_t start)
+{
+    return alt_gpt_counts_to_nanosecs(ALT_GPT_CPU_GLOBAL_TMR, alt_globaltmr_get64() - start);
+}
+
+alt_mono_deadline_t alt_mono_deadline_ns(uint64_t ns)
+{
+    uint64_t ticks;
+
+    alt_mono_init();
+    ticks = alt_mono_ns_to_ticks(ns) + 1;     /* + the partial tick we start in */
+    return alt_globaltmr_get64() + ticks;
+}
+
+alt_mono_deadline_t alt_mono_deadline_us(uint32_t us)
+{
+    return alt_mono_deadline_ns((uint64_t)us * 1000);
+}
+
+bool alt_mono_expired(alt_mono_deadline_t deadline)
+{
+    return alt_globaltmr_get64() >= deadline;
+}
+
+void alt_mono_delay_ns(uint64_t ns)
+{
+    alt_mono_deadline_t deadline = alt_mono_deadline_ns(ns);
+
+    while (!alt_mono_expired(deadline))
+    {
+    }
+}
+
+void alt_mono_delay_us(uint32_t us)
+{
+    alt_mono_delay_ns((uint64_t)us * 1000);
+}
+
+void alt_mono_delay_cycles(uint32_t cycles)
+{
+    uint32_t per_tick;
+    alt_mono_deadline_t deadline;
+
+    alt_mono_init();
+    per_tick = ALT_MONO_MPU_CLK_PER_PERIPH * (alt_globaltmr_prescaler_get() + 1);
+    /* Ticks rounded up, + the partial tick we start in */
+    deadline = alt_globaltmr_get64() + cycles / per_tick + 2;
+    while (!alt_mono_expired(deadline))
+    {
+    }
+}
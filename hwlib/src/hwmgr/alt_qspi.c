@@ -46,6 +46,8 @@
 #include <socal/hps.h>
 #include <socal/socal.h>
 #include <alt_printf.h>
+#include <alt_mem.h>
+#include <alt_mono.h>
 #include "alt_config.h"
 
 #if defined (soc_a10)
@@ -253,8 +255,15 @@ static ALT_QSPI_DEV_CONFIG_t qspi_config;
 /* Macros for accessing Status Register fields */
 #define ALT_QSPI_SR_WIP_GET(value)              ((value >> 0) & 0x1)
 
+/* Timeouts passed to the wait and STIG functions are in microseconds */
 #define ALT_QSPI_TIMEOUT_INFINITE (0xffffffff)
 
+/* Timeout for the controller to become idle, in microseconds */
+#define ALT_QSPI_IDLE_TMO_US      (1000)
+
+/* Timeout for a short STIG command (WREN, WRDIS, RDID, 4 byte mode), in microseconds */
+#define ALT_QSPI_STIG_TMO_US      (10000)
+
 /* static functions */
 ALT_STATUS_CODE alt_qspi_stig_cmd(uint32_t opcode, uint32_t dummy, uint32_t timeout);
 ALT_STATUS_CODE alt_qspi_stig_rd_cmd(uint8_t opcode, uint32_t dummy,
@@ -1120,7 +1129,7 @@ static ALT_STATUS_CODE alt_qspi_N25Q512A_N25Q00AA_enable(void)
     /* Switch to 4 byte mode */
     if (status == ALT_E_SUCCESS)
     {
-        status = alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_ENTER_4BYTE_MODE, 0, 10000);
+        status = alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_ENTER_4BYTE_MODE, 0, ALT_QSPI_STIG_TMO_US);
     }
 
     return status;
@@ -1131,6 +1140,7 @@ static ALT_STATUS_CODE alt_qspi_N25Q512A_N25Q00AA_wait_write(uint32_t time_out)
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
     uint8_t fsr = 0;
     bool infinite = (time_out == ALT_QSPI_TIMEOUT_INFINITE);
+    alt_mono_deadline_t deadline;
 
     /* Wait for the status register as for the other devices */
     if(status == ALT_E_SUCCESS)
@@ -1141,6 +1151,7 @@ static ALT_STATUS_CODE alt_qspi_N25Q512A_N25Q00AA_wait_write(uint32_t time_out)
     /* Wait for the flag status register */
     if(status == ALT_E_SUCCESS)
     {
+        deadline = alt_mono_deadline_us(time_out);
     	do
 	{
             /*Read flag status register */
@@ -1154,14 +1165,14 @@ static ALT_STATUS_CODE alt_qspi_N25Q512A_N25Q00AA_wait_write(uint32_t time_out)
 	        break;
 	    }
 	}
-        while (time_out-- || infinite);
+        while (infinite || !alt_mono_expired(deadline));
     }
     else
     {
 	return status;
     }
 
-    if (time_out == (uint32_t)-1 && !infinite)
+    if (status == ALT_E_SUCCESS && !(fsr & 0x80))
     {
         status = ALT_E_TMO;
     }
@@ -1376,6 +1387,7 @@ static ALT_STATUS_CODE alt_qspi_sr_wait_write(uint32_t timeout)
 
     uint8_t sr = 0;
     bool infinite = (timeout == ALT_QSPI_TIMEOUT_INFINITE);
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(timeout);
 
     do 
     {
@@ -1388,9 +1400,9 @@ static ALT_STATUS_CODE alt_qspi_sr_wait_write(uint32_t timeout)
         {
             break;
         }
-    } while (timeout-- || infinite);
+    } while (infinite || !alt_mono_expired(deadline));
 
-    if (timeout == (uint32_t) -1 && !infinite) 
+    if (status == ALT_E_SUCCESS && ALT_QSPI_SR_WIP_GET(sr)) 
     {
         status = ALT_E_TMO;
     }
@@ -1420,7 +1432,7 @@ ALT_STATUS_CODE alt_qspi_init(void)
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
     alt_freq_t qspi_clk_freq = 0;
     ALT_QSPI_BAUD_DIV_t div_bits;
-    uint32_t ALT_QSPI_RESET_TMO = 10000;
+    alt_mono_deadline_t deadline;
     /* Validate QSPI module input clocks.
     /  - pclk    - l4_mp_clk
     /  - hclk    - l4_mp_clk
@@ -1458,12 +1470,11 @@ ALT_STATUS_CODE alt_qspi_init(void)
     alt_clrbits_word(ALT_RSTMGR_PER0MODRST_ADDR, ALT_RSTMGR_PER0MODRST_QSPI_SET_MSK);
 #endif
     
-    while (ALT_QSPI_RESET_TMO && !alt_qspi_is_idle())
-    {
-        ALT_QSPI_RESET_TMO--;
-    }
+    deadline = alt_mono_deadline_us(ALT_QSPI_IDLE_TMO_US);
+    while (!alt_qspi_is_idle() && !alt_mono_expired(deadline))
+        ;
 
-    if (ALT_QSPI_RESET_TMO == 0)
+    if (!alt_qspi_is_idle())
     {
         status = ALT_E_TMO;
     }
@@ -1791,12 +1802,8 @@ static ALT_STATUS_CODE alt_qspi_read_helper(void * dst, uint32_t src, size_t siz
         {
             uint32_t level = alt_qspi_indirect_read_fill_level();
             uint32_t * data = (uint32_t *) ((uint32_t)dst + read_count);
-            uint32_t i;
 
-            for (i = 0; i < level; ++i) 
-            {
-                *data++ = alt_read_word(ALT_QSPIDATA_ADDR);
-            }
+            alt_mem_fifo_read32(data, (uintptr_t)ALT_QSPIDATA_ADDR, level);
 
             read_count += level * sizeof(uint32_t);
         }
@@ -1911,16 +1918,12 @@ static ALT_STATUS_CODE alt_qspi_write_helper(uint32_t dst, const void * src, siz
 
         while (write_count < size) 
         {
-            uint32_t i;
             uint32_t space = write_capacity - alt_qspi_indirect_write_fill_level();
             uint32_t * data;
             space = ALT_MIN(space, (size - write_count) / sizeof(uint32_t));
 
             data = (uint32_t *) ((uint32_t) src + write_count);
-            for (i = 0; i < space; ++i) 
-            {
-                alt_write_word(ALT_QSPIDATA_ADDR, *data++);
-            }
+            alt_mem_fifo_write32((uintptr_t)ALT_QSPIDATA_ADDR, data, space);
 
             write_count += space * sizeof(uint32_t);
         }
@@ -2881,7 +2884,7 @@ static ALT_STATUS_CODE alt_qspi_stig_cmd_helper(uint32_t reg_value, uint32_t tim
 {
     ALT_STATUS_CODE status = ALT_E_SUCCESS;
     bool infinite = (timeout == ALT_QSPI_TIMEOUT_INFINITE);
-    uint32_t ALT_QSPI_STIG_CMD_TMO = 10000;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(timeout);
 
     alt_write_word(ALT_QSPI_FLSHCMD_ADDR, reg_value);
     alt_write_word(ALT_QSPI_FLSHCMD_ADDR, reg_value | ALT_QSPI_FLSHCMD_EXECCMD_E_EXECUTE);
@@ -2893,20 +2896,19 @@ static ALT_STATUS_CODE alt_qspi_stig_cmd_helper(uint32_t reg_value, uint32_t tim
             break;
         }
 
-    } while (timeout-- || infinite);
+    } while (infinite || !alt_mono_expired(deadline));
 
-    if (timeout == (uint32_t) -1 && !infinite) 
+    if (reg_value & ALT_QSPI_FLSHCMD_CMDEXECSTAT_SET_MSK) 
     {
         status = ALT_E_TMO;
     }
 
 
-    while (ALT_QSPI_STIG_CMD_TMO && !alt_qspi_is_idle())
-    {
-        ALT_QSPI_STIG_CMD_TMO--;
-    } 
+    deadline = alt_mono_deadline_us(ALT_QSPI_IDLE_TMO_US);
+    while (!alt_qspi_is_idle() && !alt_mono_expired(deadline))
+        ;
 
-    if (ALT_QSPI_STIG_CMD_TMO == 0)
+    if (!alt_qspi_is_idle())
     {
         status = ALT_E_TMO;
     }
@@ -3029,19 +3031,19 @@ ALT_STATUS_CODE alt_qspi_stig_addr_cmd(uint8_t opcode, uint32_t dummy, uint32_t
 ALT_STATUS_CODE alt_qspi_device_wren(void) 
 {
     /* Write enable through STIG (not required, auto send by controller during write) */
-    return alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_WREN, 0, 10000);
+    return alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_WREN, 0, ALT_QSPI_STIG_TMO_US);
 }
 
 ALT_STATUS_CODE alt_qspi_device_wrdis(void) 
 {
     /* Write disable through STIG (not required, auto send by controller during write) */
-    return alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_WRDIS, 0, 10000);
+    return alt_qspi_stig_cmd(ALT_QSPI_STIG_OPCODE_WRDIS, 0, ALT_QSPI_STIG_TMO_US);
 }
 
 ALT_STATUS_CODE alt_qspi_device_rdid(uint32_t * rdid) 
 {
     /* Read flash device ID through STIG */
-    return alt_qspi_stig_rd_cmd(ALT_QSPI_STIG_OPCODE_RDID, 0, 8, rdid, 10000);
+    return alt_qspi_stig_rd_cmd(ALT_QSPI_STIG_OPCODE_RDID, 0, 8, rdid, ALT_QSPI_STIG_TMO_US);
 }
 
 /* Query the available erase options (each bit that is set signifies an erase size available) */
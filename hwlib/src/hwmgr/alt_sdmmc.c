@@ -46,6 +46,8 @@
 #include "socal/socal.h"
 #include <stdio.h>
 #include "alt_printf.h"
+#include "alt_mem.h"
+#include "alt_mono.h"
 
 #if defined (soc_a10)
 #include "socal/alt_ecc_sdmmc.h"
@@ -60,12 +62,16 @@
 #define ARRAY_COUNT(array) (sizeof(array) / sizeof(array[0]))
 
 
-/*  Timeout for reset manager*/
-#define  ALT_SDMMC_RESET_TMO_INIT      8192
-/*  Timeout for disable device*/
-#define  ALT_SDMMC_MAX_T_POLL_COUNT    8192
-/*  Timeout for waiting event*/
-#define  ALT_SDMMC_TMO_WAITER          1000000
+/*  Reset pulse width for reset manager and card reset, in microseconds*/
+#define  ALT_SDMMC_RESET_DELAY_US      100
+/*  Timeout for FIFO and DMA reset, in microseconds*/
+#define  ALT_SDMMC_RESET_TMO_US        1000
+/*  Timeout for waiting event, in microseconds*/
+#define  ALT_SDMMC_TMO_WAITER_US       1000000
+/*  Timeout for SD card initialization (ACMD41 loop), in microseconds*/
+#define  ALT_SDMMC_INIT_TMO_US         1000000
+/*  Wait between APP_CMD and SEND_OP_COND of an MMC style init, in microseconds*/
+#define  ALT_SDMMC_OP_COND_DELAY_US    10000
 
 #define ALT_SDMMC_DMA_SEGMENT_SIZE      512
 #define ALT_SDMMC_DMA_DESC_COUNT        128
@@ -736,15 +742,13 @@ static ALT_STATUS_CODE alt_sdmmc_rstmgr_set(void)
 */
 static ALT_STATUS_CODE alt_sdmmc_rstmgr_strobe(void)
 {
-    volatile uint32_t timeout = ALT_SDMMC_RESET_TMO_INIT;
 #ifdef soc_cv_av
     alt_setbits_word(ALT_RSTMGR_PERMODRST_ADDR, ALT_RSTMGR_PERMODRST_SDMMC_SET_MSK);
 #else
     alt_setbits_word(ALT_RSTMGR_PER0MODRST_ADDR, ALT_RSTMGR_PER0MODRST_SDMMC_SET_MSK);
 #endif
     /*  Wait while SD/MMC module is reseting*/
-    while (timeout--)
-        ;
+    alt_mono_delay_us(ALT_SDMMC_RESET_DELAY_US);
 
 #ifdef soc_cv_av
     /*  Deassert the appropriate SD/MMC module reset signal via the Reset Manager Peripheral Reset register.*/
@@ -1430,18 +1434,18 @@ bool alt_sdmmc_card_is_write_protected(void)
 */
 ALT_STATUS_CODE alt_sdmmc_fifo_reset(void)
 {
-    uint32_t timeout = ALT_SDMMC_MAX_T_POLL_COUNT;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_RESET_TMO_US);
 
     /*  Activate fifo reset*/
     alt_setbits_word(ALT_SDMMC_CTL_ADDR, ALT_SDMMC_CTL_FIFO_RST_SET_MSK);
     
     /*  Wait to complete reset or timeout*/
     while (ALT_SDMMC_CTL_FIFO_RST_GET(alt_read_word(ALT_SDMMC_CTL_ADDR))
-                                                && --timeout)
+                                                && !alt_mono_expired(deadline))
         ;
 
     /*  If fifo reset still are active, return timeout error*/
-    if (timeout == 0)
+    if (ALT_SDMMC_CTL_FIFO_RST_GET(alt_read_word(ALT_SDMMC_CTL_ADDR)))
     {
         return ALT_E_TMO;
     }
@@ -1454,18 +1458,18 @@ ALT_STATUS_CODE alt_sdmmc_fifo_reset(void)
 */
 ALT_STATUS_CODE alt_sdmmc_dma_reset(void)
 {
-    uint32_t timeout = ALT_SDMMC_MAX_T_POLL_COUNT;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_RESET_TMO_US);
 
     /* Activate dma reset*/
     alt_setbits_word(ALT_SDMMC_CTL_ADDR, ALT_SDMMC_CTL_DMA_RST_SET_MSK);
     
     /*  Wait to complete reset or timeout*/
     while (ALT_SDMMC_CTL_DMA_RST_GET(alt_read_word(ALT_SDMMC_CTL_ADDR))
-                                                && --timeout)
+                                                && !alt_mono_expired(deadline))
         ;
 
     /*  If dma reset still are active, return timeout error*/
-    if (timeout == 0)
+    if (ALT_SDMMC_CTL_DMA_RST_GET(alt_read_word(ALT_SDMMC_CTL_ADDR)))
     {
         return ALT_E_TMO;
     }
@@ -1792,15 +1796,12 @@ ALT_STATUS_CODE alt_sdmmc_fifo_param_set(uint32_t rx_wtrmk, uint32_t tx_wtrmk, A
 */
 ALT_STATUS_CODE alt_sdmmc_card_reset(void)
 {
-    volatile uint32_t timeout = ALT_SDMMC_RESET_TMO_INIT;
-
     /*  Assert card reset */
     alt_setbits_word(ALT_SDMMC_RST_N_ADDR, 
                      ALT_SDMMC_RST_N_CARD_RST_SET_MSK);
 
     /*  Wait while card reset*/
-    while (timeout--)
-        ;
+    alt_mono_delay_us(ALT_SDMMC_RESET_DELAY_US);
 
     /*  Deassert the appropriate card reset.*/
     alt_clrbits_word(ALT_SDMMC_RST_N_ADDR, 
@@ -1987,7 +1988,7 @@ static ALT_STATUS_CODE alt_sdmmc_transfer_helper(uint32_t * buffer,
     
     while (data_size > 0)
     {
-        uint32_t timeout = ALT_SDMMC_TMO_WAITER;
+        alt_mono_deadline_t deadline = 0;       /* set once the FIFO is found unavailable */
         uint32_t level;
 
 
@@ -2013,11 +2014,18 @@ static ALT_STATUS_CODE alt_sdmmc_transfer_helper(uint32_t * buffer,
 #ifdef LOGGER
             dprintf("\nread_freeze = %x write_freeze = %x\n", (int)read_freeze, (int)write_freeze);
 #endif
-            if (--timeout == 0)
+            if (read_freeze || write_freeze)
             {
-                status = ALT_E_TMO;
-                dprintf("Timed out due to FIFO not available\n");
-                return status;
+                if (deadline == 0)
+                {
+                    deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
+                }
+                else if (alt_mono_expired(deadline))
+                {
+                    status = ALT_E_TMO;
+                    dprintf("Timed out due to FIFO not available\n");
+                    return status;
+                }
             }
         }
         while (read_freeze || write_freeze);
@@ -2032,15 +2040,11 @@ static ALT_STATUS_CODE alt_sdmmc_transfer_helper(uint32_t * buffer,
 
         if (transfer_mode == ALT_SDMMC_TMOD_WRITE)
         {
-            uint32_t i;
             uint32_t free_space = ALT_SDMMC_FIFO_NUM_ENTRIES - level;
             free_space = ALT_MIN(data_size / 4, free_space);
 
-            for (i = 0; i < free_space; i++)
-            {
-                alt_write_word(ALT_SDMMC_DATA_ADDR, *buffer);
-                ++buffer;
-            }
+            alt_mem_fifo_write32((uintptr_t)ALT_SDMMC_DATA_ADDR, buffer, free_space);
+            buffer += free_space;
             data_size -= free_space * 4;
         }
 
@@ -2048,14 +2052,11 @@ static ALT_STATUS_CODE alt_sdmmc_transfer_helper(uint32_t * buffer,
 
         if (transfer_mode == ALT_SDMMC_TMOD_READ)
         {
-            uint32_t i;
             level = ALT_MIN(data_size / 4, level);
 
-            for (i = 0; i < level; i++)
-            {
-                *buffer = ALT_SDMMC_DATA_VALUE_GET(alt_read_word(ALT_SDMMC_DATA_ADDR));
-                ++buffer;
-            }
+            /* The DATA field is the whole register, ALT_SDMMC_DATA_VALUE_GET() does not change the value */
+            alt_mem_fifo_read32(buffer, (uintptr_t)ALT_SDMMC_DATA_ADDR, level);
+            buffer += level;
 
             data_size -= level * 4;
         }
@@ -2149,9 +2150,9 @@ static ALT_STATUS_CODE alt_sdmmc_dma_trans_helper(uint32_t * buffer,
 static ALT_STATUS_CODE alt_sdmmc_data_done_waiter(void)
 {
     ALT_STATUS_CODE status = ALT_E_TMO;
-    uint32_t timeout = ALT_SDMMC_TMO_WAITER;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
 
-    while (--timeout)
+    while (!alt_mono_expired(deadline))
     {
         uint32_t int_status;
         int_status = alt_sdmmc_int_status_get();
@@ -2184,10 +2185,10 @@ static ALT_STATUS_CODE alt_sdmmc_data_done_waiter(void)
         }
     }
 
-    timeout = ALT_SDMMC_TMO_WAITER;
-    while (!alt_sdmmc_is_idle() && --timeout)
+    deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
+    while (!alt_sdmmc_is_idle() && !alt_mono_expired(deadline))
         ;
-    if (timeout == 0)
+    if (!alt_sdmmc_is_idle())
     {
         dprintf("Timed out waiting for SDMMC to become idle\n");
         status = ALT_E_TMO;
@@ -2203,9 +2204,9 @@ static ALT_STATUS_CODE alt_sdmmc_data_done_waiter(void)
 static ALT_STATUS_CODE alt_sdmmc_clock_waiter(void)
 {
     ALT_STATUS_CODE status = ALT_E_TMO;
-    uint32_t timeout = ALT_SDMMC_TMO_WAITER;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
     
-    while (--timeout)
+    while (!alt_mono_expired(deadline))
     {
         uint32_t cmd_register = alt_read_word(ALT_SDMMC_CMD_ADDR);
         
@@ -2232,9 +2233,9 @@ static ALT_STATUS_CODE alt_sdmmc_clock_waiter(void)
 static ALT_STATUS_CODE alt_sdmmc_cmd_waiter(void)
 {
     ALT_STATUS_CODE status = ALT_E_TMO;
-    uint32_t timeout = ALT_SDMMC_TMO_WAITER;
+    alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
     
-    while (--timeout)
+    while (!alt_mono_expired(deadline))
     {
         uint32_t int_status;
         int_status = alt_sdmmc_int_status_get();
@@ -2535,7 +2536,7 @@ static ALT_STATUS_CODE alt_sdmmc_card_ident_sdhc(ALT_SDMMC_CARD_INFO_t *card_inf
     uint32_t response = 0;
 
     uint32_t clk_div = clock_freq / (4 * 2 * 400000);
-    uint32_t timeout;
+    alt_mono_deadline_t deadline;
     
     status = alt_sdmmc_card_clk_div_set(clk_div);
     if (status != ALT_E_SUCCESS)
@@ -2593,7 +2594,7 @@ static ALT_STATUS_CODE alt_sdmmc_card_ident_sdhc(ALT_SDMMC_CARD_INFO_t *card_inf
         }
     }
 
-    timeout = 1000000;
+    deadline = alt_mono_deadline_us(ALT_SDMMC_INIT_TMO_US);
     do
     {
         /*  Indicates to the card that the next command is an*/
@@ -2655,9 +2656,9 @@ static ALT_STATUS_CODE alt_sdmmc_card_ident_sdhc(ALT_SDMMC_CARD_INFO_t *card_inf
                 card_info->card_type = ALT_SDMMC_CARD_TYPE_SD;
            break;
         }
-    } while (--timeout);
+    } while (!alt_mono_expired(deadline));
     
-    if (timeout == 0)
+    if (!(response & 0x80000000))
     {
         status = ALT_E_TMO;
     }
@@ -2816,8 +2817,6 @@ static ALT_STATUS_CODE alt_sdmmc_card_enum_sd(ALT_SDMMC_CARD_INFO_t *card_info)
 
     do
     {
-        volatile uint32_t timeout = 1000000;
-
         status = alt_sdmmc_command_send(ALT_SDMMC_CMD_TYPE_BASIC, ALT_SDMMC_APP_CMD, 0x0, &response);
         if (status != ALT_E_SUCCESS)
         {
@@ -2830,8 +2829,7 @@ static ALT_STATUS_CODE alt_sdmmc_card_enum_sd(ALT_SDMMC_CARD_INFO_t *card_info)
 #endif
         
         /*  Wait while SD/MMC module is reseting*/
-        while (timeout--)
-            ;
+        alt_mono_delay_us(ALT_SDMMC_OP_COND_DELAY_US);
         status = alt_sdmmc_command_send(ALT_SDMMC_CMD_TYPE_ACMD, ALT_SD_SEND_OP_COND, 0x40FF8000, &response);
         if (status != ALT_E_SUCCESS)
         {
@@ -3151,8 +3149,8 @@ ALT_STATUS_CODE alt_sdmmc_command_send(ALT_SDMMC_CMD_TYPE_t command_type,
 
     if (cmd_cfg->wait_prvdata_complete)
     {
-        uint32_t timeout = ALT_SDMMC_TMO_WAITER;
-        while (alt_sdmmc_is_busy() && timeout--)
+        alt_mono_deadline_t deadline = alt_mono_deadline_us(ALT_SDMMC_TMO_WAITER_US);
+        while (alt_sdmmc_is_busy() && !alt_mono_expired(deadline))
             ;
     }
 
@@ -93,6 +93,178 @@ extern bool alt_globaltmr_is_running(void);
     #define ALT_OSC1TMR1_TMR1EOI_ADDR               ALT_TMR_SYS_1_TMR_TMR1EOI_ADDR
 #endif
 
+
+/****************************************************************************************/
+/* Counter to time conversion factors.                                                  */
+/*                                                                                      */
+/* The Cortex-A9 has no divide instruction, so dividing a 64-bit count by the clock     */
+/* frequency is a long library call. Instead each timer keeps a multiplier and a shift  */
+/* per time unit such that time = (count * mult) >> shift, which takes two 32x32-bit    */
+/* multiplies. The factors are computed once for the prescaler and clock configuration  */
+/* (alt_clk_cfg_gen) in use and are recomputed when either of them changes.             */
+/*                                                                                      */
+/* mult is (prescaler + 1) * units_per_second / freq scaled by 2^shift and rounded      */
+/* down, with shift chosen so that 2^31 <= mult < 2^32. Its relative error is therefore */
+/* below 2^-31, and a converted time is never more than the exact, truncated, quotient  */
+/* and is at most one unit less than it for results below 2^31 units. The nanoseconds   */
+/* to counts factor used by the delay functions is rounded up instead, so that a delay  */
+/* is never shorter than requested.                                                     */
+/****************************************************************************************/
+
+typedef enum ALT_GPT_UNIT_e
+{
+    ALT_GPT_UNIT_SEC,
+    ALT_GPT_UNIT_MSEC,
+    ALT_GPT_UNIT_USEC,
+    ALT_GPT_UNIT_NSEC,
+    ALT_GPT_UNIT_NUM
+} ALT_GPT_UNIT_t;
+
+typedef struct ALT_GPT_CONV_s
+{
+    bool        valid;
+    uint32_t    clk_gen;                        /* alt_clk_cfg_gen the factors are for */
+    uint32_t    pres;                           /* prescaler the factors are for */
+    uint32_t    mult[ALT_GPT_UNIT_NUM];         /* counts to time units */
+    uint32_t    shift[ALT_GPT_UNIT_NUM];
+    uint32_t    tick_mult;                      /* nanoseconds to counts, rounded up */
+    uint32_t    tick_shift;
+} ALT_GPT_CONV_t;
+
+static ALT_GPT_CONV_t alt_gpt_conv[ALT_GPT_SP_TMR1 + 1];
+
+static const uint32_t alt_gpt_unit_per_sec[ALT_GPT_UNIT_NUM] =
+{
+    1,
+    ALT_MILLISECS_IN_A_SEC,
+    ALT_MICROSECS_IN_A_SEC,
+    ALT_NANOSECS_IN_A_SEC
+};
+
+
+/****************************************************************************************/
+/* alt_gpt_conv_calc() finds mult and shift such that (x * mult) >> shift approximates  */
+/* x * num / den, by binary long division. Only used when the factors are refreshed.    */
+/****************************************************************************************/
+
+static void alt_gpt_conv_calc(uint64_t num, uint64_t den, bool round_up, uint32_t * mult, uint32_t * shift)
+{
+    uint64_t    quot = num / den;
+    uint64_t    rem = num % den;
+    uint32_t    sh = 0;
+
+    if (quot >= UINT32_MAX)                     /* far beyond any timer clock ratio */
+    {
+        *mult = UINT32_MAX;
+        *shift = 0;
+        return;
+    }
+
+    while ((quot < 0x80000000) && (sh < 95))     /* alt_gpt_conv_apply() takes up to 95 */
+    {
+        rem <<= 1;
+        quot <<= 1;
+        if (rem >= den)
+        {
+            rem -= den;
+            quot |= 1;
+        }
+        sh++;
+    }
+
+    if (round_up && (rem != 0))
+    {
+        quot++;
+        if (quot > UINT32_MAX)                  /* rounded up to 2^32 */
+        {
+            quot >>= 1;
+            sh--;
+        }
+    }
+
+    *mult = (uint32_t) quot;
+    *shift = sh;
+}
+
+
+/****************************************************************************************/
+/* alt_gpt_conv_apply() returns (val * mult) >> shift, rounded down or up, saturated to */
+/* UINT64_MAX.                                                                          */
+/****************************************************************************************/
+
+static __inline uint64_t alt_gpt_conv_apply(uint64_t val, uint32_t mult, uint32_t shift, bool round_up)
+{
+    uint64_t    lo = (uint64_t) (uint32_t) val * mult;                   /* product bits 0-63 */
+    uint64_t    hi = (uint64_t) (uint32_t) (val >> 32) * mult + (lo >> 32);  /* bits 32-95 */
+    uint64_t    ret;
+    bool        frac;                                                   /* bits shifted out */
+
+    if (shift >= 32)
+    {
+        ret = hi >> (shift - 32);
+        frac = ((uint32_t) lo != 0) || ((shift > 32) && ((hi << (96 - shift)) != 0));
+    }
+    else if ((hi >> (32 + shift)) != 0)
+    {
+        return UINT64_MAX;
+    }
+    else
+    {
+        ret = (hi << (32 - shift)) | ((uint32_t) lo >> shift);
+        frac = (shift != 0) && (((uint32_t) lo << (32 - shift)) != 0);
+    }
+
+    if (round_up && frac && (ret != UINT64_MAX))
+    {
+        ret++;
+    }
+    return ret;
+}
+
+
+/****************************************************************************************/
+/* alt_gpt_conv_get() returns the conversion factors of the specified timer, which is   */
+/* clocked by clk and uses prescaler pres. They are recomputed first if the prescaler   */
+/* or the clock configuration changed since they were last used. Returns NULL if the    */
+/* clock frequency can't be found.                                                      */
+/****************************************************************************************/
+
+static ALT_GPT_CONV_t * alt_gpt_conv_get(ALT_GPT_TIMER_t tmr_id, ALT_CLK_t clk, uint32_t pres)
+{
+    ALT_GPT_CONV_t      *conv;
+    uint32_t            gen = alt_clk_cfg_gen;
+    uint32_t            freq;
+    uint32_t            i;
+
+    if ((uint32_t) tmr_id > ALT_GPT_SP_TMR1)
+    {
+        return NULL;
+    }
+    conv = &alt_gpt_conv[tmr_id];
+
+    if (conv->valid && (conv->clk_gen == gen) && (conv->pres == pres))
+    {
+        return conv;
+    }
+
+    conv->valid = false;
+    if ((alt_clk_freq_get(clk, &freq) != ALT_E_SUCCESS) || (freq == 0))
+    {
+        return NULL;
+    }
+    for (i = 0; i < ALT_GPT_UNIT_NUM; i++)
+    {
+        alt_gpt_conv_calc((uint64_t) (pres + 1) * alt_gpt_unit_per_sec[i], freq, false,
+                          &conv->mult[i], &conv->shift[i]);
+    }
+    alt_gpt_conv_calc(freq, (uint64_t) (pres + 1) * ALT_NANOSECS_IN_A_SEC, true,
+                      &conv->tick_mult, &conv->tick_shift);
+    conv->clk_gen = gen;
+    conv->pres = pres;
+    conv->valid = true;
+    return conv;
+}
+
 /****************************************************************************************/
 /* alt_gpt_all_tmr_uninit() uninitializes the general-purpose timer modules             */
 /****************************************************************************************/
@@ -440,12 +612,13 @@ ALT_STATUS_CODE alt_gpt_counter_set(ALT_GPT_TIMER_t tmr_id, uint32_t val)
 /* alt_gpt_curtime_get_kernl() is the basis of the next four functions.                   */
 /****************************************************************************************/
 
-static uint32_t alt_gpt_curtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
+static uint32_t alt_gpt_curtime_get_kernl(ALT_GPT_TIMER_t tmr_id, ALT_GPT_UNIT_t unit)
 {
      uint64_t           bigtime;                /* r2 & r3 */
      uint32_t           time = 0;               /* value to return */
      ALT_CLK_t          clk = ALT_CLK_UNKNOWN;
-     uint32_t           pres, freq;
+     uint32_t           pres;
+     ALT_GPT_CONV_t     *conv;
      volatile uint32_t  *regaddr;               /* register address */
 
 
@@ -499,14 +672,12 @@ static uint32_t alt_gpt_curtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
              bigtime = (uint64_t) time;
          }
 
-         if (alt_clk_freq_get(clk, &freq) == ALT_E_SUCCESS)
+         conv = alt_gpt_conv_get(tmr_id, clk, pres);
+         if (conv != NULL)
          {
-             bigtime *= (pres + 1);
-                 /* ARM can usually do a 32x64 bit multiply faster than a 64x64 bit multiply */
-             bigtime *= mult;
-             bigtime /= freq;
-                 /* remaining count divided by cycles-per-second becomes seconds,
-                  * milliseconds, microseconds, or nanoseconds remaining */
+             bigtime = alt_gpt_conv_apply(bigtime, conv->mult[unit], conv->shift[unit], false);
+                 /* remaining count times prescaler divided by cycles-per-second becomes
+                  * seconds, milliseconds, microseconds, or nanoseconds remaining */
              time = (bigtime > UINT32_MAX) ? 0xFFFFFFFF : (uint32_t) bigtime;
          }
      }
@@ -521,7 +692,7 @@ static uint32_t alt_gpt_curtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
 
 uint32_t alt_gpt_curtime_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_curtime_get_kernl(tmr_id, 1);
+    return alt_gpt_curtime_get_kernl(tmr_id, ALT_GPT_UNIT_SEC);
 }
 
 
@@ -532,7 +703,7 @@ uint32_t alt_gpt_curtime_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_curtime_millisecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_curtime_get_kernl(tmr_id, ALT_MILLISECS_IN_A_SEC);
+    return alt_gpt_curtime_get_kernl(tmr_id, ALT_GPT_UNIT_MSEC);
 }
 
 
@@ -543,7 +714,7 @@ uint32_t alt_gpt_curtime_millisecs_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_curtime_microsecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_curtime_get_kernl(tmr_id, ALT_MICROSECS_IN_A_SEC);
+    return alt_gpt_curtime_get_kernl(tmr_id, ALT_GPT_UNIT_USEC);
 }
 
 
@@ -554,7 +725,63 @@ uint32_t alt_gpt_curtime_microsecs_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_curtime_nanosecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_curtime_get_kernl(tmr_id, ALT_NANOSECS_IN_A_SEC);
+    return alt_gpt_curtime_get_kernl(tmr_id, ALT_GPT_UNIT_NSEC);
+}
+
+
+/****************************************************************************************/
+/* alt_gpt_clk_get() returns the clock that drives the specified timer.                 */
+/****************************************************************************************/
+
+static ALT_CLK_t alt_gpt_clk_get(ALT_GPT_TIMER_t tmr_id)
+{
+    if ((tmr_id == ALT_GPT_CPU_GLOBAL_TMR) || (tmr_id == ALT_GPT_CPU_WDTGPT_TMR) || (tmr_id == ALT_GPT_CPU_PRIVATE_TMR))
+    {
+        return ALT_CLK_MPU_PERIPH;
+    }
+    else if ((tmr_id == ALT_GPT_OSC1_TMR0) || (tmr_id == ALT_GPT_OSC1_TMR1))
+    {
+        return ALT_CLK_OSC1;
+    }
+    else if ((tmr_id == ALT_GPT_SP_TMR0) || (tmr_id == ALT_GPT_SP_TMR1))
+    {
+        return ALT_CLK_L4_SP;
+    }
+    return ALT_CLK_UNKNOWN;
+}
+
+
+/****************************************************************************************/
+/* alt_gpt_counts_to_nanosecs() converts timer counts to nanoseconds, rounded down.     */
+/****************************************************************************************/
+
+uint64_t alt_gpt_counts_to_nanosecs(ALT_GPT_TIMER_t tmr_id, uint64_t counts)
+{
+    ALT_GPT_CONV_t      *conv;
+
+    conv = alt_gpt_conv_get(tmr_id, alt_gpt_clk_get(tmr_id), alt_gpt_prescaler_get(tmr_id));
+    if (conv == NULL)
+    {
+        return 0;
+    }
+    return alt_gpt_conv_apply(counts, conv->mult[ALT_GPT_UNIT_NSEC], conv->shift[ALT_GPT_UNIT_NSEC], false);
+}
+
+
+/****************************************************************************************/
+/* alt_gpt_nanosecs_to_counts() converts nanoseconds to timer counts, rounded up.       */
+/****************************************************************************************/
+
+uint64_t alt_gpt_nanosecs_to_counts(ALT_GPT_TIMER_t tmr_id, uint64_t nanoseconds)
+{
+    ALT_GPT_CONV_t      *conv;
+
+    conv = alt_gpt_conv_get(tmr_id, alt_gpt_clk_get(tmr_id), alt_gpt_prescaler_get(tmr_id));
+    if (conv == NULL)
+    {
+        return 0;
+    }
+    return alt_gpt_conv_apply(nanoseconds, conv->tick_mult, conv->tick_shift, true);
 }
 
 
@@ -573,8 +800,7 @@ uint32_t alt_gpt_delay_ns(ALT_GPT_TIMER_t tmr_id, uint32_t start_counter, uint32
     uint32_t prescaler = alt_gpt_prescaler_get(tmr_id);
     uint32_t ns_as_counter32;
     ALT_CLK_t clk;
-    uint64_t ns_as_counter64 = nanoseconds;
-    uint32_t freq;
+    ALT_GPT_CONV_t *conv;
     uint32_t stop_time, curtime, prior_curtime;
 
     /* Step 1 - convert tmr_id to clk id */
@@ -603,13 +829,14 @@ uint32_t alt_gpt_delay_ns(ALT_GPT_TIMER_t tmr_id, uint32_t start_counter, uint32
         return 0;
     }
 
-    alt_clk_freq_get(clk, &freq);
+    conv = alt_gpt_conv_get(tmr_id, clk, prescaler);
+    if (conv == NULL)
+    {
+        return 0;
+    }
 
     /* convert nanoseconds to counter ticks */
-    ns_as_counter64 *= freq;
-    ns_as_counter64 /= (prescaler + 1);
-    ns_as_counter64 /= (1000000000);
-    ns_as_counter32 = (uint32_t) (1 + ns_as_counter64);
+    ns_as_counter32 = (uint32_t) (1 + alt_gpt_conv_apply(nanoseconds, conv->tick_mult, conv->tick_shift, true));
 
     /* Normally, we would just subtract ns_as_counter64 from start_counter,
        however, if that would give a negative number then we have an issue.
@@ -656,33 +883,21 @@ uint32_t alt_gpt_delay_ns(ALT_GPT_TIMER_t tmr_id, uint32_t start_counter, uint32
 uint32_t alt_gpt_cpu_gblt_delay_ns(uint64_t nanoseconds)
 {
     uint32_t prescaler = alt_globaltmr_prescaler_get();
-    ALT_CLK_t clk;
-    uint64_t ns_as_counter64 = nanoseconds;
+    ALT_GPT_CONV_t *conv;
+    uint64_t ns_as_counter64;
     uint64_t start_counter;
-    uint32_t freq;
     uint64_t stop_time64, curtime64, prior_curtime64;
     uint64_t timer_max = (~ 0);
 
-    /* Step 1 - convert tmr_id to clk id */
-    clk = ALT_CLK_MPU_PERIPH;
-    alt_clk_freq_get(clk, &freq);
-
-    /* convert nanoseconds to counter ticks */
-    if(ns_as_counter64 * freq > ns_as_counter64) /*no overflow*/
+    conv = alt_gpt_conv_get(ALT_GPT_CPU_GLOBAL_TMR, ALT_CLK_MPU_PERIPH, prescaler);
+    if (conv == NULL)
     {
-        ns_as_counter64 *= freq;
-        ns_as_counter64 /= (prescaler + 1);
-        ns_as_counter64 /= (1000000000);
-        ns_as_counter64 += 1;
-    }
-    else /*ns_as_counter64 is big. It causes ns_as_counter64 * freq overflow*/
-    {
-        ns_as_counter64 /= (1000000000);
-        ns_as_counter64 *= freq;
-        ns_as_counter64 /= (prescaler + 1);
-        ns_as_counter64 += 1;
+        return 0;
     }
 
+    /* convert nanoseconds to counter ticks, the 96-bit product can't overflow */
+    ns_as_counter64 = alt_gpt_conv_apply(nanoseconds, conv->tick_mult, conv->tick_shift, true) + 1;
+
     start_counter = alt_globaltmr_get64();
     while( (timer_max - start_counter) < ns_as_counter64)
     {
@@ -893,11 +1108,12 @@ uint32_t alt_gpt_freq_get(ALT_GPT_TIMER_t tmr_id)
 /* definitions.                                                                         */
 /****************************************************************************************/
 
-static uint32_t alt_gpt_time_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
+static uint32_t alt_gpt_time_get_kernl(ALT_GPT_TIMER_t tmr_id, ALT_GPT_UNIT_t unit)
 {
-    uint32_t            freq, time = 0;
+    uint32_t            time = 0;
     uint64_t            bigtime;
     ALT_CLK_t           clk;
+    ALT_GPT_CONV_t      *conv;
 
 
     if ((tmr_id == ALT_GPT_CPU_GLOBAL_TMR) || (tmr_id == ALT_GPT_CPU_WDTGPT_TMR) || (tmr_id == ALT_GPT_CPU_PRIVATE_TMR))
@@ -915,16 +1131,14 @@ static uint32_t alt_gpt_time_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
     }
     else { return time; }
 
-    if (alt_clk_freq_get(clk, &freq) == ALT_E_SUCCESS)
+    conv = alt_gpt_conv_get(tmr_id, clk, alt_gpt_prescaler_get(tmr_id));
+    if (conv != NULL)
     {
-        bigtime = ((((uint64_t) alt_gpt_reset_value_get(tmr_id)) + 1) *
-                            ((uint64_t) (alt_gpt_prescaler_get(tmr_id)) + 1));
+        bigtime = ((uint64_t) alt_gpt_reset_value_get(tmr_id)) + 1;
                 /* Convert the reset value to 64-bit before the addition to avoid a potential
-                 * rollover to zero. But add one to the prescaler value before the conversion
-                 * to 64-bit -- no potential for rollover and integer addition is faster */
+                 * rollover to zero. The prescaler is part of the conversion factor */
 
-        bigtime *= (uint64_t) mult;
-        bigtime /= (uint64_t) freq;
+        bigtime = alt_gpt_conv_apply(bigtime, conv->mult[unit], conv->shift[unit], false);
         time = (bigtime > UINT32_MAX) ? 0xFFFFFFFF : (uint32_t) bigtime;
     }
     return time;
@@ -938,7 +1152,7 @@ static uint32_t alt_gpt_time_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
 
 uint32_t alt_gpt_time_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_time_get_kernl(tmr_id, 1);
+    return alt_gpt_time_get_kernl(tmr_id, ALT_GPT_UNIT_SEC);
 }
 
 /****************************************************************************************/
@@ -948,7 +1162,7 @@ uint32_t alt_gpt_time_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_time_millisecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_time_get_kernl(tmr_id, ALT_MILLISECS_IN_A_SEC);
+    return alt_gpt_time_get_kernl(tmr_id, ALT_GPT_UNIT_MSEC);
 }
 
 
@@ -959,7 +1173,7 @@ uint32_t alt_gpt_time_millisecs_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_time_microsecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_time_get_kernl(tmr_id, ALT_MICROSECS_IN_A_SEC);
+    return alt_gpt_time_get_kernl(tmr_id, ALT_GPT_UNIT_USEC);
 }
 
 
@@ -967,12 +1181,12 @@ uint32_t alt_gpt_time_microsecs_get(ALT_GPT_TIMER_t tmr_id)
 /* alt_gpt_maxtime_get_kernl() is the basis for the next two functions                  */
 /****************************************************************************************/
 
-static uint32_t alt_gpt_maxtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
+static uint32_t alt_gpt_maxtime_get_kernl(ALT_GPT_TIMER_t tmr_id, ALT_GPT_UNIT_t unit)
 {
     uint32_t            time = 0;
-    uint32_t            freq;
     uint64_t            bigtime;
     ALT_CLK_t           clk;
+    ALT_GPT_CONV_t      *conv;
 
 
     if ((tmr_id == ALT_GPT_CPU_GLOBAL_TMR) || (tmr_id == ALT_GPT_CPU_WDTGPT_TMR) || (tmr_id == ALT_GPT_CPU_PRIVATE_TMR))
@@ -990,12 +1204,12 @@ static uint32_t alt_gpt_maxtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
     }
     else { return time; }
 
-    if (alt_clk_freq_get(clk, &freq) == ALT_E_SUCCESS)
+    conv = alt_gpt_conv_get(tmr_id, clk, alt_gpt_prescaler_get(tmr_id));
+    if (conv != NULL)
     {
-        bigtime = (((uint64_t) alt_gpt_maxcounter_get(tmr_id)) + 1)
-                                * ((uint64_t) (alt_gpt_prescaler_get(tmr_id)) + 1);
-        bigtime *= (uint64_t) mult;                 /*scale the output */
-        bigtime /= (uint64_t) freq;
+        bigtime = ((uint64_t) alt_gpt_maxcounter_get(tmr_id)) + 1;
+        bigtime = alt_gpt_conv_apply(bigtime, conv->mult[unit], conv->shift[unit], false);
+                                                    /*scale the output */
         time = (bigtime > UINT32_MAX) ? 0xFFFFFFFF : (uint32_t) bigtime;
     }
     return time;
@@ -1009,7 +1223,7 @@ static uint32_t alt_gpt_maxtime_get_kernl(ALT_GPT_TIMER_t tmr_id, uint32_t mult)
 
 uint32_t alt_gpt_maxtime_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_maxtime_get_kernl(tmr_id, 1);
+    return alt_gpt_maxtime_get_kernl(tmr_id, ALT_GPT_UNIT_SEC);
 }
 
 
@@ -1020,7 +1234,7 @@ uint32_t alt_gpt_maxtime_get(ALT_GPT_TIMER_t tmr_id)
 
 uint32_t alt_gpt_maxtime_millisecs_get(ALT_GPT_TIMER_t tmr_id)
 {
-    return alt_gpt_maxtime_get_kernl(tmr_id, ALT_MILLISECS_IN_A_SEC);
+    return alt_gpt_maxtime_get_kernl(tmr_id, ALT_GPT_UNIT_MSEC);
 }
 
 
@@ -47,6 +47,7 @@
 #include <alt_mpu_registers.h>
 #include <alt_printf.h>
 #include <alt_timers.h>
+#include <alt_mono.h>
 #include "alt_config.h"
 
 #ifdef DEBUG_ALT_CLOCK_MANAGER
@@ -216,6 +217,10 @@ static ALT_PLL_CNTR_FREQMAX_t alt_pll_cntr_maxfreq =
     200000000
 };
 
+/* Clock configuration generation count, incremented by each function below that */
+/* can change a clock frequency. See alt_clock_manager.h                         */
+volatile uint32_t alt_clk_cfg_gen = 0;
+
 
 
         /* Maximum multiply, divide, and counter divisor values for each PLL */
@@ -249,23 +254,17 @@ static ALT_PLL_CNTR_FREQMAX_t alt_pll_cntr_maxfreq =
 
 
 /****************************************************************************************/
-/* alt_clk_mgr_wait() introduces a delay, not very exact, but very light in             */
-/* implementation. Depending upon the optimization level, it will wait at least the     */
-/* number of clock cycles specified in the cnt parameter, sometimes many more. The      */
-/* reg parameter is set to a register or a memory location that was recently used (so   */
-/* as to avoid accidently evicting a register and a recently-used cache line in favor   */
-/* of one whose values are not actually needed.). The cnt parameter sets the number of  */
-/* repeated volatile memory reads and so sets a minimum time delay measured in          */
-/* mpu_clk cycles. If mpu_clk = osc1 clock (as in bypass mode), then this gives a       */
-/* minimum osc1 clock cycle delay.                                                      */
+/* alt_clk_mgr_wait() waits at least cnt mpu_clk cycles. It times the wait on the       */
+/* global timer, which is clocked by mpu_periph_clk = mpu_clk / 4, so the wait is right */
+/* whatever the current mpu_clk frequency is. If mpu_clk = osc1 clock (as in bypass     */
+/* mode), then this gives a minimum osc1 clock cycle delay. The reg parameter is the    */
+/* register that was polled by the old read loop and is no longer used.                 */
 /****************************************************************************************/
 
 static __inline void alt_clk_mgr_wait(void* reg, uint32_t cnt)
 {
-    for (; cnt ; cnt--)
-    {
-        (void) alt_read_word(reg);
-    }
+    (void) reg;
+    alt_mono_delay_cycles(cnt);
 }
 
     /* Wait time constants */
@@ -481,6 +480,7 @@ ALT_STATUS_CODE alt_clk_safe_mode_clear(void)
     status = alt_clk_plls_settle_wait();
 
 #endif
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -645,6 +645,7 @@ ALT_STATUS_CODE alt_clk_pll_bypass_disable(ALT_CLK_t pll)
         status = ALT_E_ERROR;
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -758,6 +759,7 @@ ALT_STATUS_CODE alt_clk_pll_bypass_enable(ALT_CLK_t pll, bool use_input_mux)
         alt_write_word(ALT_CLKMGR_BYPASS_ADDR, temp);
         status = ALT_E_SUCCESS;
     }
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -1680,6 +1682,7 @@ ALT_STATUS_CODE alt_clk_source_set(ALT_CLK_t clk, ALT_CLK_t ref_clk)
         }
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -1746,6 +1749,7 @@ ALT_STATUS_CODE alt_clk_ext_clk_freq_set(ALT_CLK_t clk, alt_freq_t freq)
         status = ALT_E_BAD_ARG;
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -2069,6 +2073,7 @@ ALT_STATUS_CODE alt_clk_pll_cfg_set(ALT_CLK_t pll, const ALT_CLK_PLL_CFG_t * pll
         }
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return ret;
 }
 
@@ -2431,6 +2436,7 @@ ALT_STATUS_CODE alt_clk_pll_vco_cfg_set(ALT_CLK_t pll, uint32_t mult, uint32_t d
                       /* verify PLL is still locked or wait for it to lock again */
 		if (ret != ALT_E_SUCCESS)
 		{
+		    alt_clk_cfg_gen++;
 		    return ret;
 		}
             }
@@ -2449,14 +2455,14 @@ ALT_STATUS_CODE alt_clk_pll_vco_cfg_set(ALT_CLK_t pll, uint32_t mult, uint32_t d
             {
                 ret = alt_clk_pll_lock_wait(ALT_CLK_MAIN_PLL, 1000);
                       /* verify PLL is still locked or wait for it to lock again */
-		if (ret != ALT_E_SUCCESS) {return ret;} 
+		if (ret != ALT_E_SUCCESS) {alt_clk_cfg_gen++; return ret;}
             }
             alt_replbits_word(vaddr, denommask, div << denomshift);
         }
 
         ret = alt_clk_pll_lock_wait(ALT_CLK_MAIN_PLL, 1000);
               /* verify PLL is still locked or wait for it to lock again */
-	if (ret != ALT_E_SUCCESS) {return ret;} 
+	if (ret != ALT_E_SUCCESS) {alt_clk_cfg_gen++; return ret;}
 
         if (byp)
         {
@@ -2465,6 +2471,7 @@ ALT_STATUS_CODE alt_clk_pll_vco_cfg_set(ALT_CLK_t pll, uint32_t mult, uint32_t d
                 /* wait for PLL to come out of bypass mode completely */
         }
     }
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return ret;
 }
 
@@ -4164,6 +4171,7 @@ ALT_STATUS_CODE alt_clk_divider_set(ALT_CLK_t clk, uint32_t div)
         break;
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return ret;
 }
 
@@ -5173,6 +5181,7 @@ ALT_STATUS_CODE alt_clk_group_cfg_raw_set(const ALT_CLK_GROUP_RAW_CFG_t * clk_gr
         status = alt_clk_pll_bypass_disable(pll);
     }
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return status;
 }
 
@@ -5333,6 +5342,7 @@ ALT_STATUS_CODE alt_clk_clkmgr_reinit(void)
     if (status != ALT_E_SUCCESS) ret = ALT_E_ERROR;
 
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return ret;
 }
 
@@ -5343,5 +5353,6 @@ ALT_STATUS_CODE alt_clk_clkmgr_uninit(void)
 {
     ALT_STATUS_CODE ret = ALT_E_SUCCESS;
 
+    alt_clk_cfg_gen++;             /* let cached clock derived values know */
     return ret;
 } 
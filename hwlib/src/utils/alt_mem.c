@@ -0,0 +1,248 @@
+/******************************************************************************
+*
+* MIT License
+*
+* Copyright (c) 2023 Truong Hy
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+******************************************************************************/
+
+#include <string.h>
+#include "alt_mem.h"
+#include "socal/socal.h"
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__ARM_NEON)
+
+/* Bytes up to the next 8 byte aligned address of p */
+#define ALT_MEM_HEAD(p) ((size_t)(-(uintptr_t)(p) & 7))
+
+void * alt_mem_copy(void * dst, const void * src, size_t size)
+{
+    uint8_t * d = (uint8_t *)dst;
+    const uint8_t * s = (const uint8_t *)src;
+    size_t head;
+
+    if (size < ALT_MEM_NEON_MIN || (((uintptr_t)d ^ (uintptr_t)s) & 7))
+    {
+        return memcpy(dst, src, size);
+    }
+
+    /* Head, both addresses become 8 byte aligned together */
+    head = ALT_MEM_HEAD(d);
+    size -= head;
+    while (head--)
+    {
+        *d++ = *s++;
+    }
+
+    /* 64 byte blocks, two cache lines */
+    while (size >= 64)
+    {
+        uint64x2_t q0, q1, q2, q3;
+
+        __builtin_prefetch(s + ALT_MEM_PLD_AHEAD);
+        q0 = vld1q_u64((const uint64_t *)s);
+        q1 = vld1q_u64((const uint64_t *)(s + 16));
+        q2 = vld1q_u64((const uint64_t *)(s + 32));
+        q3 = vld1q_u64((const uint64_t *)(s + 48));
+        vst1q_u64((uint64_t *)d, q0);
+        vst1q_u64((uint64_t *)(d + 16), q1);
+        vst1q_u64((uint64_t *)(d + 32), q2);
+        vst1q_u64((uint64_t *)(d + 48), q3);
+        s += 64;
+        d += 64;
+        size -= 64;
+    }
+
+    /* Tail, 8 bytes at a time then bytes */
+    while (size >= 8)
+    {
+        vst1_u64((uint64_t *)d, vld1_u64((const uint64_t *)s));
+        s += 8;
+        d += 8;
+        size -= 8;
+    }
+    while (size--)
+    {
+        *d++ = *s++;
+    }
+
+    return dst;
+}
+
+void * alt_mem_set(void * dst, int value, size_t size)
+{
+    uint8_t * d = (uint8_t *)dst;
+    uint8x16_t q = vdupq_n_u8((uint8_t)value);
+    size_t head;
+
+    if (size < ALT_MEM_NEON_MIN)
+    {
+        return memset(dst, value, size);
+    }
+
+    head = ALT_MEM_HEAD(d);
+    size -= head;
+    while (head--)
+    {
+        *d++ = (uint8_t)value;
+    }
+
+    while (size >= 64)
+    {
+        vst1q_u8(d, q);
+        vst1q_u8(d + 16, q);
+        vst1q_u8(d + 32, q);
+        vst1q_u8(d + 48, q);
+        d += 64;
+        size -= 64;
+    }
+
+    while (size >= 8)
+    {
+        vst1_u8(d, vget_low_u8(q));
+        d += 8;
+        size -= 8;
+    }
+    while (size--)
+    {
+        *d++ = (uint8_t)value;
+    }
+
+    return dst;
+}
+
+int alt_mem_cmp(const void * a, const void * b, size_t size)
+{
+    const uint8_t * pa = (const uint8_t *)a;
+    const uint8_t * pb = (const uint8_t *)b;
+    size_t head;
+
+    if (size < ALT_MEM_NEON_MIN || (((uintptr_t)pa ^ (uintptr_t)pb) & 7))
+    {
+        return memcmp(a, b, size);
+    }
+
+    head = ALT_MEM_HEAD(pa);
+    for (; head; --head, --size, ++pa, ++pb)
+    {
+        if (*pa != *pb)
+        {
+            return *pa - *pb;
+        }
+    }
+
+    /* 64 byte blocks, compared as a whole. The first differing block is left for the byte loop */
+    while (size >= 64)
+    {
+        uint64x2_t x;
+
+        __builtin_prefetch(pa + ALT_MEM_PLD_AHEAD);
+        __builtin_prefetch(pb + ALT_MEM_PLD_AHEAD);
+        x = veorq_u64(vld1q_u64((const uint64_t *)pa), vld1q_u64((const uint64_t *)pb));
+        x = vorrq_u64(x, veorq_u64(vld1q_u64((const uint64_t *)(pa + 16)), vld1q_u64((const uint64_t *)(pb + 16))));
+        x = vorrq_u64(x, veorq_u64(vld1q_u64((const uint64_t *)(pa + 32)), vld1q_u64((const uint64_t *)(pb + 32))));
+        x = vorrq_u64(x, veorq_u64(vld1q_u64((const uint64_t *)(pa + 48)), vld1q_u64((const uint64_t *)(pb + 48))));
+        if ((vgetq_lane_u64(x, 0) | vgetq_lane_u64(x, 1)) != 0)
+        {
+            break;
+        }
+        pa += 64;
+        pb += 64;
+        size -= 64;
+    }
+
+    for (; size; --size, ++pa, ++pb)
+    {
+        if (*pa != *pb)
+        {
+            return *pa - *pb;
+        }
+    }
+
+    return 0;
+}
+
+#else
+
+void * alt_mem_copy(void * dst, const void * src, size_t size)
+{
+    return memcpy(dst, src, size);
+}
+
+void * alt_mem_set(void * dst, int value, size_t size)
+{
+    return memset(dst, value, size);
+}
+
+int alt_mem_cmp(const void * a, const void * b, size_t size)
+{
+    return memcmp(a, b, size);
+}
+
+#endif
+
+void alt_mem_fifo_read32(uint32_t * dst, uintptr_t fifo, size_t count)
+{
+    /* Four loads before the stores, so the bus reads are not held up by the stores */
+    while (count >= 4)
+    {
+        uint32_t w0 = alt_read_word(fifo);
+        uint32_t w1 = alt_read_word(fifo);
+        uint32_t w2 = alt_read_word(fifo);
+        uint32_t w3 = alt_read_word(fifo);
+
+        dst[0] = w0;
+        dst[1] = w1;
+        dst[2] = w2;
+        dst[3] = w3;
+        dst += 4;
+        count -= 4;
+    }
+    while (count--)
+    {
+        *dst++ = alt_read_word(fifo);
+    }
+}
+
+void alt_mem_fifo_write32(uintptr_t fifo, const uint32_t * src, size_t count)
+{
+    while (count >= 4)
+    {
+        uint32_t w0 = src[0];
+        uint32_t w1 = src[1];
+        uint32_t w2 = src[2];
+        uint32_t w3 = src[3];
+
+        alt_write_word(fifo, w0);
+        alt_write_word(fifo, w1);
+        alt_write_word(fifo, w2);
+        alt_write_word(fifo, w3);
+        src += 4;
+        count -= 4;
+    }
+    while (count--)
+    {
+        alt_write_word(fifo, *src++);
+    }
+}
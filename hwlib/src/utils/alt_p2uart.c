@@ -31,6 +31,7 @@
 ******************************************************************************/
 
 #include <stdint.h>
+#include <string.h>
 #include "alt_16550_uart.h"
 #include "alt_printf.h"
 #include "socal/hps.h"
@@ -41,25 +42,71 @@
 #define BAUD_RATE      (115200)
 #endif
 
+/* Size of the output buffer of each terminal */
+#ifndef ALT_P2UART_BUF_SIZE
+#define ALT_P2UART_BUF_SIZE (64)
+#endif
+
+/* Count of segments handed to alt_16550_fifo_writev() at once */
+#define UART_IOV_MAX   (8)
+
 typedef struct UART_INFO_s
 {
-  void (*putc_function)(char pchar, FILE * info);
+  ALT_PRINTF_STREAM_t stream;
   int    init_done;
   ALT_16550_DEVICE_t uart_ID;
   ALT_16550_HANDLE_t mUart;
+  char   buf[ALT_P2UART_BUF_SIZE];
 } UART_INFO_t;
 
 static void uart_putc(char pchar, FILE * info);
+static void uart_write(const char *buf, size_t len, FILE * info);
 static ALT_STATUS_CODE init_uart(UART_INFO_t *uartInfo);
 
-static UART_INFO_t term0_info = { uart_putc, 0, ALT_16550_DEVICE_SOCFPGA_UART0 };
+static UART_INFO_t term0_info = {
+  .stream = {
+    .putc_function  = uart_putc,
+    .write_function = uart_write,
+    .buf            = term0_info.buf,
+    .size           = ALT_P2UART_BUF_SIZE,
+    .len            = 0,
+    .flush          = ALT_PRINTF_FLUSH_CALL
+  },
+  .init_done = 0,
+  .uart_ID   = ALT_16550_DEVICE_SOCFPGA_UART0
+};
 FILE * term0 = (FILE *) &term0_info;
-static UART_INFO_t term1_info = { uart_putc, 0, ALT_16550_DEVICE_SOCFPGA_UART1 };
+static UART_INFO_t term1_info = {
+  .stream = {
+    .putc_function  = uart_putc,
+    .write_function = uart_write,
+    .buf            = term1_info.buf,
+    .size           = ALT_P2UART_BUF_SIZE,
+    .len            = 0,
+    .flush          = ALT_PRINTF_FLUSH_CALL
+  },
+  .init_done = 0,
+  .uart_ID   = ALT_16550_DEVICE_SOCFPGA_UART1
+};
 FILE * term1 = (FILE *) &term1_info;
 
 static void uart_putc(char pchar, FILE *info)
 {
+  uart_write(&pchar, 1, info);
+}
+
+/*
+ * Writes a run of characters with '\r' added before each '\n'. The run is
+ * split at the newlines into segments for a single vectored write, so the
+ * FIFO is filled in bursts instead of one call per character.
+ */
+static void uart_write(const char *buf, size_t len, FILE *info)
+{
+  static const char crlf[2] = { '\r', '\n' };
   UART_INFO_t *port_info = (UART_INFO_t *) info;
+  ALT_16550_IOVEC_t iov[UART_IOV_MAX];
+  size_t iovcnt = 0;
+  const char *nl;
 
   if (!port_info->init_done)
   {
@@ -67,9 +114,36 @@ static void uart_putc(char pchar, FILE *info)
     init_uart(port_info);
   }
 
-  if (pchar=='\n') uart_putc('\r', info);
-  alt_16550_fifo_write_safe(&port_info->mUart, &pchar, 1, 1); 
+  while (len)
+  {
+    nl = memchr(buf, '\n', len);
+    if (nl == NULL)
+    {
+      iov[iovcnt].buffer = buf;
+      iov[iovcnt++].count = len;
+      break;
+    }
+    if (nl != buf)
+    {
+      iov[iovcnt].buffer = buf;
+      iov[iovcnt++].count = nl - buf;
+    }
+    iov[iovcnt].buffer = crlf;
+    iov[iovcnt++].count = 2;
+    len -= nl + 1 - buf;
+    buf = nl + 1;
+
+    if (iovcnt > UART_IOV_MAX - 2)
+    {
+      alt_16550_fifo_writev(&port_info->mUart, iov, iovcnt, true);
+      iovcnt = 0;
+    }
+  }
 
+  if (iovcnt)
+  {
+    alt_16550_fifo_writev(&port_info->mUart, iov, iovcnt, true);
+  }
 }
 
 static ALT_STATUS_CODE init_uart(UART_INFO_t *uartInfo)
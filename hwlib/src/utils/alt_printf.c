@@ -40,85 +40,223 @@
 #include <stdint.h>
 #endif  /* __cplusplus */
 
+#include <string.h>
 #include "alt_printf.h"
+#include "alt_printf_num.h"
 
 __attribute__((weak)) FILE *term0 = NULL;
 __attribute__((weak)) FILE *term1 = NULL;
 
+/*
+ * The newlib puts(), fwrite() and fprintf() are only replaced when alt_printf
+ * is the printf (PRINTF_UART). Otherwise they stay with newlib, e.g. for
+ * semihosting, and the streams are used through the alt_ functions.
+ */
+#if defined(PRINTF_UART)
 int puts(const char *str)
 {
     return alt_printf("%s",str);
 }
+#endif
 
-size_t fwrite(const void *ptr, size_t size, size_t count, FILE *stream)
+/** @Function Description: Hands the buffered characters of a stream to its write function
+  * @API Type:              Internal
+  * @param pinfo            ALT_PRINTF_STREAM_t structure
+  * @return                 None
+  */
+static void stream_flush(ALT_PRINTF_STREAM_t *pinfo)
 {
-    ALT_PRINTF_MEM_INFO_t *pinfo = (ALT_PRINTF_MEM_INFO_t *)stream;
-    int index = 0;
-      
-    while (index < (size * count))
+    if (pinfo->len)
     {
-       pinfo->putc_function(*(char *)((char *)ptr + index),stream);
-       index++;
-    }       
+      pinfo->write_function(pinfo->buf, pinfo->len, (FILE *)pinfo);
+      pinfo->len = 0;
+    }
+}
+
+/** @Function Description: Writes a run of characters to a stream. Runs that do not fit
+  *                         in the buffer go to the write function directly after a flush
+  * @API Type:              Internal
+  * @param pinfo            ALT_PRINTF_STREAM_t structure
+  * @param stg              characters to be written
+  * @param len              count of characters
+  * @return                 None
+  */
+static void stream_write(ALT_PRINTF_STREAM_t *pinfo, const char *stg, size_t len)
+{
+    if (pinfo->write_function == NULL)
+    {
+      while (len--)
+      {
+        pinfo->putc_function(*stg++, (FILE *)pinfo);
+      }
+      return;
+    }
+
+    if (len > (pinfo->size - pinfo->len))
+    {
+      stream_flush(pinfo);
+      if (len > pinfo->size)
+      {
+        pinfo->write_function(stg, len, (FILE *)pinfo);
+        return;
+      }
+    }
+    memcpy(pinfo->buf + pinfo->len, stg, len);
+    pinfo->len += len;
+
+    if ((pinfo->flush == ALT_PRINTF_FLUSH_LINE) && (memchr(stg, '\n', len) != NULL))
+    {
+      stream_flush(pinfo);
+    }
+}
+
+/** @Function Description: Flush point at the end of a print or fwrite call
+  * @API Type:              Internal
+  * @param pinfo            ALT_PRINTF_STREAM_t structure
+  * @return                 None
+  */
+static void stream_end_call(ALT_PRINTF_STREAM_t *pinfo)
+{
+    if ((pinfo->write_function != NULL) && (pinfo->flush == ALT_PRINTF_FLUSH_CALL))
+    {
+      stream_flush(pinfo);
+    }
+}
+
+/** @Function Description: Hands the buffered characters of a stream to its sink
+  * @API Type:              External
+  * @param stream           ALT_PRINTF_STREAM_t structure
+  * @return                 0
+  */
+int alt_fflush(FILE *stream)
+{
+    ALT_PRINTF_STREAM_t *pinfo = (ALT_PRINTF_STREAM_t *)stream;
+
+    if (pinfo->write_function != NULL)
+    {
+      stream_flush(pinfo);
+    }
+    return 0;
+}
+
+size_t alt_fwrite(const void *ptr, size_t size, size_t count, FILE *stream)
+{
+    ALT_PRINTF_STREAM_t *pinfo = (ALT_PRINTF_STREAM_t *)stream;
+
+    stream_write(pinfo, (const char *)ptr, size * count);
+    stream_end_call(pinfo);
 
     return size*count;
 }
 
-/** @Function Description: Writes a character to memory buffer specified in info structure
+#if defined(PRINTF_UART)
+size_t fwrite(const void *ptr, size_t size, size_t count, FILE *stream)
+{
+    return alt_fwrite(ptr, size, count, stream);
+}
+#endif
+
+/* Memory sink of alt_snprintf() and alt_sprintf(), unbuffered so each run is copied straight to the destination */
+typedef struct MEM_INFO_s
+{
+    ALT_PRINTF_STREAM_t stream;
+    char *toptr;
+    char *maxptr;   /* end of the room for characters, if bounded */
+    bool bounded;   /* false for alt_sprintf(), which has no limit */
+} MEM_INFO_t;
+
+/** @Function Description: Writes a run of characters to memory buffer specified in info structure
   * @API Type:              Internal
-  * @param pchar            character to be written
-  * @param info             ALT_PRINTF_MEM_INFO_t structure
-  * @return                 None 
+  * @param stg              characters to be written
+  * @param len              count of characters
+  * @param info             MEM_INFO_t structure
+  * @return                 None
   */
-static void mem_putc(char pchar, FILE *info)
+static void mem_write(const char *stg, size_t len, FILE *info)
 {
-    ALT_PRINTF_MEM_INFO_t *pmem = ( ALT_PRINTF_MEM_INFO_t *)info;
-  
-    if ((pmem->toptr < pmem->maxptr) || (pmem->maxptr==NULL))
+    MEM_INFO_t *pmem = (MEM_INFO_t *)info;
+
+    /* Once the buffer is full the rest is only counted, by alt_vfprintf() */
+    if (pmem->bounded && (len > (size_t)(pmem->maxptr - pmem->toptr)))
     {
-      *(pmem->toptr) = pchar;
-      pmem->toptr++;
-    } 
-    
-    if ((pmem->toptr == pmem->maxptr) && (pmem->maxptr!=NULL))
+      len = pmem->maxptr - pmem->toptr;
+    }
+    if (len == 0)
     {
-      *(pmem->toptr)=0;
+      return;
     }
+    memcpy(pmem->toptr, stg, len);
+    pmem->toptr += len;
 }
-  
+
+/** @Function Description: Writes a character to memory buffer specified in info structure
+  * @API Type:              Internal
+  * @param pchar            character to be written
+  * @param info             MEM_INFO_t structure
+  * @return                 None
+  */
+static void mem_putc(char pchar, FILE *info)
+{
+    mem_write(&pchar, 1, info);
+}
+
+static void mem_init(MEM_INFO_t *pmem, char *to, char *maxptr, bool bounded)
+{
+    pmem->stream.putc_function=mem_putc;
+    pmem->stream.write_function=mem_write;
+    pmem->stream.buf=NULL;
+    pmem->stream.size=0;
+    pmem->stream.len=0;
+    pmem->stream.flush=ALT_PRINTF_FLUSH_CALL;
+    pmem->toptr=to;
+    pmem->maxptr=maxptr;
+    pmem->bounded=bounded;
+}
+
 int alt_snprintf(char *to, size_t n, const char *format, ...)
 {
-    ALT_PRINTF_MEM_INFO_t pmem;
+    MEM_INFO_t pmem;
     int rc;
-   
+
     va_list args;
-    va_start( args, format );    
-    
-    pmem.toptr=to;
-    pmem.maxptr=(to + n - 1);
-    pmem.putc_function=mem_putc;
+    va_start( args, format );
+
+    if (n == 0)
+    {
+      /* Nothing may be written, only count. to may be NULL */
+      mem_init(&pmem, to, to, true);
+    }
+    else
+    {
+      mem_init(&pmem, to, to + n - 1, true);
+    }
 
     rc=alt_vfprintf((FILE *)&pmem, format, args);
     va_end(args);
-     
+
+    if (n != 0)
+    {
+      *(pmem.toptr)=0;
+    }
+
     return rc;
 }
 
 int alt_sprintf(char *to, const char *format, ...)
 {
-    ALT_PRINTF_MEM_INFO_t pmem;
+    MEM_INFO_t pmem;
     int rc;
-   
+
     va_list args;
-    va_start( args, format );    
-    
-    pmem.toptr=to;
-    pmem.maxptr=NULL;   
-    pmem.putc_function=mem_putc;
+    va_start( args, format );
+
+    mem_init(&pmem, to, NULL, false);
 
     rc=alt_vfprintf((FILE *)&pmem, format, args);
     va_end(args);
 
+    *(pmem.toptr)=0;
+
     return rc;
 }
 
@@ -137,6 +275,19 @@ int alt_printf(const char *format, ...)
 }
 #endif
 
+int alt_fprintf(FILE *stream, const char *format, ...)
+{
+    int rc;
+ 
+    va_list args;
+    va_start( args, format );
+    rc=alt_vfprintf(stream, format, args);
+    va_end(args);
+
+    return rc;
+}
+
+#if defined(PRINTF_UART)
 int fprintf(FILE *stream, const char *format, ...)
 {
     int rc;
@@ -148,21 +299,61 @@ int fprintf(FILE *stream, const char *format, ...)
 
     return rc;
 }
+#endif
 
-/** @Function Description: Writes a character to function specified in pinfo structure
+/** @Function Description: Writes a character to the stream specified in pinfo structure
     * @API Type:              Internal
     * @param c                character to be written
-    * @param pinfo            ALT_PRINTF_MEM_INFO_t structure
+    * @param pinfo            ALT_PRINTF_STREAM_t structure
     * @param count            var to keep track of characters written
     * @return                 None 
     */
-static void cput(ALT_PRINTF_MEM_INFO_t *pinfo, int * count, char c)
+static void cput(ALT_PRINTF_STREAM_t *pinfo, int * count, char c)
 {
     if (pinfo!=NULL) 
     {
-      pinfo->putc_function(c,(FILE *)pinfo);
+      stream_write(pinfo, &c, 1);
+    }
+    *count+=1;
+}
+
+/** @Function Description: Writes a run of characters to the stream specified in pinfo structure
+    * @API Type:              Internal
+    * @param pinfo            ALT_PRINTF_STREAM_t structure
+    * @param count            var to keep track of characters written
+    * @param stg              characters to be written
+    * @param len              count of characters, nothing is written when <= 0
+    * @return                 None
+    */
+static void cputs(ALT_PRINTF_STREAM_t *pinfo, int * count, const char *stg, int len)
+{
+    if (len <= 0) return;
+    if (pinfo!=NULL)
+    {
+      stream_write(pinfo, stg, (size_t)len);
+    }
+    *count+=len;
+}
+
+/** @Function Description: Writes a character repeatedly, for padding
+    * @API Type:              Internal
+    * @param pinfo            ALT_PRINTF_STREAM_t structure
+    * @param count            var to keep track of characters written
+    * @param c                ' ' or '0'
+    * @param len              count of characters, nothing is written when <= 0
+    * @return                 None
+    */
+static void cpad(ALT_PRINTF_STREAM_t *pinfo, int * count, char c, int len)
+{
+    static const char spaces[16] = "                ";
+    static const char zeros[16] = "0000000000000000";
+    const char *stg = (c == '0') ? zeros : spaces;
+
+    while (len > 0)
+    {
+      cputs(pinfo, count, stg, (len > 16) ? 16 : len);
+      len -= 16;
     }
-    if (c!=0) *count+=1;
 }
 
 /** @Function Description: returns the next character from the format string and increments index
@@ -199,106 +390,47 @@ static char getdec(const char *format,int * index, int * val, char c)
    return c;
 }
 
-#ifdef ALT_PRINTF_NO_DIVIDE
-/** @Function Description: Hex(Integer) to BCD(Binary Coded Decimal) to Ascii
+/*
+ * Integer conversion engine, see alt_printf_num.h:
+ * ALT_PRINTF_NO_DIVIDE  double dabble, no division
+ * ALT_PRINTF_DIVIDE     64 bit % 10 and / 10 per digit
+ * default               reciprocal multiplication with a two digit table
+ */
+#if defined(ALT_PRINTF_NO_DIVIDE)
+  #define ALT_PRINTF_UTOA alt_printf_utoa_bcd
+  #define ALT_PRINTF_XTOA alt_printf_xtoa_loop
+#elif defined(ALT_PRINTF_DIVIDE)
+  #define ALT_PRINTF_UTOA alt_printf_utoa_div
+  #define ALT_PRINTF_XTOA alt_printf_xtoa_loop
+#else
+  #define ALT_PRINTF_UTOA alt_printf_utoa_fast
+  #define ALT_PRINTF_XTOA alt_printf_xtoa_fast
+#endif
+
+/** @Function Description: Hex(Integer) to Ascii
     * @API Type:              Internal
     * @param val              int64_t value to convert to ascii string
-    * @param stg              string to be returned
+    * @param stg              string to be returned. must be at least 21 bytes.
     * @param isint            if 1 indicates val is signed, otherwise unsigned
     * @return                 number of characters in string 
     */
 static int int_to_asc(int64_t val,char * stg,int isint)
 {
-    uint64_t bcd[3],carry[3];
-    int i, j, k,count=0,count2=0,startcount=0;
-  
+    uint64_t uval=(uint64_t)val;
+    int count;
+
     if (isint && (val < 0)) 
     {
-      val = ~val + 1;
+      uval = ~uval + 1;
     }
-   
-    bcd[0]=(uint64_t)val;
-    bcd[1]=bcd[2]=(uint64_t)0;
-    /*shift the bits in the BCD number left one by one*/
-    for (i=0;i<64;i++)
-    {
-      for (j=0;j<3;j++)
-      {
-        carry[j]=bcd[j] >> 63;
-        
-        bcd[j] <<= 1;
-        /*for speed do not do the next part if the value is 0*/
-        if ((j > 0) && (bcd[j] || carry[j-1])) 
-        {
-          /*add in the carry from the next lower bcd val*/
-          bcd[j] |= carry[j - 1];
 
-          /*if a (hex) digit is over 4, add 3 to it*/
-          if (i != 63)
-          {
-            for (k = 0; k<64; k += 4) 
-            {
-              if ((bcd[j] & ((uint64_t)0xf << k)) > ((uint64_t)4 << k)) 
-              {
-                bcd[j] += ((uint64_t)3 << k);
-              }
-            }
-          }
-        }
-      }
-    }
-     
-    /*now there is a BCD value in B[2]B[1].  Change it to ascii excluding leading 0's. */
-    while (count2 < 32)
-    {
-      stg[count] = '0' + ((bcd[2 - (count2>=16)] >> (32+28)) & 0xf);
-      bcd[2 - (count2>=16)] <<= 4;
-      if ((stg[count]!='0') || startcount)
-      {
-        count+=1; 
-        startcount=1;
-      }
-      count2++;
-    }    
+    /* Zero only gets here with a precision of 0, which prints no digits */
+    count=(uval!=0) ? ALT_PRINTF_UTOA(uval,stg) : 0;
     stg[count]=0;
-          
-    /*return the count not including the terminating 0          */
+
     return count;
 }
 
-#else
-/** @Function Description: Hex(Integer) to Ascii
-    * @API Type:              Internal
-    * @param val              int64_t value to convert to ascii string
-    * @param stg              string to be returned. must be at least 21 bytes.
-    * @param isint            if 1 indicates val is signed, otherwise unsigned
-    * @return                 number of characters in string 
-    */
-static int int_to_asc(int64_t val,char * stg,int isint)
-{
-    int count=20,i=0;
-    
-    if (isint && (val < 0)) 
-    {
-      val = ~val + 1;
-    }
-    
-    while ((uint64_t)val > 0)
-    {
-      stg[count]='0' + ((uint64_t)val%10);
-      val=(uint64_t)val/10;
-      count--;
-    }
-    for (i=0;i<(20-count);i++)
-    {
-      stg[i]=stg[ count + 1 + i];
-    }
-    stg[i]=0;
-    
-    return (20-count);
-}     
-#endif
-
 /** @Function Description: Hex to to Ascii
     * @API Type:              Internal
     * @param val              int64_t value to convert to ascii string
@@ -310,31 +442,11 @@ static int int_to_asc(int64_t val,char * stg,int isint)
     */
 static int hex_to_asc(int64_t val,char * stg,char specifier,int lengthmod)
 {
-    int count=0,count2=0,startcount=0;  
-    int digits=8,digitvalue;
-       
-    if (specifier=='p') specifier='x';   
-    if (lengthmod==2)
-    {
-      digits=16;
-    }
-    while (count2 < digits)
-    {
-      digitvalue=(int)(val>>((digits-count2)*4-4)) & 0xf;
-      stg[count]='0' + digitvalue;
-      if (digitvalue > 9)
-      {
-        stg[count] = 'A' + (digitvalue - 10) + specifier - 'X';
-      }
-      if ((stg[count]!='0') || startcount)
-      {
-        count+=1; 
-        startcount=1;
-      }
-      count2++;
-    }  
+    int count;
+
+    count=(val!=0) ? ALT_PRINTF_XTOA((uint64_t)val,stg,(lengthmod==2) ? 16 : 8,specifier=='X') : 0;
     stg[count]=0;
-            
+
     return count;
 }
   
@@ -351,10 +463,10 @@ static int hex_to_asc(int64_t val,char * stg,char specifier,int lengthmod)
     * @param args             argument list 
     * @return                 0 for success, 1 for failure 
     */  
-static int printarg(ALT_PRINTF_MEM_INFO_t *pinfo,char specifier,char flag,int width,int length,int precision,int dot,int * c_count,va_list * args)
+static int printarg(ALT_PRINTF_STREAM_t *pinfo,char specifier,char flag,int width,int length,int precision,int dot,int * c_count,va_list * args)
 {
     char ostg[32],pad=' ',leadchar=0,leadchar2=0;
-    int count,i,adder=0,isint=1;
+    int count,adder=0,isint=1;
     int max;
     int64_t val = 0;
     char * stgarg = NULL;
@@ -460,9 +572,9 @@ static int printarg(ALT_PRINTF_MEM_INFO_t *pinfo,char specifier,char flag,int wi
       {
         cput(pinfo, c_count, leadchar2); 
       }
-      for (i=0;((i<(width-max-adder)) && (flag!='-'));i++) 
+      if (flag!='-')
       {
-        cput(pinfo, c_count, pad);
+        cpad(pinfo, c_count, pad, width-max-adder);
       }
       if ((leadchar!=0) && (pad==' '))
       {
@@ -472,18 +584,12 @@ static int printarg(ALT_PRINTF_MEM_INFO_t *pinfo,char specifier,char flag,int wi
       {
         cput(pinfo, c_count, leadchar2);   
       }            
-      for (i=0;i<(precision-count);i++) 
+      cpad(pinfo, c_count, '0', precision-count);
+      cputs(pinfo, c_count, ostg, count);
+      if (flag=='-')
       {
-        cput(pinfo, c_count, '0');
+        cpad(pinfo, c_count, ' ', width-max-adder);
       }
-      for (i=0;i<count;i++)
-      {
-        cput(pinfo, c_count, ostg[i]);
-      }
-      for (i=0;((i<(width-max-adder)) && (flag=='-'));i++) 
-      {
-        cput(pinfo, c_count, ' ');    
-      }  
     }
     else if ((specifier=='s') || (specifier=='c'))
     {
@@ -514,27 +620,17 @@ static int printarg(ALT_PRINTF_MEM_INFO_t *pinfo,char specifier,char flag,int wi
         max=precision;
       }
       
-      for (i=0;((i<(width-max-adder)) && (flag!='-'));i++) 
+      if (flag!='-')
       {
-         cput(pinfo, c_count, pad);
-      }           
-       
-      for (i=0;(i<count) && ((i<precision) || (dot==0));i++) 
-      {
-        if (specifier=='c')
-        {
-          cput(pinfo, c_count, ostg[i]);
-        }
-        else
-        {
-          cput(pinfo, c_count, stgarg[i]);
-        }
+        cpad(pinfo, c_count, pad, width-max-adder);
       }
-      
-      for (i=0;((i<(width-max-adder)) && (flag=='-'));i++) 
+
+      cputs(pinfo, c_count, (specifier=='c') ? ostg : stgarg, max);
+
+      if (flag=='-')
       {
-        cput(pinfo, c_count, ' ');    
-      }   
+        cpad(pinfo, c_count, ' ', width-max-adder);
+      }
     }
     else
     {
@@ -550,16 +646,29 @@ static int printarg(ALT_PRINTF_MEM_INFO_t *pinfo,char specifier,char flag,int wi
     encountered.
     * @return                 #characters output for success, -1 for failure 
     */  
-int alt_vfprintf(FILE *stream, const char *format, va_list args)
+int alt_vfprintf(FILE *stream, const char *format, va_list ap)
 {
-    ALT_PRINTF_MEM_INFO_t *pinfo = (ALT_PRINTF_MEM_INFO_t *)stream;
-    int index=0,length;
+    ALT_PRINTF_STREAM_t *pinfo = (ALT_PRINTF_STREAM_t *)stream;
+    int index=0,length,run;
     int count=0,dot;
     char c,flag;
     int width,precision;
-       
+    va_list args;
+
+    /* printarg() takes a pointer to the list, use a local copy so that also works where va_list is an array type */
+    va_copy(args, ap);
+
     while (1)
     {
+       /* Literal text up to the next conversion goes out as one run */
+       run=0;
+       while ((format[index+run]!='%') && (format[index+run]!=0))
+       {
+         run++;
+       }
+       cputs(pinfo,&count,format+index,run);
+       index+=run;
+
        c  = nextchar(format,&index);
          
        if (c=='%')
@@ -616,13 +725,11 @@ int alt_vfprintf(FILE *stream, const char *format, va_list args)
           
           if (printarg(pinfo,c,flag,width,length,precision,dot,&count,&args))
           {
+            if (pinfo!=NULL) stream_end_call(pinfo);
+            va_end(args);
             return -1;
           }            
        }
-       else 
-       {
-         cput(pinfo,&count,c);
-       }
        
        if (c==0)
        {
@@ -630,7 +737,57 @@ int alt_vfprintf(FILE *stream, const char *format, va_list args)
        }
     }
     
+    if (pinfo!=NULL) stream_end_call(pinfo);
+    va_end(args);
     return count;
 }
           
  
+
+/** @Function Description: vprintf routine for a pre-parsed format string. Only runs the
+    conversions, the parsing was done at compile time by alt_printf.hpp
+    * @param format           the format string the operations were parsed from
+    * @param ops              operations, ended by one with len and specifier both 0
+    * @return                 #characters output for success, -1 for failure
+    */
+int alt_vfprintf_ops(FILE *stream, const char *format, const ALT_PRINTF_OP_t *ops, va_list ap)
+{
+    ALT_PRINTF_STREAM_t *pinfo = (ALT_PRINTF_STREAM_t *)stream;
+    int count=0,width,precision,rc=0;
+    va_list args;
+
+    va_copy(args, ap);
+
+    for (; (ops->len!=0) || (ops->specifier!=0); ops++)
+    {
+      if (ops->len!=0)
+      {
+        cputs(pinfo,&count,format+ops->offset,ops->len);
+        continue;
+      }
+
+      width=(ops->width==ALT_PRINTF_OP_STAR) ? va_arg( args, int ) : ops->width;
+      precision=(ops->precision==ALT_PRINTF_OP_STAR) ? va_arg( args, int ) : ops->precision;
+      if (printarg(pinfo,ops->specifier,ops->flag,width,ops->length,precision,ops->dot,&count,&args))
+      {
+        rc=-1;
+        break;
+      }
+    }
+
+    if (pinfo!=NULL) stream_end_call(pinfo);
+    va_end(args);
+    return (rc==0) ? count : rc;
+}
+
+int alt_fprintf_ops(FILE *stream, const char *format, const ALT_PRINTF_OP_t *ops, ...)
+{
+    int rc;
+
+    va_list args;
+    va_start( args, ops );
+    rc=alt_vfprintf_ops(stream, format, ops, args);
+    va_end(args);
+
+    return rc;
+}
@@ -0,0 +1,302 @@
+/******************************************************************************
+*
+* Copyright 2017 Altera Corporation. All Rights Reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+*
+* 2. Redistributions in binary form must reproduce the above copyright notice,
+* this list of conditions and the following disclaimer in the documentation
+* and/or other materials provided with the distribution.
+*
+* 3. Neither the name of the copyright holder nor the names of its contributors
+* may be used to endorse or promote products derived from this software without
+* specific prior written permission.
+* 
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+******************************************************************************/
+
+#include <string.h>
+#include "alt_printf_num.h"
+
+/* Low 64 bits of the 128 bit product shifted down by 64, from 32 x 32 bit multiplies (UMULL) */
+static inline uint64_t mulhi64(uint64_t a, uint64_t b)
+{
+    uint64_t p00 = (uint64_t)(uint32_t)a * (uint32_t)b;
+    uint64_t p01 = (uint64_t)(uint32_t)a * (uint32_t)(b >> 32);
+    uint64_t p10 = (uint64_t)(uint32_t)(a >> 32) * (uint32_t)b;
+    uint64_t p11 = (uint64_t)(uint32_t)(a >> 32) * (uint32_t)(b >> 32);
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+
+    return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+/*
+ * Division by constants as a multiply by the rounded up reciprocal and a
+ * shift, exact over the whole input range:
+ * - x / 100 for 32 bit x: 0x51eb851f = 2^37 / 100 rounded up
+ * - x / 10^8 for 64 bit x: 0xabcc77118461cefd = 2^90 / 10^8 rounded up
+ */
+#define DIV100(x)   ((uint32_t)(((uint64_t)(x) * 0x51eb851fUL) >> 37))
+#define DIV1E8(x)   (mulhi64((x), 0xabcc77118461cefdULL) >> 26)
+
+static const char digits2[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char hexdigits[2][16] =
+{
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' },
+    { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' }
+};
+
+int alt_printf_utoa_div(uint64_t val, char *stg)
+{
+    char tmp[ALT_PRINTF_UTOA_MAX];
+    int count = ALT_PRINTF_UTOA_MAX;
+
+    do
+    {
+      tmp[--count] = '0' + (val % 10);
+      val = val / 10;
+    } while (val > 0);
+    memcpy(stg, &tmp[count], ALT_PRINTF_UTOA_MAX - count);
+
+    return ALT_PRINTF_UTOA_MAX - count;
+}
+
+int alt_printf_utoa_bcd(uint64_t val, char *stg)
+{
+    uint64_t bcd[3],carry[3];
+    int i, j, k,count=0,count2=0,startcount=0;
+
+    bcd[0]=val;
+    bcd[1]=bcd[2]=(uint64_t)0;
+    /*shift the bits in the BCD number left one by one*/
+    for (i=0;i<64;i++)
+    {
+      for (j=0;j<3;j++)
+      {
+        carry[j]=bcd[j] >> 63;
+
+        bcd[j] <<= 1;
+        /*for speed do not do the next part if the value is 0*/
+        if ((j > 0) && (bcd[j] || carry[j-1]))
+        {
+          /*add in the carry from the next lower bcd val*/
+          bcd[j] |= carry[j - 1];
+
+          /*if a (hex) digit is over 4, add 3 to it*/
+          if (i != 63)
+          {
+            for (k = 0; k<64; k += 4)
+            {
+              if ((bcd[j] & ((uint64_t)0xf << k)) > ((uint64_t)4 << k))
+              {
+                bcd[j] += ((uint64_t)3 << k);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /*now there is a BCD value in B[2]B[1].  Change it to ascii excluding leading 0's. */
+    while (count2 < 32)
+    {
+      stg[count] = '0' + ((bcd[2 - (count2>=16)] >> (32+28)) & 0xf);
+      bcd[2 - (count2>=16)] <<= 4;
+      if ((stg[count]!='0') || startcount)
+      {
+        count+=1;
+        startcount=1;
+      }
+      count2++;
+    }
+    if (count == 0)
+    {
+      stg[count++] = '0';
+    }
+
+    return count;
+}
+
+/* Up to 8 digits of a 32 bit value, two per step, written backwards ending at end */
+static inline char *u32_to_asc_rev(uint32_t val, char *end)
+{
+    uint32_t q;
+
+    while (val >= 100)
+    {
+      q = DIV100(val);
+      end -= 2;
+      memcpy(end, &digits2[(val - q * 100) * 2], 2);
+      val = q;
+    }
+    if (val >= 10)
+    {
+      end -= 2;
+      memcpy(end, &digits2[val * 2], 2);
+    }
+    else
+    {
+      *--end = '0' + val;
+    }
+
+    return end;
+}
+
+/* Exactly 8 digits with leading zeros, val < 10^8 */
+static inline void u32_to_asc8(uint32_t val, char *stg)
+{
+    uint32_t q;
+    int i;
+
+    for (i = 6; i >= 0; i -= 2)
+    {
+      q = DIV100(val);
+      memcpy(&stg[i], &digits2[(val - q * 100) * 2], 2);
+      val = q;
+    }
+}
+
+int alt_printf_utoa_fast(uint64_t val, char *stg)
+{
+    char tmp[ALT_PRINTF_UTOA_MAX];
+    char *start;
+    uint64_t q;
+    int count;
+
+    if ((val >> 32) == 0)
+    {
+      /* Fits the 32 bit path, the common case */
+      start = u32_to_asc_rev((uint32_t)val, &tmp[ALT_PRINTF_UTOA_MAX]);
+    }
+    else
+    {
+      /* Split into groups of 8 digits, the top group is below 1845 */
+      q = DIV1E8(val);
+      u32_to_asc8((uint32_t)(val - q * 100000000), &tmp[ALT_PRINTF_UTOA_MAX - 8]);
+      start = &tmp[ALT_PRINTF_UTOA_MAX - 8];
+      if (q >= 100000000)
+      {
+        val = q;
+        q = DIV1E8(val);
+        u32_to_asc8((uint32_t)(val - q * 100000000), &tmp[ALT_PRINTF_UTOA_MAX - 16]);
+        start = &tmp[ALT_PRINTF_UTOA_MAX - 16];
+      }
+      if (q != 0)
+      {
+        start = u32_to_asc_rev((uint32_t)q, start);
+      }
+      else
+      {
+        /* Drop the leading zeros of the top group */
+        while (*start == '0')
+        {
+          start++;
+        }
+      }
+    }
+
+    count = &tmp[ALT_PRINTF_UTOA_MAX] - start;
+    memcpy(stg, start, count);
+
+    return count;
+}
+
+int alt_printf_xtoa_loop(uint64_t val, char *stg, int digits, int upper)
+{
+    int count=0,count2=0,startcount=0;
+    int digitvalue;
+
+    while (count2 < digits)
+    {
+      digitvalue=(int)(val>>((digits-count2)*4-4)) & 0xf;
+      stg[count]='0' + digitvalue;
+      if (digitvalue > 9)
+      {
+        stg[count] = (upper ? 'A' : 'a') + (digitvalue - 10);
+      }
+      if ((stg[count]!='0') || startcount)
+      {
+        count+=1;
+        startcount=1;
+      }
+      count2++;
+    }
+    if (count == 0)
+    {
+      stg[count++] = '0';
+    }
+
+    return count;
+}
+
+int alt_printf_xtoa_fast(uint64_t val, char *stg, int digits, int upper)
+{
+    const char *table = hexdigits[upper != 0];
+    uint32_t hi;
+    uint32_t lo;
+    int count;
+    int i;
+    int n;
+
+    if (digits < 16)
+    {
+      val &= ((uint64_t)1 << (digits * 4)) - 1;
+    }
+    hi = (uint32_t)(val >> 32);
+    lo = (uint32_t)val;
+
+    /* Significant digits from the leading zero count (CLZ) */
+    if (hi != 0)
+    {
+      count = 16 - (__builtin_clz(hi) >> 2);
+    }
+    else if (lo != 0)
+    {
+      count = 8 - (__builtin_clz(lo) >> 2);
+    }
+    else
+    {
+      count = 1;
+    }
+
+    /* Backwards from the last digit, the low word then the high word */
+    i = count;
+    for (n = (count < 8) ? count : 8; n > 0; n--)
+    {
+      stg[--i] = table[lo & 0xf];
+      lo >>= 4;
+    }
+    while (i > 0)
+    {
+      stg[--i] = table[hi & 0xf];
+      hi >>= 4;
+    }
+
+    return count;
+}
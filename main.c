@@ -40,8 +40,35 @@
 #include "socal/socal.h"
 #include "tru_logger.h"
 #include <string.h>
+#ifdef TRU_PRINTF_UART
+	#include "c5_uart.h"
+#endif
+#ifdef TRU_FRAME_UART
+	#include "tru_frame.h"
+#endif
+#ifdef TRU_LOG_RAMCON
+	#include "tru_ramcon.h"
+#endif
+#ifdef UART_BENCH
+	#include "bench_uart.h"
+#endif
+#ifdef PRINTF_BENCH
+	#include "bench_printf.h"
+#endif
+#ifdef MEM_BENCH
+	#include "bench_mem.h"
+#endif
+#ifdef COPY_BENCH
+	#include "bench_copy.h"
+#endif
 
 #ifdef SEMIHOSTING
+	#include "tru_semihost.h"
+	#ifdef SEMIHOST_BENCH
+		#include <stdlib.h>
+		#include "bench_semihost.h"
+	#endif
+
 	extern void initialise_monitor_handles(void);  // Reference function header from the external Semihosting library
 #endif
 
@@ -85,19 +112,38 @@ void hps_uart_test(ALT_16550_HANDLE_t *handle){
 
 	hps_uart_wait_empty(ALT_UART0_OFST);  // Wait for UART transmission to complete.  There may be pending UART transmissions from earlier (e.g. DEBUG_PRINTF) which use same UART, then we need to flush and wait before initialising the UART
 	hps_uart_setup(handle);               // Setup the UART controller
+	#ifdef TRU_PRINTF_UART
+		c5_uart_mode_refresh(C5_UART0_BASE_ADDR);  // The FIFO mode was changed behind the back of the newlib _write() UART writer, let it re-read the mode
+	#endif
 	hps_uart_write_hello(handle);         // Once the UART is set up, we can use the HWLib alt_16550_fifo_write or alt_16550_fifo_write_safe functions to transmit messages
 }
 
 void wait_forever(void){
 	DEBUG_PRINTF("DEBUG: Starting infinity loop"_NL);
 
+	#if defined(SEMIHOSTING) && defined(TRU_SEMIHOST_BATCH)
+		tru_semihost_flush();  // Send the batched output before idling
+	#endif
+
 	volatile unsigned char i = 1;
-	while(i);
+	while(i){
+		#ifdef TRU_LOG_DEFERRED
+			tru_log_drain();  // Idle time, send out the pending log records
+		#endif
+	}
 }
 
 int main(int argc, char **argv){
 	#ifdef SEMIHOSTING
 		initialise_monitor_handles();  // Initialise Semihosting
+
+		#ifdef SEMIHOST_BENCH
+			bench_semihost_run();  // Before any hardware access, so it also runs in QEMU.  Exits after
+			exit(0);
+		#endif
+		#ifdef TRU_SEMIHOST_BATCH
+			tru_semihost_stdout_attach();  // Batch the printf output, see tru_semihost.h
+		#endif
 	#endif
 
 	ALT_16550_HANDLE_t handle;  // HWLib UART handle
@@ -105,7 +151,35 @@ int main(int argc, char **argv){
 
 	hps_uart_test(&handle);
 
-	wait_forever();
+	#ifdef TRU_FRAME_UART
+		tru_frame_init(&handle);  // Send the frames through the HWLib handle from now on
+	#endif
+
+	#ifdef TRU_LOG_RAMCON
+		tru_ramcon_replay();  // Send the log kept in RAM from before the last reset, if any
+	#endif
+
+	#ifdef UART_BENCH
+		bench_uart_run(&handle);  // Measure the UART transmit paths, see bench_uart.c
+	#endif
+
+	#ifdef PRINTF_BENCH
+		bench_printf_run();  // Measure the alt_printf integer conversions, see bench_printf.c
+	#endif
+
+	#ifdef MEM_BENCH
+		bench_mem_run();  // Measure the alt_mem.h memory primitives against newlib, see bench_mem.c
+	#endif
+
+	#ifdef COPY_BENCH
+		bench_copy_run();  // Calibrate and check tru_copy(), see bench_copy.c
+	#endif
+
+	#ifndef HOST_SIM
+		wait_forever();
+	#elif defined(TRU_LOG_DEFERRED)
+		tru_log_flush();  // Send the pending log records before exiting
+	#endif
 
 	return 0;
 }
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2023 Truong Hy
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# Version: 20261017
+#
+# Demultiplexer for the tru_frame channel layer (util/include/tru_frame.h).
+# Splits the UART byte stream on the 0x00 delimiters, COBS decodes and CRC
+# checks each frame and sends the data to its channel:
+#   text channel (0)       written to stdout
+#   tru_log channel (1)    decoded with tru_log_decode.py when --elf is given,
+#                          otherwise dumped in hex
+#   other channels         appended to <dir>/ch<N>.bin with --telemetry-dir,
+#                          otherwise dumped in hex
+# Bytes which do not form a valid frame, e.g. output sent before the framing
+# was enabled, are written to stdout as they are.  A summary is printed to
+# stderr at the end.
+#
+# Usage:
+#   tru_frame_demux.py --port /dev/ttyUSB0 [--baud 115200] [--elf program.elf] [--telemetry-dir out]
+#   tru_frame_demux.py [--elf program.elf] < capture.bin
+#
+# Reading a serial port needs the pyserial package.
+
+import argparse
+import os
+import sys
+
+CH_TEXT = 0
+CH_TRU_LOG = 1
+CRC_INIT = 0xffff
+
+
+def crc16(data, crc=CRC_INIT):
+	"""CRC-16/CCITT-FALSE."""
+	for b in data:
+		x = ((crc >> 8) ^ b) & 0xff
+		x ^= x >> 4
+		crc = ((crc << 8) ^ (x << 12) ^ (x << 5) ^ x) & 0xffff
+	return crc
+
+
+def cobs_decode(data):
+	"""Decode a COBS block without its delimiter, None when malformed."""
+	out = bytearray()
+	i = 0
+	while i < len(data):
+		code = data[i]
+		if code == 0 or i + code > len(data):
+			return None
+		out += data[i + 1:i + code]
+		i += code
+		if code != 0xff and i < len(data):
+			out.append(0)
+	return bytes(out)
+
+
+class Demux:
+	def __init__(self, out, log_decoder=None, telemetry_dir=None):
+		self.out = out
+		self.log_decoder = log_decoder
+		self.telemetry_dir = telemetry_dir
+		self.files = {}
+		self.buf = bytearray()
+		self.frames = {}
+		self.bad = 0
+
+	def feed(self, data):
+		self.buf += data
+		while True:
+			end = self.buf.find(0)
+			if end < 0:
+				break
+			raw = bytes(self.buf[:end])
+			del self.buf[:end + 1]
+			if raw:
+				self.frame(raw)
+		self.out.flush()
+
+	def frame(self, raw):
+		body = cobs_decode(raw)
+		if body is None or len(body) < 3 or crc16(body[:-2]) != body[-2] | body[-1] << 8:
+			self.bad += 1
+			self.out.write(raw.decode("latin-1"))
+			return
+		ch = body[0]
+		data = body[1:-2]
+		self.frames[ch] = self.frames.get(ch, 0) + 1
+
+		if ch == CH_TEXT:
+			self.out.write(data.decode("latin-1"))
+		elif ch == CH_TRU_LOG and self.log_decoder:
+			self.log_decoder.feed(data)
+		elif self.telemetry_dir:
+			if ch not in self.files:
+				self.files[ch] = open(os.path.join(self.telemetry_dir, "ch%u.bin" % ch), "ab")
+			self.files[ch].write(data)
+		else:
+			self.out.write("<ch%u: %s>\n" % (ch, data.hex()))
+
+	def close(self):
+		for f in self.files.values():
+			f.close()
+		summary = ", ".join("ch%u %u" % (ch, n) for ch, n in sorted(self.frames.items()))
+		sys.stderr.write("frames: %s; bad frames: %u\n" % (summary or "none", self.bad))
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Demultiplex tru_frame channels")
+	parser.add_argument("--port", help="serial port to read, default is to read stdin")
+	parser.add_argument("--baud", type=int, default=115200, help="serial port baud rate")
+	parser.add_argument("--elf", help="program ELF file, to decode the tru_log channel")
+	parser.add_argument("--telemetry-dir", help="directory for the binary channel files")
+	args = parser.parse_args()
+
+	log_decoder = None
+	if args.elf:
+		import tru_log_decode
+		log_decoder = tru_log_decode.Decoder(tru_log_decode.Elf(args.elf), sys.stdout)
+	if args.telemetry_dir:
+		os.makedirs(args.telemetry_dir, exist_ok=True)
+	demux = Demux(sys.stdout, log_decoder, args.telemetry_dir)
+
+	if args.port:
+		import serial
+		src = serial.Serial(args.port, args.baud, timeout=0.1)
+	else:
+		src = sys.stdin.buffer
+
+	try:
+		while True:
+			data = src.read(256) if args.port else src.read1(256)
+			if not data:
+				if args.port:
+					continue
+				break
+			demux.feed(data)
+	except KeyboardInterrupt:
+		pass
+	demux.close()
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2023 Truong Hy
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# Version: 20261017
+#
+# Decoder for the tru_logger deferred mode (TRU_LOG_DEFERRED).  Rebuilds the
+# log text from the binary records sent by tru_log_drain(), using the format
+# strings in the tru_log_fmt section of the program ELF.  Bytes which are not
+# part of a record, e.g. normal printf output on the same UART, are passed
+# through as they are.
+#
+# Usage:
+#   tru_log_decode.py program.elf --port /dev/ttyUSB0 [--baud 115200]
+#   tru_log_decode.py program.elf < capture.bin
+#
+# Reading a serial port needs the pyserial package.
+
+import argparse
+import re
+import struct
+import sys
+
+HDR_MARK = 0xa
+ARGS_MAX = 8
+ID_DROPPED = 0xffffff
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Elf:
+	"""Minimal little endian ELF32/ELF64 section reader."""
+
+	def __init__(self, path):
+		with open(path, "rb") as f:
+			self.data = f.read()
+		if self.data[:4] != b"\x7fELF" or self.data[5] != 1:
+			raise ValueError("not a little endian ELF file: " + path)
+		is64 = self.data[4] == 2
+		if is64:
+			shoff, = struct.unpack_from("<Q", self.data, 0x28)
+			shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3a)
+		else:
+			shoff, = struct.unpack_from("<I", self.data, 0x20)
+			shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2e)
+
+		self.sections = []
+		for i in range(shnum):
+			off = shoff + i * shentsize
+			if is64:
+				name, stype, flags, addr, offset, size = struct.unpack_from("<IIQQQQ", self.data, off)
+			else:
+				name, stype, flags, addr, offset, size = struct.unpack_from("<IIIIII", self.data, off)
+			self.sections.append([name, stype, flags, addr, offset, size])
+		strtab = self.sections[shstrndx]
+		for s in self.sections:
+			end = self.data.index(b"\0", strtab[4] + s[0])
+			s[0] = self.data[strtab[4] + s[0]:end].decode()
+
+	def section(self, *names):
+		for s in self.sections:
+			if s[0] in names:
+				return self.data[s[4]:s[4] + s[5]]
+		return None
+
+	def cstring(self, addr):
+		"""The NUL terminated string at a load address, or None."""
+		for name, stype, flags, saddr, offset, size in self.sections:
+			if flags & SHF_ALLOC and stype != SHT_NOBITS and saddr <= addr < saddr + size:
+				start = offset + addr - saddr
+				end = self.data.index(b"\0", start)
+				return self.data[start:end].decode("latin-1")
+		return None
+
+
+FMT_SPEC = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaAn%])")
+
+
+def format_record(elf, fmt, args):
+	"""Format a C printf format string with 32 bit argument words."""
+	args = list(args)
+
+	def next_arg():
+		return args.pop(0) if args else 0
+
+	def repl(m):
+		flags, width, prec, length, conv = m.groups()
+		if conv == "%":
+			return "%"
+		if width == "*":
+			width = str(struct.unpack("<i", struct.pack("<I", next_arg()))[0])
+		if prec == "*":
+			prec = str(next_arg())
+		spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+		value = next_arg()
+		if conv in "di":
+			return (spec + "d") % struct.unpack("<i", struct.pack("<I", value))[0]
+		if conv in "uoxX":
+			return (spec + ("d" if conv == "u" else conv)) % value
+		if conv == "c":
+			return (spec + "c") % chr(value & 0xff)
+		if conv == "p":
+			return (spec + "s") % ("0x%x" % value)
+		if conv == "s":
+			s = elf.cstring(value)
+			return (spec + "s") % (s if s is not None else "<0x%08x>" % value)
+		return "<%%%s not supported>" % conv
+
+	return FMT_SPEC.sub(repl, fmt)
+
+
+class Decoder:
+	def __init__(self, elf, out):
+		self.elf = elf
+		self.out = out
+		self.fmt = elf.section(".tru_log_fmt", "tru_log_fmt")
+		if self.fmt is None:
+			raise ValueError("no tru_log_fmt section, was the program built with TRU_LOG_DEFERRED?")
+		self.buf = bytearray()
+
+	def fmt_string(self, fmt_id):
+		if fmt_id >= len(self.fmt):
+			return None
+		end = self.fmt.index(b"\0", fmt_id)
+		return self.fmt[fmt_id:end].decode("latin-1")
+
+	def feed(self, data):
+		self.buf += data
+		while len(self.buf) >= 4:
+			hdr, = struct.unpack_from("<I", self.buf, 0)
+			nargs = (hdr >> 24) & 0xf
+			if hdr >> 28 != HDR_MARK or nargs > ARGS_MAX:
+				# Not a record, pass the byte through
+				self.out.write(chr(self.buf[0]))
+				del self.buf[0]
+				continue
+			size = 4 * (1 + nargs)
+			if len(self.buf) < size:
+				break
+			args = struct.unpack_from("<%dI" % nargs, self.buf, 4)
+			del self.buf[:size]
+
+			fmt_id = hdr & 0xffffff
+			if fmt_id == ID_DROPPED:
+				self.out.write("<tru_log: %u records dropped>\n" % args[0])
+				continue
+			fmt = self.fmt_string(fmt_id)
+			if fmt is None:
+				self.out.write("<tru_log: unknown format ID 0x%06x>\n" % fmt_id)
+				continue
+			self.out.write(format_record(self.elf, fmt, args))
+		self.out.flush()
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Decode tru_logger deferred mode records")
+	parser.add_argument("elf", help="the program ELF file")
+	parser.add_argument("--port", help="serial port to read, default is to read stdin")
+	parser.add_argument("--baud", type=int, default=115200, help="serial port baud rate")
+	args = parser.parse_args()
+
+	decoder = Decoder(Elf(args.elf), sys.stdout)
+	if args.port:
+		import serial
+		src = serial.Serial(args.port, args.baud, timeout=0.1)
+	else:
+		src = sys.stdin.buffer
+
+	try:
+		while True:
+			data = src.read(256) if args.port else src.read1(256)
+			if not data:
+				if args.port:
+					continue
+				break
+			decoder.feed(data)
+	except KeyboardInterrupt:
+		pass
+
+
+if __name__ == "__main__":
+	main()
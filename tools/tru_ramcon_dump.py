@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2023 Truong Hy
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# Version: 20261017
+#
+# Extracts the persistent RAM console (util/include/tru_ramcon.h) from a
+# memory dump, e.g. taken over JTAG after the board hung.  Finds the header
+# by its magic number, checks it and writes the ring content, oldest byte
+# first, to stdout.  With --elf the deferred log records in it are decoded
+# with tru_log_decode.py, other bytes are passed through.
+#
+# The console is the tru_ramcon symbol, to dump it with OpenOCD:
+#   arm-none-eabi-nm program.elf | grep tru_ramcon
+#   dump_image ramcon.bin <address> <TRU_RAMCON_SIZE + 24>
+#
+# Usage:
+#   tru_ramcon_dump.py ramcon.bin [--elf program.elf]
+
+import argparse
+import struct
+import sys
+
+from tru_frame_demux import crc16
+
+MAGIC = 0x4e4f4352
+HDR = struct.Struct("<6I")
+
+
+def find_console(dump):
+	"""The (seq, data) of the first valid console in the dump, or None."""
+	pos = dump.find(struct.pack("<I", MAGIC))
+	while pos >= 0:
+		if pos + HDR.size <= len(dump):
+			magic, size, seq, crc, head, head_inv = HDR.unpack_from(dump, pos)
+			start = pos + HDR.size
+			if (size and size & (size - 1) == 0 and start + size <= len(dump)
+					and crc == crc16(dump[pos:pos + 12]) and head_inv == head ^ 0xffffffff):
+				ring = dump[start:start + size]
+				off = head % size
+				data = ring[off:] + ring[:off] if head >= size else ring[:head]
+				return seq, data
+		pos = dump.find(struct.pack("<I", MAGIC), pos + 1)
+	return None
+
+
+def main():
+	parser = argparse.ArgumentParser(description="Extract the tru_ramcon console from a memory dump")
+	parser.add_argument("dump", help="binary memory dump")
+	parser.add_argument("--elf", help="program ELF file, to decode deferred log records")
+	args = parser.parse_args()
+
+	with open(args.dump, "rb") as f:
+		found = find_console(f.read())
+	if found is None:
+		sys.exit("no valid tru_ramcon console in " + args.dump)
+	seq, data = found
+	sys.stderr.write("tru_ramcon: boot %u, %u bytes\n" % (seq, len(data)))
+
+	if args.elf:
+		import tru_log_decode
+		tru_log_decode.Decoder(tru_log_decode.Elf(args.elf), sys.stdout).feed(data)
+	else:
+		sys.stdout.buffer.write(data)
+
+
+if __name__ == "__main__":
+	main()
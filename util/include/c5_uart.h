@@ -21,7 +21,7 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20231126
+	Version: 20261017
 
 	UART functions for Cyclone V SoC (HPS).
 */
@@ -34,18 +34,23 @@
 
 // UART base registers
 #define C5_UART0_BASE_ADDR         0xffc02000UL
+#define C5_UART1_BASE_ADDR         0xffc03000UL
 // UART register offsets
 #define C5_UART_RBR_THR_DLL_OFFSET 0x0UL
 #define C5_UART_LSR_OFFSET         0x14UL
+#define C5_UART_TFL_OFFSET         0x80UL
 #define C5_UART_SFE_OFFSET         0x98UL
 #define C5_UART_STET_OFFSET        0xa0UL
+#define C5_UART_CPR_OFFSET         0xf4UL
 // UART0 registers
 #define C5_UART0_RBR_THR_DLL_ADDR  0xffc02000UL
 #define C5_UART0_LSR_ADDR          0xffc02014UL
 #define C5_UART0_SFE_ADDR          0xffc02098UL
 #define C5_UART0_STET_ADDR         0xffc020a0UL
 
+void c5_uart_mode_refresh(uint32_t uart_base_addr);
 void c5_uart_wait_empty(uint32_t uart_base_addr);
+uint32_t c5_uart_write_str_nb(uint32_t uart_base_addr, const char *str, uint32_t len);
 void c5_uart_write_str(uint32_t uart_base_addr, const char *str, uint32_t len);
 void c5_uart_write_char(uint32_t uart_base_addr, const char c);
 
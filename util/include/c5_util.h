@@ -21,7 +21,7 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20231126
+	Version: 20261017
 
 	Utility functions for Cyclone V SoC (HPS).
 */
@@ -30,11 +30,28 @@
 #define C5_UTIL_H
 
 #include <stdint.h>
+#include "alt_interrupt.h"
 
 // Support macros
 #define C5_REG_TYPE uint32_t
 #define C5_CAST(type, ptr) ((type)(ptr))
-#define c5_io_rd_word(src_addr) (*C5_CAST(volatile C5_REG_TYPE *, (src_addr)))
-#define c5_io_wr_word(dst_addr, src_addr) (*C5_CAST(volatile C5_REG_TYPE *, (dst_addr)) = (src_addr))
+#ifdef HOST_SIM
+	// Host build, route register accesses to the device simulator
+	#include "host_sim.h"
+	#define c5_io_rd_word(src_addr) host_sim_rd_word(C5_CAST(uintptr_t, (src_addr)))
+	#define c5_io_wr_word(dst_addr, src_addr) host_sim_wr_word(C5_CAST(uintptr_t, (dst_addr)), (src_addr))
+#else
+	#define c5_io_rd_word(src_addr) (*C5_CAST(volatile C5_REG_TYPE *, (src_addr)))
+	#define c5_io_wr_word(dst_addr, src_addr) (*C5_CAST(volatile C5_REG_TYPE *, (dst_addr)) = (src_addr))
+#endif
+
+// Mask IRQ and return the previous CPSR, for short sections shared with interrupt handlers.  See alt_int_irq_save()
+static inline uint32_t c5_irq_save(void){
+	return alt_int_irq_save();
+}
+
+static inline void c5_irq_restore(uint32_t cpsr){
+	alt_int_irq_restore(cpsr);
+}
 
 #endif
@@ -21,7 +21,7 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20231201
+	Version: 20261017
 
 	Contains functions for some newlib stub functions to support the DE10-Nano
 	development board.
@@ -33,4 +33,62 @@
 #ifndef NEWLIB_EXT_H
 #define NEWLIB_EXT_H
 
+#ifdef TRU_PRINTF_UART
+	#include "alt_16550_uart.h"
+
+	/*
+		Attach a HWLib UART handle as the source for stdin, i.e. _read().  The
+		handle must already have a receive ring buffer attached with
+		alt_16550_rx_async_init() and its interrupt registered, e.g. with
+		alt_16550_async_int_register().
+
+		blocking = 1: _read() sleeps (WFI) until at least one character arrives
+		blocking = 0: _read() returns -1 with errno set to EAGAIN when empty
+
+		Passing a NULL handle detaches it and _read() returns EIO again.
+	*/
+	void newlib_ext_stdin_set(ALT_16550_HANDLE_t *handle, char blocking);
+
+	// Count of file descriptors that can be routed, 0 = stdin, 1 = stdout, 2 = stderr
+	#ifndef NEWLIB_EXT_FD_NUM
+		#define NEWLIB_EXT_FD_NUM 3
+	#endif
+
+	// Output devices for newlib_ext_fd_set()
+	typedef enum{
+		NEWLIB_EXT_DEV_NULL,   // Discard the output
+		NEWLIB_EXT_DEV_UART0,  // HPS UART0, or the text channel of the framed UART when TRU_FRAME_UART is defined
+		NEWLIB_EXT_DEV_UART1,  // HPS UART1, must already be set up by the application
+		NEWLIB_EXT_DEV_RAM     // Persistent RAM console, see tru_ramcon.h
+	}newlib_ext_dev_t;
+
+	// Buffering policies for newlib_ext_fd_set()
+	typedef enum{
+		NEWLIB_EXT_BUF_NONE,   // Send each _write() straight away
+		NEWLIB_EXT_BUF_LINE,   // Send when a newline is written or the buffer is full
+		NEWLIB_EXT_BUF_FULL    // Send when the buffer is full or on newlib_ext_flush()
+	}newlib_ext_buf_t;
+
+	/*
+		Route the output of a file descriptor, i.e. _write(), to a device with a
+		buffering policy.  The buffer is owned by the caller and must stay valid
+		until the route is changed again; it is not used (can be NULL) with
+		NEWLIB_EXT_BUF_NONE.  Pending bytes of the old route are sent first.
+
+		The default is stdout and stderr unbuffered to UART0.  Note that newlib
+		has its own stdio buffering above this, stdout is line buffered because
+		_isatty() says it is a terminal, so setvbuf(stdout, NULL, _IOFBF, n)
+		as well to get whole buffers down to here.
+
+		Returns 0 on success, -1 for a bad fd, device, policy or buffer.
+	*/
+	int newlib_ext_fd_set(int fd, newlib_ext_dev_t dev, newlib_ext_buf_t mode, char *buf, uint32_t size);
+
+	// Send the pending bytes of a file descriptor, or of all of them when fd < 0.  Call after fflush()
+	void newlib_ext_flush(int fd);
+
+	// Read (and remove) the oldest bytes written to the RAM console since this boot.  Returns the count of bytes read
+	uint32_t newlib_ext_ram_read(char *buf, uint32_t len);
+#endif
+
 #endif
@@ -0,0 +1,124 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Memory copy which picks the fastest engine for the size and placement.
+
+	tru_copy(dst, src, n) has memmove() semantics and uses one of:
+	- an inline byte copy for up to TRU_COPY_INLINE_MAX bytes
+	- the newlib memcpy()
+	- alt_mem_copy() (hwlib/include/alt_mem.h), 64 bytes per loop with NEON
+	- the DMA controller through alt_dma_memory_to_memory(), which moves 8
+	  bytes per beat in bursts of 16.  The source is cleaned from the data
+	  cache before, and the destination invalidated before and after.  The
+	  partial cache lines at the ends of the destination are copied by the
+	  CPU, so the invalidate cannot discard data next to it
+
+	The engine is chosen by comparing the size against the thresholds in
+	tru_copy_table[], one entry per placement: whether the destination and
+	source are aligned to each other modulo 8.  alt_mem_copy() and the DMA
+	bursts only help in the aligned case.  The defaults are conservative
+	guesses.  tru_copy_calibrate() measures the crossovers on the target,
+	e.g. at startup, and fills in the table.  The placement does not cover
+	the memory region: OCRAM and SDRAM have different crossovers but share
+	the table, so calibrate on a buffer in the region most copies use.
+	bench_copy.c prints the results for both.  The results can also be kept
+	and written into the table, or into the TRU_COPY_* defines, to skip the
+	calibration.
+
+	Overlapping areas are copied in chunks the size of their distance,
+	front to back or back to front as memmove() would, so each chunk can
+	still go to the faster engines.  When the distance is small memmove() is
+	used.
+
+	The DMA is only used after tru_copy_init() has allocated a channel, which
+	needs alt_dma_init() first.  The copy waits for the transfer.  If the DMA
+	is in use, e.g. tru_copy() was called from an interrupt handler while
+	the main program was in it, faults or times out, the CPU copies instead.
+*/
+
+#ifndef TRU_COPY_H
+#define TRU_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Copies of up to this many bytes are done inline by the caller
+#ifndef TRU_COPY_INLINE_MAX
+	#define TRU_COPY_INLINE_MAX 16
+#endif
+
+// Default thresholds, used until tru_copy_calibrate() is run
+#ifndef TRU_COPY_NEON_MIN
+	#define TRU_COPY_NEON_MIN 64
+#endif
+#ifndef TRU_COPY_DMA_MIN
+	#define TRU_COPY_DMA_MIN 16384
+#endif
+
+// Largest DMA program, bigger copies are split.  About 6 bytes of microcode per 32 KiB
+#ifndef TRU_COPY_DMA_CHUNK
+	#define TRU_COPY_DMA_CHUNK 0x100000
+#endif
+
+// Time allowed for one DMA program before falling back to the CPU
+#ifndef TRU_COPY_DMA_TIMEOUT_US
+	#define TRU_COPY_DMA_TIMEOUT_US 100000
+#endif
+
+typedef enum{
+	TRU_COPY_PLACE_ALIGNED,     // Destination and source aligned to each other modulo 8
+	TRU_COPY_PLACE_MISALIGNED,
+	TRU_COPY_PLACE_NUM
+}tru_copy_place_t;
+
+// Sizes from which each engine is used, SIZE_MAX for never
+typedef struct{
+	size_t neon_min;
+	size_t dma_min;
+}tru_copy_thresh_t;
+
+extern tru_copy_thresh_t tru_copy_table[TRU_COPY_PLACE_NUM];
+
+int tru_copy_init(void);
+void tru_copy_uninit(void);
+void tru_copy_calibrate(void *buf, size_t size);
+void *tru_copy_dispatch(void *dst, const void *src, size_t n);
+
+static inline void *tru_copy(void *dst, const void *src, size_t n){
+	if(n <= TRU_COPY_INLINE_MAX){
+		uint8_t tmp[TRU_COPY_INLINE_MAX];
+		const uint8_t *s = (const uint8_t *)src;
+		uint8_t *d = (uint8_t *)dst;
+		size_t i;
+
+		// Through a temporary, so overlapping areas are fine
+		for(i = 0; i < n; i++) tmp[i] = s[i];
+		for(i = 0; i < n; i++) d[i] = tmp[i];
+		return dst;
+	}
+	return tru_copy_dispatch(dst, src, n);
+}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xffff, no
+	reflection, no final XOR), bytewise without a table.  Shared by the
+	framed channels (tru_frame.h) and the RAM console header (tru_ramcon.h).
+	Pass TRU_CRC16_INIT as crc for the first block and the previous result
+	to continue over further blocks.
+*/
+
+#ifndef TRU_CRC_H
+#define TRU_CRC_H
+
+#include <stdint.h>
+
+#define TRU_CRC16_INIT 0xffff
+
+uint16_t tru_crc16(uint16_t crc, const void *data, uint32_t len);
+
+#endif
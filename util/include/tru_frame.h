@@ -0,0 +1,77 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Framed channel layer for a UART.  Several streams, e.g. printf text,
+	deferred log records and binary telemetry records, share one UART and a
+	host tool (tools/tru_frame_demux.py) splits them up again.
+
+	Frame on the wire:
+		COBS(channel, data..., CRC-16 low, CRC-16 high), 0x00
+
+	- Channel: one byte, identifies the stream
+	- CRC-16/CCITT-FALSE (tru_crc.h) over the channel and data bytes
+	- COBS (Consistent Overhead Byte Stuffing) removes all zero bytes from the
+	  frame, so 0x00 only appears as the delimiter and the receiver can resync
+	  on the next one after noise or a lost byte
+	With up to TRU_FRAME_DATA_MAX data bytes the body is a single COBS block,
+	so the overhead is fixed at 5 bytes per frame: 251 data bytes take 256
+	bytes on the wire (98%).
+
+	Longer data is split into consecutive frames on the same channel.  The
+	demultiplexer joins the frames of a channel into a stream, which suits
+	text and the deferred log records.  Records that must be self contained
+	should be at most TRU_FRAME_DATA_MAX bytes so that they fit in one frame.
+
+	Frames are sent through the HWLib UART handle attached with
+	tru_frame_init(), using the transmit ring buffer when one is attached to
+	the handle.  Before that they go out directly on UART0.  tru_frame_write()
+	is not reentrant, call it from one context only (e.g. not from both an
+	interrupt handler and the main loop).
+
+	Define TRU_FRAME_UART to route the newlib _write() (printf) output and the
+	deferred log records (TRU_LOG_DEFERRED) through their channels.
+*/
+
+#ifndef TRU_FRAME_H
+#define TRU_FRAME_H
+
+#include "alt_16550_uart.h"
+#include <stdint.h>
+
+// Channel IDs, 0 to 15 are reserved for these, the rest are free for the application
+#define TRU_FRAME_CH_TEXT      0  // printf text
+#define TRU_FRAME_CH_TRU_LOG   1  // tru_logger deferred records
+#define TRU_FRAME_CH_TELEMETRY 2  // Binary records
+#define TRU_FRAME_CH_USER      16
+
+#define TRU_FRAME_DELIM    0x00
+#define TRU_FRAME_DATA_MAX 251                         // Maximum data bytes per frame, keeps the frame body at one COBS block
+#define TRU_FRAME_ENCODED_MAX (TRU_FRAME_DATA_MAX + 5)  // Code byte, channel, data, CRC and delimiter
+
+void tru_frame_init(ALT_16550_HANDLE_t *handle);
+uint32_t tru_frame_encode(uint8_t channel, const void *data, uint32_t len, uint8_t *out);
+void tru_frame_write(uint8_t channel, const void *data, uint32_t len);
+
+#endif
@@ -21,26 +21,169 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20230619
+	Version: 20261017
 
 	Provides debug logging support for bare-metal program development.
+
+	Deferred mode (define TRU_LOG_DEFERRED): DEBUG_PRINTF does not format
+	anything.  It stores the ID of the format string and the raw argument
+	words into a RAM ring buffer, and tru_log_drain() later sends the records
+	out of the UART from a low priority context, e.g. the idle loop.  The
+	format strings are kept in a section of the ELF that is not loaded on the
+	target, and tools/tru_log_decode.py uses them to turn the records back into
+	text.  Limitations:
+	- Up to TRU_LOG_ARGS_MAX arguments, each sent as one 32 bit word, so no
+	  double or 64 bit arguments
+	- %s arguments must point to constant strings, the decoder looks them up
+	  in the ELF
+
+	RAM console mode (define TRU_LOG_RAMCON): the log goes to the persistent
+	RAM console (tru_ramcon.h) instead of the UART, formatted text or, with
+	TRU_LOG_DEFERRED as well, the binary records.  It survives a warm reset
+	and tru_ramcon_replay() sends it out of the UART on the next boot.
+
+	Levels and categories: TRU_LOG_ERROR(), TRU_LOG_WARN(), TRU_LOG_INFO(),
+	TRU_LOG_DEBUG() and TRU_LOG_TRACE() take a category name as the first
+	argument, e.g. TRU_LOG_WARN(DMA, "channel %u faulted"_NL, ch).  Filtering is
+	in two stages:
+	- Compile time: levels above TRU_LOG_LEVEL and categories not in
+	  TRU_LOG_CATS compile to nothing, including their format strings
+	- Run time: tru_log_level and tru_log_mask select from what is compiled in
+	The category mask bits 0 to 15 are for the categories below, bits 16 to 31
+	are free for the application, e.g.:
+	#define TRU_LOG_CAT_MOTOR (1UL << 16)
 */
 
 #ifndef TRU_LOGGER_H
 #define TRU_LOGGER_H
 
 #include <stdio.h>
+#include <stdint.h>
 
 // Define a macro named _NL to select the correct line endings for different modes.  NL stands for NewLine
-#if defined(SEMIHOSTING)
+#if defined(TRU_LOG_DEFERRED)
+	#ifndef TRU_LOG_RING_WORDS
+		#define TRU_LOG_RING_WORDS 1024  // Ring buffer size in 32 bit words, must be a power of 2
+	#endif
+	#ifndef TRU_LOG_UART_BASE_ADDR
+		#define TRU_LOG_UART_BASE_ADDR 0xffc02000UL  // UART0
+	#endif
+	#define TRU_LOG_ARGS_MAX 8
+
+	// Record header word: 0xa in bits 31:28 for resync, argument count in bits 27:24, format string ID in bits 23:0
+	#define TRU_LOG_HDR_MARK 0xa0000000UL
+	#define TRU_LOG_HDR(id, nargs) (TRU_LOG_HDR_MARK | ((uint32_t)(nargs) << 24) | ((id) & 0x00ffffffUL))
+	#define TRU_LOG_ID_DROPPED 0x00ffffffUL  // Special record, the argument is the count of records lost to a full ring buffer
+
+	// The format string ID is its offset in the tru_log_fmt section
+	#if defined(HOST_SIM)
+		extern const char __start_tru_log_fmt[];
+		#define TRU_LOG_FMT_ID(fmt) ((uint32_t)((fmt) - __start_tru_log_fmt))
+	#else
+		#define TRU_LOG_FMT_ID(fmt) ((uint32_t)(uintptr_t)(fmt))  // The linker scripts place the section at address 0
+	#endif
+
+	#define TRU_LOG_NARGS(...) TRU_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+	#define TRU_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+	#define _NL "\n"
+	#define TRU_LOG_OUT(str, ...) do{ \
+		static const char tru_log_fmt[] __attribute__((section("tru_log_fmt"))) = str; \
+		tru_log_write(TRU_LOG_HDR(TRU_LOG_FMT_ID(tru_log_fmt), TRU_LOG_NARGS(__VA_ARGS__)), ##__VA_ARGS__); \
+	}while(0)
+	#define DEBUG_PRINTF(str, ...) TRU_LOG_OUT(str, ##__VA_ARGS__)
+
+	void tru_log_write(uint32_t hdr, ...);
+	uint32_t tru_log_drain(void);
+	void tru_log_flush(void);
+#elif defined(TRU_LOG_RAMCON)
+	#ifndef TRU_LOG_RAMCON_LINE
+		#define TRU_LOG_RAMCON_LINE 128  // Longest formatted log line in bytes, including the terminator
+	#endif
+
+	#define _NL "\r\n"
+	#define DEBUG_PRINTF(str, ...) tru_log_printf(str, ##__VA_ARGS__)
+	#define TRU_LOG_OUT(str, ...) tru_log_printf(str, ##__VA_ARGS__)
+
+	// Printf into the persistent RAM console (tru_ramcon.h)
+	int tru_log_printf(const char *format, ...);
+#elif defined(SEMIHOSTING)
 	#define _NL "\n"
 	#define DEBUG_PRINTF(str, ...) printf(str, ##__VA_ARGS__)
+	#define TRU_LOG_OUT(str, ...) tru_log_printf(str, ##__VA_ARGS__)
+
+	// Printf for the levelled log macros.  A function, so it still reaches newlib printf from source files where alt_printf.h redefines printf
+	int tru_log_printf(const char *format, ...);
 #elif defined(TRU_PRINTF_UART)
 	#define _NL "\r\n"
 	#define DEBUG_PRINTF(str, ...) printf(str, ##__VA_ARGS__)
+	#define TRU_LOG_OUT(str, ...) tru_log_printf(str, ##__VA_ARGS__)
+
+	int tru_log_printf(const char *format, ...);
 #else
 	#define _NL "\n"
 	#define DEBUG_PRINTF(str, ...) (void)0
+	#define TRU_LOG_OUT(str, ...) (void)0
+#endif
+
+
+// Log levels
+#define TRU_LOG_LEVEL_NONE  0
+#define TRU_LOG_LEVEL_ERROR 1
+#define TRU_LOG_LEVEL_WARN  2
+#define TRU_LOG_LEVEL_INFO  3
+#define TRU_LOG_LEVEL_DEBUG 4
+#define TRU_LOG_LEVEL_TRACE 5
+
+// Log categories
+#define TRU_LOG_CAT_APP  (1UL << 0)
+#define TRU_LOG_CAT_UART (1UL << 1)
+#define TRU_LOG_CAT_DMA  (1UL << 2)
+#define TRU_LOG_CAT_ETH  (1UL << 3)
+#define TRU_LOG_CAT_MEM  (1UL << 4)
+
+// Compile time filter, the highest level and the categories that are compiled in
+#ifndef TRU_LOG_LEVEL
+	#define TRU_LOG_LEVEL TRU_LOG_LEVEL_INFO
+#endif
+#ifndef TRU_LOG_CATS
+	#define TRU_LOG_CATS 0xffffffffUL
+#endif
+
+// Run time filter, default to everything that is compiled in
+extern volatile uint32_t tru_log_level;
+extern volatile uint32_t tru_log_mask;
+
+#define TRU_LOG_(level, tag, cat, str, ...) do{ \
+	if((TRU_LOG_CAT_##cat & TRU_LOG_CATS) && (tru_log_mask & TRU_LOG_CAT_##cat) && tru_log_level >= (level)){ \
+		TRU_LOG_OUT(tag " " #cat ": " str, ##__VA_ARGS__); \
+	} \
+}while(0)
+
+#if TRU_LOG_LEVEL >= TRU_LOG_LEVEL_ERROR
+	#define TRU_LOG_ERROR(cat, str, ...) TRU_LOG_(TRU_LOG_LEVEL_ERROR, "E", cat, str, ##__VA_ARGS__)
+#else
+	#define TRU_LOG_ERROR(cat, str, ...) (void)0
+#endif
+#if TRU_LOG_LEVEL >= TRU_LOG_LEVEL_WARN
+	#define TRU_LOG_WARN(cat, str, ...) TRU_LOG_(TRU_LOG_LEVEL_WARN, "W", cat, str, ##__VA_ARGS__)
+#else
+	#define TRU_LOG_WARN(cat, str, ...) (void)0
+#endif
+#if TRU_LOG_LEVEL >= TRU_LOG_LEVEL_INFO
+	#define TRU_LOG_INFO(cat, str, ...) TRU_LOG_(TRU_LOG_LEVEL_INFO, "I", cat, str, ##__VA_ARGS__)
+#else
+	#define TRU_LOG_INFO(cat, str, ...) (void)0
+#endif
+#if TRU_LOG_LEVEL >= TRU_LOG_LEVEL_DEBUG
+	#define TRU_LOG_DEBUG(cat, str, ...) TRU_LOG_(TRU_LOG_LEVEL_DEBUG, "D", cat, str, ##__VA_ARGS__)
+#else
+	#define TRU_LOG_DEBUG(cat, str, ...) (void)0
+#endif
+#if TRU_LOG_LEVEL >= TRU_LOG_LEVEL_TRACE
+	#define TRU_LOG_TRACE(cat, str, ...) TRU_LOG_(TRU_LOG_LEVEL_TRACE, "T", cat, str, ##__VA_ARGS__)
+#else
+	#define TRU_LOG_TRACE(cat, str, ...) (void)0
 #endif
 
 #endif
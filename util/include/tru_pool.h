@@ -0,0 +1,93 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Fixed block pool allocator.
+
+	Memory is split into pools of equal size blocks, one pool per size class.
+	A request is served from the smallest class that fits, or the next larger
+	one when that pool is empty, so the time taken is bounded by the number of
+	classes and does not depend on the allocation history.  There is no
+	fragmentation.  Each free block holds the link to the next free block, so
+	the only overhead is the rounding up to the class size.
+
+	- Blocks are TRU_POOL_ALIGN (32 bytes, the L1/L2 cache line) aligned and a
+	  multiple of it in size, so DMA buffers do not share a cache line with
+	  other data
+	- tru_pool_alloc() and tru_pool_free() mask IRQ for a few instructions, so
+	  they can be used from interrupt handlers
+	- Per pool statistics: blocks in use, high water mark and failed requests
+
+	The blocks are in the .tru_pool section, which the linker scripts
+	(hwlib/src/linkerscripts/cvav-*.ld) place after .bss in the RAM the
+	program is linked for, DDR or on-chip RAM (OCRAM).
+
+	The size classes are set with TRU_POOL_CLASSES, a list of
+	X(block size, block count) entries in increasing size, e.g.:
+	#define TRU_POOL_CLASSES(X) X(64, 32) X(1536, 8)
+
+	Define TRU_POOL_MALLOC to serve malloc(), calloc(), realloc(), free(),
+	memalign() and malloc_usable_size(), including the newlib internal
+	_malloc_r() family, from the pools instead of the newlib heap.  Requests
+	larger than the largest class then fail, as do alignments above
+	TRU_POOL_ALIGN.  newlib builds aligned_alloc() and posix_memalign() on
+	memalign(), so they follow.  Freeing or reallocating a pointer which is
+	not from the pools fails an assert(), and otherwise leaves it alone.
+*/
+
+#ifndef TRU_POOL_H
+#define TRU_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRU_POOL_ALIGN 32
+
+#ifndef TRU_POOL_CLASSES
+	// Sized to fit in the on-chip RAM next to the program, 8 KiB in total
+	#define TRU_POOL_CLASSES(X) \
+		X(32, 32) \
+		X(64, 16) \
+		X(128, 8) \
+		X(256, 4) \
+		X(512, 2) \
+		X(1536, 2)  // An Ethernet frame
+#endif
+
+typedef struct{
+	uint32_t block_size;
+	uint32_t block_count;
+	uint32_t used;        // Blocks in use
+	uint32_t used_max;    // High water mark of used
+	uint32_t failed;      // Requests for this class which found all pools empty
+}tru_pool_stats_t;
+
+void tru_pool_init(void);
+void *tru_pool_alloc(size_t size);
+int tru_pool_free(void *ptr);
+size_t tru_pool_block_size(const void *ptr);
+uint32_t tru_pool_class_count(void);
+int tru_pool_stats_get(uint32_t class_index, tru_pool_stats_t *stats);
+
+#endif
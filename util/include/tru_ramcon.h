@@ -0,0 +1,89 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Persistent RAM console.
+
+	A ring buffer in the .noinit section, which the linker scripts
+	(hwlib/src/linkerscripts/cvav-*.ld) place in RAM that is neither loaded
+	nor zeroed at start up, so its content survives a warm reset.  Writing to
+	it is a memcpy() and a header update, cheap enough to leave logging on
+	all the time (see TRU_LOG_RAMCON in tru_logger.h).
+
+	The header holds a magic number, the ring size and a boot sequence
+	number, protected by a CRC-16, and the write position together with its
+	inverse.  On the first use after a reset the header is checked: when it
+	is valid the previous content is kept as the recovered log and the
+	sequence number is incremented, otherwise the console starts empty.
+	tru_ramcon_replay() sends the recovered log out of the UART, and
+	tools/tru_ramcon_dump.py extracts it from a JTAG memory dump of the
+	tru_ramcon symbol.
+
+	New output is appended after the recovered log, so replay early in the
+	boot before new output overwrites it.  With the data cache enabled the
+	content is only persistent once the cache lines are written back.
+*/
+
+#ifndef TRU_RAMCON_H
+#define TRU_RAMCON_H
+
+#include <stdint.h>
+
+// Ring size in bytes, must be a power of 2.  Small enough by default for the OCRAM build
+// (cvav-ocr.ld), where the image, .tru_pool and .noinit all share the 32 KiB below the stack
+#ifndef TRU_RAMCON_SIZE
+	#define TRU_RAMCON_SIZE 4096
+#endif
+
+#ifndef TRU_RAMCON_UART_BASE_ADDR
+	#define TRU_RAMCON_UART_BASE_ADDR 0xffc02000UL  // UART0
+#endif
+
+#define TRU_RAMCON_MAGIC 0x4e4f4352UL  // "RCON"
+
+typedef struct{
+	uint32_t magic;     // TRU_RAMCON_MAGIC
+	uint32_t size;      // TRU_RAMCON_SIZE
+	uint32_t seq;       // Boot sequence number, incremented on each recovery
+	uint32_t crc;       // CRC-16 (tru_crc16) of magic, size and seq
+	uint32_t head;      // Count of bytes ever written, the ring position is head % size
+	uint32_t head_inv;  // ~head, catches a corrupted write position
+}tru_ramcon_hdr_t;
+
+// Check the header and recover the previous content.  Called on first use
+void tru_ramcon_init(void);
+
+// Append bytes, the oldest are overwritten when the ring is full.  Can be called from interrupt handlers
+void tru_ramcon_write(const char *ptr, uint32_t len);
+
+// Read (and remove for this reader) the oldest bytes written since this boot.  Returns the count of bytes read
+uint32_t tru_ramcon_read(char *buf, uint32_t len);
+
+// Count of bytes recovered from before the reset that are still in the ring, and the boot sequence number they were written in
+uint32_t tru_ramcon_recovered(uint32_t *seq);
+
+// Send the recovered bytes out of the UART, then forget them
+void tru_ramcon_replay(void);
+
+#endif
@@ -0,0 +1,82 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Batched semihosting output.  Only compiled when SEMIHOSTING is defined.
+
+	With the newlib semihosting library (rdimon) every printf() that ends a
+	line is a separate SYS_WRITE trap, and each trap halts the core for a
+	round trip to the debugger.  This sink collects the output in a RAM
+	buffer instead and sends it with one SYS_WRITE when:
+	- TRU_SEMIHOST_LINES newlines have been written since the last send
+	- the buffer (TRU_SEMIHOST_BUF_SIZE bytes) is full
+	- tru_semihost_flush() is called, e.g. from the idle loop, and at exit
+
+	tru_semihost_stdout_attach() puts newlib stdout on the sink, stderr stays
+	on rdimon so error output is still immediate.  Output which has not been
+	sent yet is lost if the program hangs, so flush before anything risky.
+*/
+
+#ifndef TRU_SEMIHOST_H
+#define TRU_SEMIHOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Size of the output buffer in bytes
+#ifndef TRU_SEMIHOST_BUF_SIZE
+	#define TRU_SEMIHOST_BUF_SIZE 4096
+#endif
+
+// Send after this many newlines, 0 = only when the buffer is full or on tru_semihost_flush()
+#ifndef TRU_SEMIHOST_LINES
+	#define TRU_SEMIHOST_LINES 16
+#endif
+
+// Semihosting operation numbers (ARM semihosting specification)
+#define TRU_SEMIHOST_SYS_OPEN     0x01
+#define TRU_SEMIHOST_SYS_WRITE    0x05
+#define TRU_SEMIHOST_SYS_CLOCK    0x10
+#define TRU_SEMIHOST_SYS_ELAPSED  0x30
+#define TRU_SEMIHOST_SYS_TICKFREQ 0x31
+
+// Raw semihosting call: operation number in r0, argument block pointer in r1.  Returns r0
+int tru_semihost_call(int op, void *arg);
+
+// Open the host console.  Called on first use, returns 0 on success
+int tru_semihost_init(void);
+
+// Buffer output bytes, sending them when one of the conditions above is met
+void tru_semihost_write(const char *ptr, uint32_t len);
+
+// Send the buffered output now
+void tru_semihost_flush(void);
+
+// Put newlib stdout on the sink.  Returns the new stdout, or NULL on failure
+FILE *tru_semihost_stdout_attach(void);
+
+// Count of SYS_WRITE traps made by the sink
+uint32_t tru_semihost_trap_count(void);
+
+#endif
@@ -21,13 +21,46 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20231126
+	Version: 20261017
 
 	UART functions for Cyclone V SoC (HPS).
 */
 
 #include "c5_uart.h"
 
+// Cached transmit mode for each HPS UART controller, indexed by bit 12 of the base address (UART0 = 0xffc02000, UART1 = 0xffc03000)
+typedef struct{
+	uint32_t base_addr;   // 0 = not cached yet
+	uint32_t fifo_depth;  // TX FIFO depth in bytes, 0 = FIFO disabled (holding register only)
+}c5_uart_mode_t;
+
+static c5_uart_mode_t mode_cache[2];
+
+/*
+	Re-read the transmit mode of the UART controller.  The mode is cached on
+	first use, so this must be called after the FIFO of a UART is enabled or
+	disabled by other code, e.g. by the HWLib alt_16550_fifo_enable().
+*/
+void c5_uart_mode_refresh(uint32_t uart_base_addr){
+	c5_uart_mode_t *mode = &mode_cache[(uart_base_addr >> 12) & 1];
+
+	mode->base_addr = uart_base_addr;
+	if(c5_io_rd_word(uart_base_addr + C5_UART_SFE_OFFSET)){
+		// FIFO enabled, depth is 16x the CPR FIFO_MODE field (bits 23:16)
+		mode->fifo_depth = ((c5_io_rd_word(uart_base_addr + C5_UART_CPR_OFFSET) >> 16) & 0xff) << 4;
+		if(mode->fifo_depth == 0) mode->fifo_depth = 128;  // CPR not implemented, use the Cyclone V HPS UART FIFO depth
+	}else{
+		mode->fifo_depth = 0;
+	}
+}
+
+static inline uint32_t c5_uart_fifo_depth(uint32_t uart_base_addr){
+	c5_uart_mode_t *mode = &mode_cache[(uart_base_addr >> 12) & 1];
+
+	if(mode->base_addr != uart_base_addr) c5_uart_mode_refresh(uart_base_addr);
+	return mode->fifo_depth;
+}
+
 /*
 	Blocking wait on the transmit empty register to become empty.  It becomes
 	empty when all pending data in the FIFO (FIFO mode) or holding register
@@ -37,37 +70,41 @@ void c5_uart_wait_empty(uint32_t uart_base_addr){
 	while((c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000040) == 0);  // Flush UART and wait
 }
 
-void c5_uart_write_str(uint32_t uart_base_addr, const char *str, uint32_t len){
-	// FIFO & threshold mode enabled?
-	char fifo_th_en = (c5_io_rd_word(uart_base_addr + C5_UART_SFE_OFFSET) && c5_io_rd_word(uart_base_addr + C5_UART_STET_OFFSET)) ? 1 : 0;
-
-	// Write input bytes to UART controller, one at a time
-	for(uint32_t i = 0; i < len; i++){
-		// Wait until the UART controller is ready to accept a byte in its transmit buffer, i.e. there is free space?
-		// They are masochists - using the same bit but with the opposite logic depending on the mode set!
-		if(fifo_th_en){
-			while(c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000020);  // Wait while not empty. Bit 5 of LSR reg (THRE bit), 1 = not empty, 0 = empty
-		}else{
-			while((c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000020) == 0);  // Wait while not empty. Bit 5 of LSR reg (THRE bit), 0 = not empty, 1 = empty
-		}
-
-		// Write a single character to UART controller transmit holding register
+/*
+	Write as many of the input bytes as there is free space for in the
+	transmitter, without waiting.  Returns the count of bytes written.
+*/
+uint32_t c5_uart_write_str_nb(uint32_t uart_base_addr, const char *str, uint32_t len){
+	uint32_t fifo_depth = c5_uart_fifo_depth(uart_base_addr);
+	uint32_t space;
+	uint32_t i;
+
+	if(fifo_depth){
+		// FIFO mode: free space from the transmit FIFO level register, one register read per burst.  Unlike the THRE bit this has the same meaning with or without the threshold mode
+		space = fifo_depth - c5_io_rd_word(uart_base_addr + C5_UART_TFL_OFFSET);
+	}else{
+		// Non-FIFO mode: bit 5 of LSR reg (THRE bit), 1 = holding register empty, 0 = not empty
+		space = (c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000020) ? 1 : 0;
+	}
+	if(space > len) space = len;
+
+	// Write the burst of characters to UART controller transmit holding register
+	for(i = 0; i < space; i++){
 		c5_io_wr_word(uart_base_addr + C5_UART_RBR_THR_DLL_OFFSET, str[i]);
 	}
+
+	return space;
 }
 
-void c5_uart_write_char(uint32_t uart_base_addr, const char c){
-	// FIFO & threshold mode enabled?
-	char fifo_th_en = (c5_io_rd_word(uart_base_addr + C5_UART_SFE_OFFSET) && c5_io_rd_word(uart_base_addr + C5_UART_STET_OFFSET)) ? 1 : 0;
+void c5_uart_write_str(uint32_t uart_base_addr, const char *str, uint32_t len){
+	uint32_t i = 0;
 
-	// Wait until the UART controller is ready to accept a byte in its transmit buffer, i.e. there is free space?
-	// They are masochists - using the same bit but with the opposite logic depending on the mode set!
-	if(fifo_th_en){
-		while(c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000020);  // Wait while not empty. Bit 5 of LSR reg (THRE bit), 1 = not empty, 0 = empty
-	}else{
-		while((c5_io_rd_word(uart_base_addr + C5_UART_LSR_OFFSET) & 0x00000020) == 0);  // Wait while not empty. Bit 5 of LSR reg (THRE bit), 0 = not empty, 1 = empty
+	// Write input bytes to UART controller in bursts, as many as there is free space for
+	while(i < len){
+		i += c5_uart_write_str_nb(uart_base_addr, &str[i], len - i);
 	}
+}
 
-	// Write a single character to UART controller transmit holding register
-	c5_io_wr_word(uart_base_addr + C5_UART_RBR_THR_DLL_OFFSET, c);
+void c5_uart_write_char(uint32_t uart_base_addr, const char c){
+	c5_uart_write_str(uart_base_addr, &c, 1);
 }
@@ -21,14 +21,23 @@
 	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 	SOFTWARE.
 
-	Version: 20240202
+	Version: 20261017
 */
 #include <errno.h>
 #include <sys/stat.h>
 #include <sys/unistd.h>
 #include "newlib_ext.h"
 #ifdef TRU_PRINTF_UART
+	#include <string.h>
+	#include "alt_interrupt.h"
 	#include "c5_uart.h"
+	#include "tru_ramcon.h"
+	#ifdef TRU_FRAME_UART
+		#include "tru_frame.h"
+	#endif
+#endif
+#ifdef HOST_SIM
+	#include "host_sim.h"
 #endif
 
 #ifdef SEMIHOSTING
@@ -68,13 +77,167 @@
 			return (ptr - 1);  // TTY is not seekable, return error
 		}
 
+		// Interrupt driven stdin source, see newlib_ext_stdin_set()
+		static ALT_16550_HANDLE_t *stdin_handle = NULL;
+		static char stdin_blocking = 1;
+
+		void newlib_ext_stdin_set(ALT_16550_HANDLE_t *handle, char blocking){
+			stdin_blocking = blocking;
+			stdin_handle = handle;
+		}
+
+		/*
+			Sleep until an interrupt arrives, unless the receive ring buffer has
+			become non-empty.  IRQ is masked around the check so a character that
+			arrives between the check and the WFI still wakes the core (WFI wakes
+			on a pending interrupt even while it is masked).
+		*/
+		static void stdin_wait(void){
+			ALT_16550_RING_STATS_t stats;
+			uint32_t cpsr = alt_int_irq_save();
+
+			if(alt_16550_rx_async_stats_get(stdin_handle, &stats) == ALT_E_SUCCESS && stats.level == 0){
+				#ifdef HOST_SIM
+					host_sim_wfi();  // Let virtual time run to the next UART event
+				#else
+					alt_int_wfi();
+				#endif
+			}
+			alt_int_irq_restore(cpsr);  // Restore the IRQ mask, the pending interrupt is then serviced
+		}
+
 		int _read(int fd, char *ptr, int len){
-			errno = EIO;  // Input/output error
-			return -1;  // Too complicated to implement read for TTY, return error
+			size_t count;
+
+			if(stdin_handle == NULL){
+				errno = EIO;  // Input/output error
+				return -1;  // No interrupt driven UART attached, return error
+			}
+
+			for(;;){
+				if(alt_16550_rx_async_read(stdin_handle, ptr, len, &count) != ALT_E_SUCCESS){
+					errno = EIO;  // Input/output error
+					return -1;
+				}
+
+				if(count){
+					// Terminals send CR for the Enter key, translate to NL like a TTY in ICRNL mode so fgets() and scanf() see the line end
+					for(size_t i = 0; i < count; i++){
+						if(ptr[i] == '\r') ptr[i] = '\n';
+					}
+					return count;
+				}
+
+				if(!stdin_blocking){
+					errno = EAGAIN;  // Try again, no data available
+					return -1;
+				}
+
+				stdin_wait();
+			}
+		}
+
+		// Output routing of each file descriptor, see newlib_ext_fd_set()
+		typedef struct{
+			newlib_ext_dev_t dev;
+			newlib_ext_buf_t mode;
+			char *buf;      // NULL = unbuffered
+			uint32_t size;
+			uint32_t len;   // Count of pending bytes in buf
+		}fd_route_t;
+
+		// Default: stdout and stderr unbuffered to UART0, stdin has no output
+		static fd_route_t fd_route[NEWLIB_EXT_FD_NUM] = {
+			[0] = { NEWLIB_EXT_DEV_NULL, NEWLIB_EXT_BUF_NONE, NULL, 0, 0 },
+			[1] = { NEWLIB_EXT_DEV_UART0, NEWLIB_EXT_BUF_NONE, NULL, 0, 0 },
+			[2] = { NEWLIB_EXT_DEV_UART0, NEWLIB_EXT_BUF_NONE, NULL, 0, 0 }
+		};
+
+		uint32_t newlib_ext_ram_read(char *buf, uint32_t len){
+			return tru_ramcon_read(buf, len);
+		}
+
+		static void dev_write(newlib_ext_dev_t dev, const char *ptr, uint32_t len){
+			switch(dev){
+				case NEWLIB_EXT_DEV_UART0:
+					#ifdef TRU_FRAME_UART
+						tru_frame_write(TRU_FRAME_CH_TEXT, ptr, len);  // Re-target to the text channel of the framed UART
+					#else
+						c5_uart_write_str(C5_UART0_BASE_ADDR, ptr, len);  // Re-target to UART controller
+					#endif
+					break;
+				case NEWLIB_EXT_DEV_UART1:
+					c5_uart_write_str(C5_UART1_BASE_ADDR, ptr, len);
+					break;
+				case NEWLIB_EXT_DEV_RAM:
+					tru_ramcon_write(ptr, len);
+					break;
+				default:
+					break;  // Null sink
+			}
+		}
+
+		static void fd_flush(fd_route_t *route){
+			if(route->len){
+				dev_write(route->dev, route->buf, route->len);
+				route->len = 0;
+			}
+		}
+
+		int newlib_ext_fd_set(int fd, newlib_ext_dev_t dev, newlib_ext_buf_t mode, char *buf, uint32_t size){
+			fd_route_t *route;
+
+			if(fd < 0 || fd >= NEWLIB_EXT_FD_NUM || dev > NEWLIB_EXT_DEV_RAM || mode > NEWLIB_EXT_BUF_FULL) return -1;
+			if(mode != NEWLIB_EXT_BUF_NONE && (buf == NULL || size == 0)) return -1;
+
+			route = &fd_route[fd];
+			fd_flush(route);  // Pending bytes go to the old device
+			route->dev = dev;
+			route->mode = mode;
+			route->buf = (mode == NEWLIB_EXT_BUF_NONE) ? NULL : buf;
+			route->size = (mode == NEWLIB_EXT_BUF_NONE) ? 0 : size;
+			return 0;
+		}
+
+		void newlib_ext_flush(int fd){
+			int i;
+
+			for(i = 0; i < NEWLIB_EXT_FD_NUM; i++){
+				if(fd < 0 || fd == i) fd_flush(&fd_route[i]);
+			}
 		}
 
 		int _write(int fd, char *ptr, int len){
-			c5_uart_write_str(C5_UART0_BASE_ADDR, ptr, len);  // Re-target to UART controller
+			fd_route_t *route;
+
+			if(fd < 0 || fd >= NEWLIB_EXT_FD_NUM){
+				errno = EBADF;  // Bad file descriptor
+				return -1;
+			}
+			route = &fd_route[fd];
+
+			if(route->buf == NULL){
+				dev_write(route->dev, ptr, len);
+				return len;
+			}
+
+			// Too big to buffer, send what is pending and then the whole lot in one go
+			if((uint32_t)len > route->size - route->len){
+				fd_flush(route);
+				if((uint32_t)len >= route->size){
+					dev_write(route->dev, ptr, len);
+					return len;
+				}
+			}
+
+			memcpy(&route->buf[route->len], ptr, len);
+			route->len += len;
+
+			if(route->len == route->size){
+				fd_flush(route);
+			}else if(route->mode == NEWLIB_EXT_BUF_LINE && memchr(ptr, '\n', len)){
+				fd_flush(route);  // Only the new bytes can hold a newline, older ones would have been flushed already
+			}
 			return len;
 		}
 	#else
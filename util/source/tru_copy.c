@@ -0,0 +1,249 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Size and placement based memory copy, see tru_copy.h.
+*/
+
+#include "tru_copy.h"
+#include "alt_cache.h"
+#include "alt_dma.h"
+#include "alt_mem.h"
+#include "alt_mono.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define TRU_COPY_LINE ALT_CACHE_LINE_SIZE
+#define TRU_COPY_CALIB_RUNS 3
+#define TRU_COPY_CALIB_NUM 32
+
+tru_copy_thresh_t tru_copy_table[TRU_COPY_PLACE_NUM] = {
+	{ TRU_COPY_NEON_MIN, TRU_COPY_DMA_MIN },  // TRU_COPY_PLACE_ALIGNED
+	{ SIZE_MAX,          TRU_COPY_DMA_MIN }   // TRU_COPY_PLACE_MISALIGNED, alt_mem_copy() would use memcpy() anyway
+};
+
+static ALT_DMA_PROGRAM_t tru_copy_program;
+static ALT_DMA_CHANNEL_t tru_copy_channel;
+static bool tru_copy_dma_ready;
+static volatile bool tru_copy_dma_busy;
+
+// Needs alt_dma_init().  Returns 0 on success, -1 if no channel is free, in which case only the CPU is used
+int tru_copy_init(void){
+	if(tru_copy_dma_ready) return 0;
+	if(alt_dma_channel_alloc_any(&tru_copy_channel) != ALT_E_SUCCESS) return -1;
+	tru_copy_dma_ready = true;
+	return 0;
+}
+
+void tru_copy_uninit(void){
+	if(!tru_copy_dma_ready) return;
+	tru_copy_dma_ready = false;
+	alt_dma_channel_free(tru_copy_channel);
+}
+
+static tru_copy_place_t tru_copy_place(const void *dst, const void *src){
+	return (((uintptr_t)dst ^ (uintptr_t)src) & 7) ? TRU_COPY_PLACE_MISALIGNED : TRU_COPY_PLACE_ALIGNED;
+}
+
+// One DMA program and wait for it.  Returns false on a fault or timeout, with the channel stopped
+static bool tru_copy_dma_run(uint8_t *dst, const uint8_t *src, size_t n){
+	ALT_DMA_CHANNEL_STATE_t state;
+	alt_mono_deadline_t deadline;
+
+	if(alt_dma_memory_to_memory(tru_copy_channel, &tru_copy_program, dst, src, n, false, (ALT_DMA_EVENT_t)0) != ALT_E_SUCCESS) return false;
+
+	deadline = alt_mono_deadline_us(TRU_COPY_DMA_TIMEOUT_US);
+	do{
+		if(alt_dma_channel_state_get(tru_copy_channel, &state) != ALT_E_SUCCESS) break;
+		if(state == ALT_DMA_CHANNEL_STATE_STOPPED) return true;
+		if(state == ALT_DMA_CHANNEL_STATE_FAULTING) break;
+	}while(!alt_mono_expired(deadline));
+
+	alt_dma_channel_kill(tru_copy_channel);
+	return false;
+}
+
+/*
+	Copy with the DMA, the areas must not overlap.  The partial cache lines at
+	the ends of the destination are copied by the CPU, the invalidates would
+	otherwise drop writes to the rest of those lines.  Returns false if
+	nothing was done with the DMA, or it failed part way.  The caller then
+	copies with the CPU, which also overwrites any partial DMA result.
+*/
+static bool tru_copy_dma(uint8_t *dst, const uint8_t *src, size_t n){
+	uintptr_t start;
+	uintptr_t end;
+	size_t head;
+	size_t mid;
+	size_t done;
+	size_t chunk;
+	bool ok = true;
+
+	if(!tru_copy_dma_ready || tru_copy_dma_busy || n < 4 * TRU_COPY_LINE) return false;
+	tru_copy_dma_busy = true;  // An interrupt handler calling in here sees this and uses the CPU
+
+	head = (TRU_COPY_LINE - ((uintptr_t)dst & (TRU_COPY_LINE - 1))) & (TRU_COPY_LINE - 1);
+	mid = (n - head) & ~(size_t)(TRU_COPY_LINE - 1);
+
+	// Write back the source, and drop the destination lines so no dirty line is evicted over the DMA data
+	start = (uintptr_t)(src + head) & ~(uintptr_t)(TRU_COPY_LINE - 1);
+	end = ((uintptr_t)(src + head + mid) + TRU_COPY_LINE - 1) & ~(uintptr_t)(TRU_COPY_LINE - 1);
+	alt_cache_system_clean((void *)start, end - start);
+	alt_cache_system_invalidate(dst + head, mid);
+
+	for(done = 0; done < mid && ok; done += chunk){
+		chunk = mid - done;
+		if(chunk > TRU_COPY_DMA_CHUNK) chunk = TRU_COPY_DMA_CHUNK;
+		ok = tru_copy_dma_run(dst + head + done, src + head + done, chunk);
+	}
+
+	// Drop lines the core may have speculatively fetched during the transfer
+	alt_cache_system_invalidate(dst + head, mid);
+
+	if(ok){
+		memcpy(dst, src, head);
+		memcpy(dst + head + mid, src + head + mid, n - head - mid);
+	}
+	tru_copy_dma_busy = false;
+	return ok;
+}
+
+// Copy of areas which do not overlap
+static void tru_copy_block(uint8_t *dst, const uint8_t *src, size_t n, const tru_copy_thresh_t *thresh){
+	if(n >= thresh->dma_min && tru_copy_dma(dst, src, n)) return;
+	if(n >= thresh->neon_min){
+		alt_mem_copy(dst, src, n);
+	}else{
+		memcpy(dst, src, n);
+	}
+}
+
+void *tru_copy_dispatch(void *dst, const void *src, size_t n){
+	uint8_t *d = (uint8_t *)dst;
+	const uint8_t *s = (const uint8_t *)src;
+	const tru_copy_thresh_t *thresh = &tru_copy_table[tru_copy_place(dst, src)];
+	size_t dist = (d > s) ? (size_t)(d - s) : (size_t)(s - d);
+	size_t off;
+
+	if(dist >= n){
+		tru_copy_block(d, s, n, thresh);
+		return dst;
+	}
+	if(dist == 0) return dst;
+
+	// Overlapping.  Chunks of the distance do not overlap each other's source once copied in the right order
+	if(dist < thresh->neon_min || dist <= TRU_COPY_INLINE_MAX){
+		memmove(dst, src, n);
+	}else if(d < s){
+		for(off = 0; n - off > dist; off += dist){
+			tru_copy_block(d + off, s + off, dist, thresh);
+		}
+		tru_copy_block(d + off, s + off, n - off, thresh);
+	}else{
+		for(off = n; off > dist; off -= dist){
+			tru_copy_block(d + off - dist, s + off - dist, dist, thresh);
+		}
+		tru_copy_block(d, s, off, thresh);
+	}
+	return dst;
+}
+
+// Best of a few runs, in global timer ticks
+static uint64_t tru_copy_time(int engine, uint8_t *dst, const uint8_t *src, size_t n){
+	uint64_t best = UINT64_MAX;
+	uint64_t t;
+	int i;
+
+	for(i = 0; i < TRU_COPY_CALIB_RUNS; i++){
+		t = alt_mono_now_ticks();
+		switch(engine){
+			case 0:
+				memcpy(dst, src, n);
+				break;
+			case 1:
+				alt_mem_copy(dst, src, n);
+				break;
+			default:
+				if(!tru_copy_dma(dst, src, n)) return UINT64_MAX;
+				break;
+		}
+		t = alt_mono_now_ticks() - t;
+		if(t < best) best = t;
+	}
+	return best;
+}
+
+// The smallest measured size from which a is faster than b at every larger measured size
+static size_t tru_copy_crossover(const size_t *sizes, const uint64_t *a, const uint64_t *b, int num){
+	size_t result = SIZE_MAX;
+	int i;
+
+	for(i = num - 1; i >= 0 && a[i] < b[i]; i--){
+		result = sizes[i];
+	}
+	return result;
+}
+
+/*
+	Measure memcpy(), alt_mem_copy() and the DMA on sizes doubling from
+	ALT_MEM_NEON_MIN up to half of the work buffer, for each placement, and
+	set tru_copy_table[] to the crossovers.  Call after tru_copy_init() to
+	include the DMA.  The buffer contents are overwritten.
+*/
+void tru_copy_calibrate(void *buf, size_t size){
+	size_t sizes[TRU_COPY_CALIB_NUM];
+	uint64_t t_cpu[TRU_COPY_CALIB_NUM];
+	uint64_t t_neon[TRU_COPY_CALIB_NUM];
+	uint64_t t_dma[TRU_COPY_CALIB_NUM];
+	uint64_t t_best[TRU_COPY_CALIB_NUM];
+	uint8_t *src = (uint8_t *)(((uintptr_t)buf + TRU_COPY_LINE - 1) & ~(uintptr_t)(TRU_COPY_LINE - 1));
+	uint8_t *dst;
+	size_t half;
+	size_t n;
+	int place;
+	int num;
+	int i;
+
+	if(size < 4 * ALT_MEM_NEON_MIN + 2 * TRU_COPY_LINE) return;
+	half = (size - (src - (uint8_t *)buf) - TRU_COPY_LINE) / 2 & ~(size_t)(TRU_COPY_LINE - 1);
+	for(i = 0; i < (int)half; i++) src[i] = (uint8_t)i;
+
+	for(place = 0; place < TRU_COPY_PLACE_NUM; place++){
+		dst = src + half + ((place == TRU_COPY_PLACE_ALIGNED) ? 0 : 1);
+		num = 0;
+		for(n = ALT_MEM_NEON_MIN; n <= half && num < TRU_COPY_CALIB_NUM; n <<= 1){
+			sizes[num] = n;
+			t_cpu[num] = tru_copy_time(0, dst, src, n);
+			t_neon[num] = tru_copy_time(1, dst, src, n);
+			t_dma[num] = tru_copy_time(2, dst, src, n);
+
+			// The DMA competes against the CPU engine it would replace
+			t_best[num] = (t_neon[num] < t_cpu[num]) ? t_neon[num] : t_cpu[num];
+			num++;
+		}
+
+		tru_copy_table[place].neon_min = (place == TRU_COPY_PLACE_ALIGNED) ? tru_copy_crossover(sizes, t_neon, t_cpu, num) : SIZE_MAX;
+		tru_copy_table[place].dma_min = tru_copy_crossover(sizes, t_dma, t_best, num);
+	}
+}
@@ -0,0 +1,116 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Framed channel layer for a UART, see tru_frame.h.
+*/
+
+#include "tru_frame.h"
+#include "tru_crc.h"
+#include "c5_uart.h"
+
+static ALT_16550_HANDLE_t *tru_frame_handle;
+
+static void tru_frame_send(const uint8_t *buf, uint32_t len);
+
+// Attach the UART handle.  A lone delimiter ends any unframed output sent before, so the first frame decodes cleanly
+void tru_frame_init(ALT_16550_HANDLE_t *handle){
+	static const uint8_t delim = TRU_FRAME_DELIM;
+
+	tru_frame_handle = handle;
+	tru_frame_send(&delim, 1);
+}
+
+/*
+	Encode one frame into out, including the delimiter.  The frame body is
+	channel, data and CRC, at most 254 bytes, so it is a single COBS block:
+	every zero byte is replaced with the distance to the next zero and one
+	code byte at the start holds the distance to the first.
+*/
+uint32_t tru_frame_encode(uint8_t channel, const void *data, uint32_t len, uint8_t *out){
+	const uint8_t *src = data;
+	uint8_t *code = out;    // Code byte to fill in when the next zero or the end is reached
+	uint8_t *dst = out + 1;
+	uint8_t crc_le[2];
+	uint16_t crc;
+	uint32_t i;
+
+	crc = tru_crc16(TRU_CRC16_INIT, &channel, 1);
+	crc = tru_crc16(crc, src, len);
+	crc_le[0] = crc & 0xff;
+	crc_le[1] = crc >> 8;
+
+	#define TRU_FRAME_PUT(b) do{ \
+		if((b) == 0){ \
+			*code = dst - code; \
+			code = dst++; \
+		}else{ \
+			*dst++ = (b); \
+		} \
+	}while(0)
+
+	TRU_FRAME_PUT(channel);
+	for(i = 0; i < len; i++){
+		TRU_FRAME_PUT(src[i]);
+	}
+	TRU_FRAME_PUT(crc_le[0]);
+	TRU_FRAME_PUT(crc_le[1]);
+
+	#undef TRU_FRAME_PUT
+
+	*code = dst - code;
+	*dst++ = TRU_FRAME_DELIM;
+
+	return dst - out;
+}
+
+// Send encoded bytes through the attached HWLib handle, or straight to UART0 before one is attached
+static void tru_frame_send(const uint8_t *buf, uint32_t len){
+	ALT_16550_HANDLE_t *handle = tru_frame_handle;
+
+	if(handle == 0){
+		c5_uart_write_str(C5_UART0_BASE_ADDR, (const char *)buf, len);
+	}else if(handle->tx_ring){
+		alt_16550_tx_async_write(handle, (const char *)buf, len, true);
+	}else{
+		alt_16550_fifo_write_safe(handle, (const char *)buf, len, true);
+	}
+}
+
+/*
+	Send data on a channel, split into as many frames as needed.  Each frame
+	is encoded into a stack buffer and sent with a single driver call.
+*/
+void tru_frame_write(uint8_t channel, const void *data, uint32_t len){
+	uint8_t buf[TRU_FRAME_ENCODED_MAX];
+	const uint8_t *src = data;
+	uint32_t n;
+
+	do{
+		n = (len > TRU_FRAME_DATA_MAX) ? TRU_FRAME_DATA_MAX : len;
+		tru_frame_send(buf, tru_frame_encode(channel, src, n, buf));
+		src += n;
+		len -= n;
+	}while(len);
+}
@@ -0,0 +1,197 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Debug logger run time state and the deferred mode, see tru_logger.h.
+*/
+
+#include "tru_logger.h"
+#include <stdarg.h>
+
+volatile uint32_t tru_log_level = TRU_LOG_LEVEL;
+volatile uint32_t tru_log_mask = TRU_LOG_CATS;
+
+#if !defined(TRU_LOG_DEFERRED) && defined(TRU_LOG_RAMCON)
+	#include "tru_ramcon.h"
+
+	// Format into a line buffer and append it to the persistent RAM console
+	int tru_log_printf(const char *format, ...){
+		char buf[TRU_LOG_RAMCON_LINE];
+		va_list args;
+		int ret;
+
+		va_start(args, format);
+		ret = vsnprintf(buf, sizeof(buf), format, args);
+		va_end(args);
+
+		if(ret > 0) tru_ramcon_write(buf, (ret < (int)sizeof(buf)) ? ret : sizeof(buf) - 1);
+		return ret;
+	}
+#elif !defined(TRU_LOG_DEFERRED) && (defined(SEMIHOSTING) || defined(TRU_PRINTF_UART))
+	int tru_log_printf(const char *format, ...){
+		va_list args;
+		int ret;
+
+		va_start(args, format);
+		ret = vprintf(format, args);
+		va_end(args);
+
+		return ret;
+	}
+#endif
+
+#ifdef TRU_LOG_DEFERRED
+
+#include "c5_uart.h"
+#ifdef TRU_FRAME_UART
+	#include "tru_frame.h"
+#endif
+#ifdef TRU_LOG_RAMCON
+	#include "tru_ramcon.h"
+#endif
+
+#define TRU_LOG_RING_MASK (TRU_LOG_RING_WORDS - 1)
+
+static uint32_t tru_log_ring[TRU_LOG_RING_WORDS];
+static volatile uint32_t tru_log_head;   // Word index, written by the producers
+static volatile uint32_t tru_log_tail;   // Word index, written by the drain
+static uint32_t tru_log_tail_byte;        // Bytes of the word at the tail already sent
+static volatile uint32_t tru_log_dropped;
+static uint32_t tru_log_dropped_hdr[2];   // Drop report record being sent
+static uint32_t tru_log_dropped_len;      // Bytes of the drop report left to send
+
+#ifdef TRU_FRAME_UART
+	// One frame on the log channel per call, whole words only.  Blocks until the frame is handed to the driver
+	static uint32_t tru_log_send(const char *buf, uint32_t len){
+		if(len > (TRU_FRAME_DATA_MAX & ~3UL)) len = TRU_FRAME_DATA_MAX & ~3UL;
+		tru_frame_write(TRU_FRAME_CH_TRU_LOG, buf, len);
+		return len;
+	}
+#else
+	static uint32_t tru_log_send(const char *buf, uint32_t len){
+		return c5_uart_write_str_nb(TRU_LOG_UART_BASE_ADDR, buf, len);
+	}
+#endif
+
+/*
+	Hot path: copy the header and the argument words into the ring buffer.
+	When there is no room the record is dropped and counted, the drain then
+	reports the count.  Called through the DEBUG_PRINTF macro.
+*/
+#ifdef TRU_LOG_RAMCON
+// The record goes straight into the persistent RAM console instead, and the ring stays empty
+void tru_log_write(uint32_t hdr, ...){
+	uint32_t nargs = (hdr >> 24) & 0xf;
+	uint32_t rec[1 + TRU_LOG_ARGS_MAX];
+	uint32_t i;
+	va_list args;
+
+	rec[0] = hdr;
+	va_start(args, hdr);
+	for(i = 1; i <= nargs; i++){
+		rec[i] = va_arg(args, uint32_t);
+	}
+	va_end(args);
+
+	tru_ramcon_write((const char *)rec, 4 * (nargs + 1));
+}
+#else
+void tru_log_write(uint32_t hdr, ...){
+	uint32_t nargs = (hdr >> 24) & 0xf;
+	uint32_t cpsr;
+	uint32_t head;
+	va_list args;
+
+	cpsr = c5_irq_save();  // A log call from an interrupt handler must not interleave with one from the main code
+	head = tru_log_head;
+	if(TRU_LOG_RING_WORDS - (head - tru_log_tail) < nargs + 1){
+		tru_log_dropped++;
+		c5_irq_restore(cpsr);
+		return;
+	}
+
+	tru_log_ring[head++ & TRU_LOG_RING_MASK] = hdr;
+	va_start(args, hdr);
+	while(nargs--){
+		tru_log_ring[head++ & TRU_LOG_RING_MASK] = va_arg(args, uint32_t);
+	}
+	va_end(args);
+
+	__sync_synchronize();  // Publish the record after its contents
+	tru_log_head = head;
+	c5_irq_restore(cpsr);
+}
+#endif
+
+/*
+	Send as much of the pending records as fits in the UART transmit FIFO
+	without blocking.  With TRU_FRAME_UART it sends one frame per call
+	instead, which blocks until the frame is handed to the driver.  Call it from a low priority context, e.g. the idle
+	loop.  Returns the count of words still pending.
+*/
+uint32_t tru_log_drain(void){
+	uint32_t head = tru_log_head;
+	uint32_t tail = tru_log_tail;
+	uint32_t words;
+	uint32_t bytes;
+	uint32_t sent;
+	uint32_t cpsr;
+
+	// Report dropped records, once the records before the drop are out
+	if(tru_log_dropped_len == 0 && tru_log_tail_byte == 0 && tail == head && tru_log_dropped){
+		cpsr = c5_irq_save();
+		tru_log_dropped_hdr[0] = TRU_LOG_HDR(TRU_LOG_ID_DROPPED, 1);
+		tru_log_dropped_hdr[1] = tru_log_dropped;
+		tru_log_dropped = 0;
+		c5_irq_restore(cpsr);
+		tru_log_dropped_len = sizeof(tru_log_dropped_hdr);
+	}
+	if(tru_log_dropped_len){
+		tru_log_dropped_len -= tru_log_send((const char *)tru_log_dropped_hdr + sizeof(tru_log_dropped_hdr) - tru_log_dropped_len, tru_log_dropped_len);
+		return head - tail;
+	}
+
+	if(tail == head) return 0;
+
+	// Send the contiguous words up to the ring buffer end, the words are in little endian wire order already
+	words = head - tail;
+	if(words > TRU_LOG_RING_WORDS - (tail & TRU_LOG_RING_MASK)) words = TRU_LOG_RING_WORDS - (tail & TRU_LOG_RING_MASK);
+	bytes = words * 4 - tru_log_tail_byte;
+	sent = tru_log_send((const char *)&tru_log_ring[tail & TRU_LOG_RING_MASK] + tru_log_tail_byte, bytes);
+
+	sent += tru_log_tail_byte;
+	tru_log_tail_byte = sent & 3;
+	tail += sent >> 2;
+	tru_log_tail = tail;
+
+	return head - tail;
+}
+
+// Blocking wait until all pending records are sent
+void tru_log_flush(void){
+	while(tru_log_drain() || tru_log_tail_byte || tru_log_dropped || tru_log_dropped_len);
+	c5_uart_wait_empty(TRU_LOG_UART_BASE_ADDR);
+}
+
+#endif
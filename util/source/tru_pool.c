@@ -0,0 +1,275 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Fixed block pool allocator, see tru_pool.h.
+*/
+
+#include "tru_pool.h"
+#include "c5_util.h"
+#include <string.h>
+#ifdef TRU_POOL_MALLOC
+	#include <assert.h>
+	#include <errno.h>
+	#include <reent.h>
+#endif
+
+#define TRU_POOL_ROUND(size) (((size) + TRU_POOL_ALIGN - 1) & ~(TRU_POOL_ALIGN - 1))
+
+typedef struct tru_pool_block_s{
+	struct tru_pool_block_s *next;
+}tru_pool_block_t;
+
+typedef struct{
+	uint8_t *start;
+	uint8_t *end;
+	uint32_t block_size;
+	uint32_t block_count;
+	tru_pool_block_t *free;
+	uint32_t used;
+	uint32_t used_max;
+	uint32_t failed;
+}tru_pool_t;
+
+// Block storage of each class, in the .tru_pool section
+#define TRU_POOL_STORAGE(size, count) \
+	static uint8_t tru_pool_mem_##size[TRU_POOL_ROUND(size) * (count)] __attribute__((section(".tru_pool"), aligned(TRU_POOL_ALIGN)));
+TRU_POOL_CLASSES(TRU_POOL_STORAGE)
+
+#define TRU_POOL_DESC(size, count) \
+	{ tru_pool_mem_##size, tru_pool_mem_##size + sizeof(tru_pool_mem_##size), TRU_POOL_ROUND(size), (count), 0, 0, 0, 0 },
+static tru_pool_t tru_pool[] = {
+	TRU_POOL_CLASSES(TRU_POOL_DESC)
+};
+
+#define TRU_POOL_NUM (sizeof(tru_pool) / sizeof(tru_pool[0]))
+
+static uint8_t tru_pool_ready;
+
+// Link all blocks into the free lists.  Called on first use if not before, malloc() may be used before main()
+void tru_pool_init(void){
+	tru_pool_block_t *blk;
+	uint32_t i;
+	uint32_t n;
+
+	for(i = 0; i < TRU_POOL_NUM; i++){
+		tru_pool[i].free = 0;
+		for(n = tru_pool[i].block_count; n > 0; n--){
+			blk = (tru_pool_block_t *)(tru_pool[i].start + (n - 1) * tru_pool[i].block_size);
+			blk->next = tru_pool[i].free;
+			tru_pool[i].free = blk;
+		}
+		tru_pool[i].used = 0;
+		tru_pool[i].used_max = 0;
+		tru_pool[i].failed = 0;
+	}
+	tru_pool_ready = 1;
+}
+
+void *tru_pool_alloc(size_t size){
+	tru_pool_block_t *blk;
+	uint32_t first;
+	uint32_t cpsr;
+	uint32_t i;
+
+	if(!tru_pool_ready) tru_pool_init();
+
+	for(first = 0; first < TRU_POOL_NUM && size > tru_pool[first].block_size; first++);
+	if(first == TRU_POOL_NUM) return 0;
+
+	// Smallest class that fits, or the next larger one with a free block
+	cpsr = c5_irq_save();
+	for(i = first; i < TRU_POOL_NUM; i++){
+		blk = tru_pool[i].free;
+		if(blk){
+			tru_pool[i].free = blk->next;
+			if(++tru_pool[i].used > tru_pool[i].used_max) tru_pool[i].used_max = tru_pool[i].used;
+			c5_irq_restore(cpsr);
+			return blk;
+		}
+	}
+	tru_pool[first].failed++;
+	c5_irq_restore(cpsr);
+
+	return 0;
+}
+
+// The pool a block belongs to, or NULL if ptr is not the start of a block from the pools
+static tru_pool_t *tru_pool_find(const void *ptr){
+	const uint8_t *p = ptr;
+	uint32_t i;
+
+	for(i = 0; i < TRU_POOL_NUM; i++){
+		if(p >= tru_pool[i].start && p < tru_pool[i].end){
+			return ((uint32_t)(p - tru_pool[i].start) % tru_pool[i].block_size) ? 0 : &tru_pool[i];
+		}
+	}
+	return 0;
+}
+
+// Returns 0 on success or for NULL, -1 if ptr is not a block from the pools, which is then left alone
+int tru_pool_free(void *ptr){
+	tru_pool_t *pool;
+	tru_pool_block_t *blk = ptr;
+	uint32_t cpsr;
+
+	if(!ptr) return 0;
+	pool = tru_pool_find(ptr);
+	if(!pool) return -1;
+
+	cpsr = c5_irq_save();
+	blk->next = pool->free;
+	pool->free = blk;
+	pool->used--;
+	c5_irq_restore(cpsr);
+
+	return 0;
+}
+
+// Usable size of a block, 0 if it is not from the pools
+size_t tru_pool_block_size(const void *ptr){
+	tru_pool_t *pool = tru_pool_find(ptr);
+
+	return pool ? pool->block_size : 0;
+}
+
+uint32_t tru_pool_class_count(void){
+	return TRU_POOL_NUM;
+}
+
+// Returns 0 on success, -1 for an invalid class index
+int tru_pool_stats_get(uint32_t class_index, tru_pool_stats_t *stats){
+	uint32_t cpsr;
+
+	if(class_index >= TRU_POOL_NUM) return -1;
+
+	cpsr = c5_irq_save();
+	stats->block_size = tru_pool[class_index].block_size;
+	stats->block_count = tru_pool[class_index].block_count;
+	stats->used = tru_pool[class_index].used;
+	stats->used_max = tru_pool[class_index].used_max;
+	stats->failed = tru_pool[class_index].failed;
+	c5_irq_restore(cpsr);
+
+	return 0;
+}
+
+#ifdef TRU_POOL_MALLOC
+	// Replace the newlib allocator.  newlib calls the reentrant versions internally, e.g. for stdio buffers
+	void *_malloc_r(struct _reent *r, size_t size){
+		void *ptr = tru_pool_alloc(size ? size : 1);
+
+		if(!ptr) r->_errno = ENOMEM;
+		return ptr;
+	}
+
+	// A pointer which is not from malloc() is a bug in the caller
+	void _free_r(struct _reent *r, void *ptr){
+		int rc = tru_pool_free(ptr);
+
+		assert(rc == 0);
+		(void)rc;
+	}
+
+	void *_calloc_r(struct _reent *r, size_t n, size_t size){
+		void *ptr;
+
+		if(size && n > (size_t)-1 / size){
+			r->_errno = ENOMEM;
+			return 0;
+		}
+		ptr = _malloc_r(r, n * size);
+		if(ptr) memset(ptr, 0, n * size);
+		return ptr;
+	}
+
+	void *_realloc_r(struct _reent *r, void *ptr, size_t size){
+		size_t old_size;
+		void *new_ptr;
+
+		if(!ptr) return _malloc_r(r, size);
+		if(size == 0){
+			_free_r(r, ptr);
+			return 0;
+		}
+
+		// Stay in the same block while the new size fits
+		old_size = tru_pool_block_size(ptr);
+		assert(old_size != 0);
+		if(old_size == 0){
+			r->_errno = EINVAL;  // Not from malloc(), leave it alone
+			return 0;
+		}
+		if(size <= old_size) return ptr;
+
+		new_ptr = _malloc_r(r, size);
+		if(new_ptr){
+			memcpy(new_ptr, ptr, old_size);
+			_free_r(r, ptr);
+		}
+		return new_ptr;
+	}
+
+	// Blocks are TRU_POOL_ALIGN aligned, so smaller alignments are served as they are and larger ones fail
+	void *_memalign_r(struct _reent *r, size_t align, size_t size){
+		if(align & (align - 1)){
+			r->_errno = EINVAL;
+			return 0;
+		}
+		if(align > TRU_POOL_ALIGN){
+			r->_errno = ENOMEM;
+			return 0;
+		}
+		return _malloc_r(r, size);
+	}
+
+	size_t _malloc_usable_size_r(struct _reent *r, void *ptr){
+		(void)r;
+		return tru_pool_block_size(ptr);
+	}
+
+	void *malloc(size_t size){
+		return _malloc_r(_REENT, size);
+	}
+
+	void free(void *ptr){
+		_free_r(_REENT, ptr);
+	}
+
+	void *calloc(size_t n, size_t size){
+		return _calloc_r(_REENT, n, size);
+	}
+
+	void *realloc(void *ptr, size_t size){
+		return _realloc_r(_REENT, ptr, size);
+	}
+
+	void *memalign(size_t align, size_t size){
+		return _memalign_r(_REENT, align, size);
+	}
+
+	size_t malloc_usable_size(void *ptr){
+		return _malloc_usable_size_r(_REENT, ptr);
+	}
+#endif
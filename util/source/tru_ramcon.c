@@ -0,0 +1,186 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Persistent RAM console, see tru_ramcon.h.
+*/
+
+#include "tru_ramcon.h"
+#include "tru_crc.h"
+#include "c5_util.h"
+#include "c5_uart.h"
+#include <string.h>
+#ifdef TRU_FRAME_UART
+	#include "tru_frame.h"
+#endif
+
+#define TRU_RAMCON_MASK (TRU_RAMCON_SIZE - 1)
+
+// Header and ring together, so one memory dump holds both
+typedef struct{
+	tru_ramcon_hdr_t hdr;
+	char data[TRU_RAMCON_SIZE];
+}tru_ramcon_t;
+
+tru_ramcon_t tru_ramcon __attribute__((section(".noinit")));  // Not static, a JTAG dump looks it up by name
+
+static uint32_t tru_ramcon_ready;
+static uint32_t tru_ramcon_rd;        // Read position of tru_ramcon_read()
+static uint32_t tru_ramcon_rec_end;   // Write position at the reset, end of the recovered bytes
+static uint32_t tru_ramcon_rec_len;
+static uint32_t tru_ramcon_rec_seq;
+
+static uint32_t tru_ramcon_crc(const tru_ramcon_hdr_t *hdr){
+	return tru_crc16(TRU_CRC16_INIT, hdr, 3 * sizeof(uint32_t));
+}
+
+void tru_ramcon_init(void){
+	tru_ramcon_hdr_t *hdr = &tru_ramcon.hdr;
+	uint32_t cpsr;
+
+	cpsr = c5_irq_save();
+	if(tru_ramcon_ready){
+		c5_irq_restore(cpsr);
+		return;
+	}
+
+	if(hdr->magic == TRU_RAMCON_MAGIC && hdr->size == TRU_RAMCON_SIZE && hdr->crc == tru_ramcon_crc(hdr) && hdr->head_inv == ~hdr->head){
+		// Valid console from before the reset, keep its content
+		tru_ramcon_rec_end = hdr->head;
+		tru_ramcon_rec_len = (hdr->head < TRU_RAMCON_SIZE) ? hdr->head : TRU_RAMCON_SIZE;
+		tru_ramcon_rec_seq = hdr->seq;
+		hdr->seq++;
+	}else{
+		// Power on or corrupted, start empty
+		hdr->magic = TRU_RAMCON_MAGIC;
+		hdr->size = TRU_RAMCON_SIZE;
+		hdr->seq = 0;
+		hdr->head = 0;
+		hdr->head_inv = ~(uint32_t)0;
+		tru_ramcon_rec_len = 0;
+	}
+	hdr->crc = tru_ramcon_crc(hdr);
+	tru_ramcon_rd = hdr->head;
+	tru_ramcon_ready = 1;
+	c5_irq_restore(cpsr);
+}
+
+void tru_ramcon_write(const char *ptr, uint32_t len){
+	tru_ramcon_hdr_t *hdr = &tru_ramcon.hdr;
+	uint32_t head;
+	uint32_t off;
+	uint32_t first;
+	uint32_t cpsr;
+
+	if(!tru_ramcon_ready) tru_ramcon_init();
+
+	cpsr = c5_irq_save();
+	head = hdr->head;
+
+	// Only the newest TRU_RAMCON_SIZE bytes survive, skip the rest
+	if(len > TRU_RAMCON_SIZE){
+		head += len - TRU_RAMCON_SIZE;
+		ptr += len - TRU_RAMCON_SIZE;
+		len = TRU_RAMCON_SIZE;
+	}
+
+	// Up to the ring end, then the rest from the start
+	off = head & TRU_RAMCON_MASK;
+	first = TRU_RAMCON_SIZE - off;
+	if(first > len) first = len;
+	memcpy(&tru_ramcon.data[off], ptr, first);
+	memcpy(tru_ramcon.data, ptr + first, len - first);
+
+	// Data before the position, so a reset in between loses the new bytes and not the old ones
+	head += len;
+	__sync_synchronize();
+	hdr->head = head;
+	hdr->head_inv = ~head;
+	c5_irq_restore(cpsr);
+}
+
+uint32_t tru_ramcon_read(char *buf, uint32_t len){
+	uint32_t head;
+	uint32_t i;
+
+	if(!tru_ramcon_ready) tru_ramcon_init();
+
+	// Skip the bytes that were overwritten before they were read
+	head = tru_ramcon.hdr.head;
+	if(head - tru_ramcon_rd > TRU_RAMCON_SIZE) tru_ramcon_rd = head - TRU_RAMCON_SIZE;
+	for(i = 0; i < len && tru_ramcon_rd != head; i++){
+		buf[i] = tru_ramcon.data[tru_ramcon_rd++ & TRU_RAMCON_MASK];
+	}
+	return i;
+}
+
+// Start of the recovered bytes that have not been overwritten by this boot yet
+static uint32_t tru_ramcon_rec_start(void){
+	uint32_t start = tru_ramcon_rec_end - tru_ramcon_rec_len;
+	uint32_t head = tru_ramcon.hdr.head;
+
+	if(head - start > TRU_RAMCON_SIZE) start = head - TRU_RAMCON_SIZE;
+	return start;
+}
+
+uint32_t tru_ramcon_recovered(uint32_t *seq){
+	uint32_t start;
+
+	if(!tru_ramcon_ready) tru_ramcon_init();
+	if(seq) *seq = tru_ramcon_rec_seq;
+	if(tru_ramcon_rec_len == 0) return 0;
+
+	start = tru_ramcon_rec_start();
+	return ((int32_t)(tru_ramcon_rec_end - start) > 0) ? tru_ramcon_rec_end - start : 0;
+}
+
+static void tru_ramcon_send(const char *ptr, uint32_t len){
+	#ifdef TRU_FRAME_UART
+		tru_frame_write(TRU_FRAME_CH_TEXT, ptr, len);
+	#else
+		c5_uart_write_str(TRU_RAMCON_UART_BASE_ADDR, ptr, len);
+	#endif
+}
+
+void tru_ramcon_replay(void){
+	static const char begin[] = "\r\n--- ramcon: replay of the previous boot ---\r\n";
+	static const char end[] = "\r\n--- ramcon: end of replay ---\r\n";
+	uint32_t len = tru_ramcon_recovered(NULL);
+	uint32_t start;
+	uint32_t off;
+	uint32_t first;
+
+	if(len == 0) return;
+
+	start = tru_ramcon_rec_end - len;
+	off = start & TRU_RAMCON_MASK;
+	first = TRU_RAMCON_SIZE - off;
+	if(first > len) first = len;
+
+	tru_ramcon_send(begin, sizeof(begin) - 1);
+	tru_ramcon_send(&tru_ramcon.data[off], first);
+	tru_ramcon_send(tru_ramcon.data, len - first);
+	tru_ramcon_send(end, sizeof(end) - 1);
+	tru_ramcon_rec_len = 0;
+}
@@ -0,0 +1,173 @@
+/*
+	MIT License
+
+	Copyright (c) 2023 Truong Hy
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+	Version: 20261017
+
+	Batched semihosting output, see tru_semihost.h.
+*/
+
+#ifdef SEMIHOSTING
+
+#define _GNU_SOURCE  // fopencookie()
+#include "tru_semihost.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef HOST_SIM
+	#include <time.h>
+	#include <unistd.h>
+#endif
+
+static char sh_buf[TRU_SEMIHOST_BUF_SIZE];
+static uint32_t sh_len;     // Count of pending bytes in sh_buf
+static uint32_t sh_lines;   // Count of newlines in sh_buf
+static int sh_handle = -1;  // Host console handle
+static uint32_t sh_traps;
+
+int tru_semihost_call(int op, void *arg){
+	#if defined(__arm__)
+		register int r0 __asm("r0") = op;
+		register void *r1 __asm("r1") = arg;
+
+		// Same trap as the newlib rdimon library, the debugger catches the SVC
+		#ifdef __thumb__
+			__asm volatile("svc 0xab" : "+r" (r0) : "r" (r1) : "memory");
+		#else
+			__asm volatile("svc 0x123456" : "+r" (r0) : "r" (r1) : "memory");
+		#endif
+		return r0;
+	#elif defined(HOST_SIM)
+		// Host build: the calls used here, served by the host OS
+		uintptr_t *args = arg;
+		struct timespec ts;
+		uint64_t ns;
+
+		switch(op){
+			case TRU_SEMIHOST_SYS_OPEN:
+				return 1;
+			case TRU_SEMIHOST_SYS_WRITE:
+				return args[2] - write(args[0], (const char *)args[1], args[2]);
+			case TRU_SEMIHOST_SYS_CLOCK:
+				clock_gettime(CLOCK_MONOTONIC, &ts);
+				return ts.tv_sec * 100 + ts.tv_nsec / 10000000;
+			case TRU_SEMIHOST_SYS_ELAPSED:
+				clock_gettime(CLOCK_MONOTONIC, &ts);
+				ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+				args[0] = (uint32_t)ns;  // 64 bit tick count as two words
+				args[1] = (uint32_t)(ns >> 32);
+				return 0;
+			case TRU_SEMIHOST_SYS_TICKFREQ:
+				return 1000000000;
+			default:
+				return -1;
+		}
+	#else
+		return -1;
+	#endif
+}
+
+int tru_semihost_init(void){
+	static const char name[] = ":tt";  // The host console
+	uintptr_t args[3];  // Word sized fields
+
+	if(sh_handle >= 0) return 0;
+
+	args[0] = (uintptr_t)name;
+	args[1] = 4;  // Mode "w"
+	args[2] = sizeof(name) - 1;
+	sh_handle = tru_semihost_call(TRU_SEMIHOST_SYS_OPEN, args);
+	return (sh_handle >= 0) ? 0 : -1;
+}
+
+static void sh_send(const char *ptr, uint32_t len){
+	uintptr_t args[3];  // Word sized fields
+
+	if(len == 0 || tru_semihost_init()) return;
+
+	args[0] = sh_handle;
+	args[1] = (uintptr_t)ptr;
+	args[2] = len;
+	tru_semihost_call(TRU_SEMIHOST_SYS_WRITE, args);  // Returns the count of bytes not written, nothing useful to do about it
+	sh_traps++;
+}
+
+void tru_semihost_flush(void){
+	sh_send(sh_buf, sh_len);
+	sh_len = 0;
+	sh_lines = 0;
+}
+
+void tru_semihost_write(const char *ptr, uint32_t len){
+	const char *nl;
+	const char *end = ptr + len;
+
+	// Too big to buffer, send what is pending and then the whole lot in one trap
+	if(len > TRU_SEMIHOST_BUF_SIZE - sh_len){
+		tru_semihost_flush();
+		if(len >= TRU_SEMIHOST_BUF_SIZE){
+			sh_send(ptr, len);
+			return;
+		}
+	}
+
+	memcpy(&sh_buf[sh_len], ptr, len);
+	sh_len += len;
+
+	#if TRU_SEMIHOST_LINES
+		for(nl = memchr(ptr, '\n', len); nl; nl = memchr(nl + 1, '\n', end - nl - 1)){
+			sh_lines++;
+		}
+		if(sh_lines >= TRU_SEMIHOST_LINES){
+			tru_semihost_flush();
+			return;
+		}
+	#else
+		(void)nl;
+		(void)end;
+	#endif
+	if(sh_len == TRU_SEMIHOST_BUF_SIZE) tru_semihost_flush();
+}
+
+static ssize_t sh_stdout_write(void *cookie, const char *buf, size_t size){
+	tru_semihost_write(buf, size);
+	return size;
+}
+
+FILE *tru_semihost_stdout_attach(void){
+	static const cookie_io_functions_t io = { NULL, sh_stdout_write, NULL, NULL };
+	FILE *fp;
+
+	if(tru_semihost_init()) return NULL;
+	fp = fopencookie(NULL, "w", io);
+	if(fp == NULL) return NULL;
+
+	setvbuf(fp, NULL, _IONBF, 0);  // The sink does the buffering, newlib hands over each printf() as it is
+	atexit(tru_semihost_flush);
+	stdout = fp;
+	return fp;
+}
+
+uint32_t tru_semihost_trap_count(void){
+	return sh_traps;
+}
+
+#endif